@@ -0,0 +1,465 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/aabb_tree.h"
+
+namespace engine {
+
+// returns whether other is completely inside this
+bool AABB::Contains(const AABB &other) const {
+  return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+         max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+}
+
+// returns whether other touches this
+bool AABB::Overlaps(const AABB &other) const {
+  return min.x <= other.max.x && max.x >= other.min.x &&
+         min.y <= other.max.y && max.y >= other.min.y &&
+         min.z <= other.max.z && max.z >= other.min.z;
+}
+
+// returns the surface area of this
+float AABB::SurfaceArea() const {
+  glm::vec3 size = max - min;
+  return 2.0f * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x));
+}
+
+// returns this grown by margin on every side
+AABB AABB::Expanded(float margin) const {
+  glm::vec3 pad(margin, margin, margin);
+  return AABB(min - pad, max + pad);
+}
+
+// start is where a segment starts, direction is the unit direction of the
+// segment, and length is how long it is
+// returns the distance along the segment where it enters this, 0 if it
+// starts inside, or -1 if it misses
+float AABB::RayEntry(glm::vec3 start, glm::vec3 direction,
+                     float length) const {
+  float entry = 0;
+  float leave = length;
+  for (int i = 0; i < 3; i++) {
+    if (direction[i] == 0) {
+      // parallel to this slab so it has to start between its planes
+      if (start[i] < min[i] || start[i] > max[i]) {
+        return -1;
+      }
+    } else {
+      float inverse = 1.0f / direction[i];
+      float t1 = (min[i] - start[i]) * inverse;
+      float t2 = (max[i] - start[i]) * inverse;
+      entry = std::max(entry, std::min(t1, t2));
+      leave = std::min(leave, std::max(t1, t2));
+      if (entry > leave) {
+        return -1;
+      }
+    }
+  }
+  return entry;
+}
+
+// returns the smallest box containing a and b
+AABB AABB::Union(const AABB &a, const AABB &b) {
+  return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+// Default Constructor
+AABBTree::AABBTree() {
+  root = AABB_TREE_NULL;
+  free_list = AABB_TREE_NULL;
+}
+
+// returns the index of an unused node
+int AABBTree::AllocateNode() {
+  int index;
+  if (free_list != AABB_TREE_NULL) {
+    index = free_list;
+    free_list = nodes[index].parent;
+  } else {
+    index = nodes.size();
+    nodes.push_back(Node());
+  }
+  Node &node = nodes[index];
+  node.parent = node.left = node.right = AABB_TREE_NULL;
+  node.height = 0;
+  node.id = -1;
+  return index;
+}
+
+// index is a node
+// puts the node back on the free list
+void AABBTree::FreeNode(int index) {
+  nodes[index].parent = free_list;
+  nodes[index].height = -1;
+  free_list = index;
+}
+
+// leaf is a node that isn't in the tree
+// adds leaf to the tree next to the sibling that grows the tree least
+void AABBTree::InsertLeaf(int leaf) {
+  if (root == AABB_TREE_NULL) {
+    root = leaf;
+    nodes[root].parent = AABB_TREE_NULL;
+    return;
+  }
+
+  // Walk down choosing the child that costs the least surface area
+  AABB box = nodes[leaf].box;
+  int index = root;
+  while (!nodes[index].IsLeaf()) {
+    int left = nodes[index].left;
+    int right = nodes[index].right;
+    float area = nodes[index].box.SurfaceArea();
+    float combined_area = AABB::Union(nodes[index].box, box).SurfaceArea();
+
+    // cost of making a new parent for this node and the leaf
+    float cost = 2.0f * combined_area;
+    // cost every ancestor pays for growing to fit the leaf
+    float inherited = 2.0f * (combined_area - area);
+
+    float left_cost = AABB::Union(box, nodes[left].box).SurfaceArea() +
+                      inherited;
+    if (!nodes[left].IsLeaf()) {
+      left_cost -= nodes[left].box.SurfaceArea();
+    }
+    float right_cost = AABB::Union(box, nodes[right].box).SurfaceArea() +
+                       inherited;
+    if (!nodes[right].IsLeaf()) {
+      right_cost -= nodes[right].box.SurfaceArea();
+    }
+
+    if (cost < left_cost && cost < right_cost) {
+      break;
+    }
+    index = (left_cost < right_cost) ? left : right;
+  }
+
+  // Make a new parent for the sibling and the leaf
+  int sibling = index;
+  int old_parent = nodes[sibling].parent;
+  int new_parent = AllocateNode();
+  nodes[new_parent].parent = old_parent;
+  nodes[new_parent].box = AABB::Union(box, nodes[sibling].box);
+  nodes[new_parent].height = nodes[sibling].height + 1;
+  nodes[new_parent].left = sibling;
+  nodes[new_parent].right = leaf;
+  nodes[sibling].parent = new_parent;
+  nodes[leaf].parent = new_parent;
+  if (old_parent == AABB_TREE_NULL) {
+    root = new_parent;
+  } else if (nodes[old_parent].left == sibling) {
+    nodes[old_parent].left = new_parent;
+  } else {
+    nodes[old_parent].right = new_parent;
+  }
+
+  Refit(nodes[leaf].parent);
+}
+
+// leaf is a node in the tree
+// takes leaf out of the tree
+void AABBTree::RemoveLeaf(int leaf) {
+  if (leaf == root) {
+    root = AABB_TREE_NULL;
+    return;
+  }
+
+  // The sibling takes the parent's place
+  int parent = nodes[leaf].parent;
+  int grandparent = nodes[parent].parent;
+  int sibling = (nodes[parent].left == leaf) ? nodes[parent].right
+                                             : nodes[parent].left;
+  FreeNode(parent);
+  nodes[sibling].parent = grandparent;
+  if (grandparent == AABB_TREE_NULL) {
+    root = sibling;
+  } else {
+    if (nodes[grandparent].left == parent) {
+      nodes[grandparent].left = sibling;
+    } else {
+      nodes[grandparent].right = sibling;
+    }
+    Refit(grandparent);
+  }
+}
+
+// index is a node
+// walks from index to the root refitting boxes and balancing
+void AABBTree::Refit(int index) {
+  while (index != AABB_TREE_NULL) {
+    index = Balance(index);
+    Node &node = nodes[index];
+    node.height = 1 + std::max(nodes[node.left].height,
+                               nodes[node.right].height);
+    node.box = AABB::Union(nodes[node.left].box, nodes[node.right].box);
+    index = node.parent;
+  }
+}
+
+// index is a branch
+// rotates the taller grandchild up if the children's heights differ by
+// more than one and returns the node now at index's place in the tree
+int AABBTree::Balance(int index) {
+  int a = index;
+  if (nodes[a].IsLeaf() || nodes[a].height < 2) {
+    return a;
+  }
+  int b = nodes[a].left;
+  int c = nodes[a].right;
+  int balance = nodes[c].height - nodes[b].height;
+
+  if (balance > 1) {
+    // Rotate c up
+    int f = nodes[c].left;
+    int g = nodes[c].right;
+    nodes[c].left = a;
+    nodes[c].parent = nodes[a].parent;
+    nodes[a].parent = c;
+    if (nodes[c].parent == AABB_TREE_NULL) {
+      root = c;
+    } else if (nodes[nodes[c].parent].left == a) {
+      nodes[nodes[c].parent].left = c;
+    } else {
+      nodes[nodes[c].parent].right = c;
+    }
+    // the taller of c's children stays under c
+    if (nodes[f].height > nodes[g].height) {
+      nodes[c].right = f;
+      nodes[a].right = g;
+      nodes[g].parent = a;
+    } else {
+      nodes[c].right = g;
+      nodes[a].right = f;
+      nodes[f].parent = a;
+    }
+    int moved = nodes[a].right;
+    int kept = nodes[c].right;
+    nodes[a].box = AABB::Union(nodes[b].box, nodes[moved].box);
+    nodes[a].height = 1 + std::max(nodes[b].height, nodes[moved].height);
+    nodes[c].box = AABB::Union(nodes[a].box, nodes[kept].box);
+    nodes[c].height = 1 + std::max(nodes[a].height, nodes[kept].height);
+    return c;
+  }
+
+  if (balance < -1) {
+    // Rotate b up
+    int d = nodes[b].left;
+    int e = nodes[b].right;
+    nodes[b].left = a;
+    nodes[b].parent = nodes[a].parent;
+    nodes[a].parent = b;
+    if (nodes[b].parent == AABB_TREE_NULL) {
+      root = b;
+    } else if (nodes[nodes[b].parent].left == a) {
+      nodes[nodes[b].parent].left = b;
+    } else {
+      nodes[nodes[b].parent].right = b;
+    }
+    // the taller of b's children stays under b
+    if (nodes[d].height > nodes[e].height) {
+      nodes[b].right = d;
+      nodes[a].left = e;
+      nodes[e].parent = a;
+    } else {
+      nodes[b].right = e;
+      nodes[a].left = d;
+      nodes[d].parent = a;
+    }
+    int moved = nodes[a].left;
+    int kept = nodes[b].right;
+    nodes[a].box = AABB::Union(nodes[c].box, nodes[moved].box);
+    nodes[a].height = 1 + std::max(nodes[c].height, nodes[moved].height);
+    nodes[b].box = AABB::Union(nodes[a].box, nodes[kept].box);
+    nodes[b].height = 1 + std::max(nodes[a].height, nodes[kept].height);
+    return b;
+  }
+
+  return a;
+}
+
+// id is an object id and box is its bounds
+// adds id to the tree
+void AABBTree::Insert(int id, const AABB &box) {
+  if (Update(id, box)) {
+    return;
+  }
+  int leaf = AllocateNode();
+  nodes[leaf].box = box.Expanded(AABB_TREE_MARGIN);
+  nodes[leaf].id = id;
+  leaves[id] = leaf;
+  InsertLeaf(leaf);
+}
+
+// id is an object id and box is its new bounds
+// moves id in the tree if box has left its padded bounds and returns false
+// if id isn't in the tree
+bool AABBTree::Update(int id, const AABB &box) {
+  auto found = leaves.find(id);
+  if (found == leaves.end()) {
+    return false;
+  }
+  int leaf = found->second;
+  if (!nodes[leaf].box.Contains(box)) {
+    RemoveLeaf(leaf);
+    nodes[leaf].box = box.Expanded(AABB_TREE_MARGIN);
+    InsertLeaf(leaf);
+  }
+  return true;
+}
+
+// id is an object id
+// takes id out of the tree
+void AABBTree::Remove(int id) {
+  auto found = leaves.find(id);
+  if (found != leaves.end()) {
+    RemoveLeaf(found->second);
+    FreeNode(found->second);
+    leaves.erase(found);
+  }
+}
+
+// returns whether id is in the tree
+bool AABBTree::Contains(int id) const {
+  return leaves.find(id) != leaves.end();
+}
+
+// box is a region and ids is where to put the results
+// fills ids with every object whose padded bounds overlap box
+void AABBTree::Query(const AABB &box, std::vector<int>* ids) const {
+  ids->clear();
+  if (root == AABB_TREE_NULL) {
+    return;
+  }
+  std::vector<int> stack(1, root);
+  while (!stack.empty()) {
+    const Node &node = nodes[stack.back()];
+    stack.pop_back();
+    if (node.box.Overlaps(box)) {
+      if (node.IsLeaf()) {
+        ids->push_back(node.id);
+      } else {
+        stack.push_back(node.left);
+        stack.push_back(node.right);
+      }
+    }
+  }
+}
+
+// start and end define a line segment and test returns the distance from
+// start an object first hits the segment or -1 if it doesn't
+// visits nearer boxes first and skips any box farther than the closest hit
+// so far, returns the closest hit distance or -1 if nothing was hit
+float AABBTree::RayCast(glm::vec3 start, glm::vec3 end,
+                        const std::function<float(int)> &test) const {
+  float rv = -1;
+  float length = glm::length(end - start);
+  if (root == AABB_TREE_NULL || length == 0) {
+    return rv;
+  }
+  glm::vec3 direction = (end - start) / length;
+
+  // each entry is a node and the distance the segment enters it
+  std::vector<std::pair<int, float>> stack;
+  float entry = nodes[root].box.RayEntry(start, direction, length);
+  if (entry != -1) {
+    stack.push_back({root, entry});
+  }
+  while (!stack.empty()) {
+    int index = stack.back().first;
+    entry = stack.back().second;
+    stack.pop_back();
+    if (rv != -1 && entry > rv) {
+      continue;
+    }
+    const Node &node = nodes[index];
+    if (node.IsLeaf()) {
+      float hit = test(node.id);
+      if (hit != -1 && (rv == -1 || hit < rv)) {
+        rv = hit;
+      }
+    } else {
+      float left = nodes[node.left].box.RayEntry(start, direction, length);
+      float right = nodes[node.right].box.RayEntry(start, direction, length);
+      // push the farther child first so the nearer one is visited first
+      if (left != -1 && right != -1 && left < right) {
+        stack.push_back({node.right, right});
+        stack.push_back({node.left, left});
+      } else {
+        if (left != -1) {
+          stack.push_back({node.left, left});
+        }
+        if (right != -1) {
+          stack.push_back({node.right, right});
+        }
+      }
+    }
+  }
+  return rv;
+}
+
+// start and end define a line segment and test is given up to
+// RAYCAST_BATCH_SIZE ids at a time and returns whether any of them hit the
+// segment
+// returns whether anything hit the segment, stopping at the first batch
+// with a hit since which object is closest doesn't matter
+bool AABBTree::RayAny(glm::vec3 start, glm::vec3 end,
+                      const std::function<bool(const int*, int)> &test) const {
+  float length = glm::length(end - start);
+  if (root == AABB_TREE_NULL || length == 0) {
+    return false;
+  }
+  glm::vec3 direction = (end - start) / length;
+
+  // nearer boxes are still visited first since they are the most likely
+  // to be in the way
+  int pending[RAYCAST_BATCH_SIZE];
+  int num_pending = 0;
+  std::vector<int> stack;
+  if (nodes[root].box.RayEntry(start, direction, length) != -1) {
+    stack.push_back(root);
+  }
+  while (!stack.empty()) {
+    const Node &node = nodes[stack.back()];
+    stack.pop_back();
+    if (node.IsLeaf()) {
+      pending[num_pending++] = node.id;
+      if (num_pending == RAYCAST_BATCH_SIZE) {
+        if (test(pending, num_pending)) {
+          return true;
+        }
+        num_pending = 0;
+      }
+    } else {
+      float left = nodes[node.left].box.RayEntry(start, direction, length);
+      float right = nodes[node.right].box.RayEntry(start, direction, length);
+      if (left != -1 && right != -1 && left < right) {
+        stack.push_back(node.right);
+        stack.push_back(node.left);
+      } else {
+        if (left != -1) {
+          stack.push_back(node.left);
+        }
+        if (right != -1) {
+          stack.push_back(node.right);
+        }
+      }
+    }
+  }
+  return num_pending > 0 && test(pending, num_pending);
+}
+
+// returns the height of the tree
+int AABBTree::GetHeight() const {
+  return (root == AABB_TREE_NULL) ? 0 : nodes[root].height;
+}
+
+// empties the tree
+void AABBTree::Clear() {
+  nodes.clear();
+  leaves.clear();
+  root = AABB_TREE_NULL;
+  free_list = AABB_TREE_NULL;
+}
+
+}  // namespace engine
@@ -0,0 +1,152 @@
+#ifndef SRC_ENGINE_AABB_TREE_H_
+#define SRC_ENGINE_AABB_TREE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// lib
+#include "glm/glm.hpp"
+#include "glm/vec3.hpp"
+
+// src
+#include "engine/constants.h"
+
+namespace engine {
+
+// AABB is an axis aligned box in world space
+struct AABB {
+  glm::vec3 min;
+  glm::vec3 max;
+
+  // Default Constructor
+  AABB() : min(0, 0, 0), max(0, 0, 0) {}
+
+  // Constructor
+  AABB(glm::vec3 min, glm::vec3 max) : min(min), max(max) {}
+
+  // returns whether other is completely inside this
+  bool Contains(const AABB &other) const;
+
+  // returns whether other touches this
+  bool Overlaps(const AABB &other) const;
+
+  // returns the surface area of this
+  float SurfaceArea() const;
+
+  // returns this grown by margin on every side
+  AABB Expanded(float margin) const;
+
+  // start is where a segment starts, direction is the unit direction of the
+  // segment, and length is how long it is
+  // returns the distance along the segment where it enters this, 0 if it
+  // starts inside, or -1 if it misses
+  float RayEntry(glm::vec3 start, glm::vec3 direction, float length) const;
+
+  // returns the smallest box containing a and b
+  static AABB Union(const AABB &a, const AABB &b);
+};
+
+// AABBTree is a dynamic bounding volume hierarchy of object ids. Each leaf
+// stores a box a little larger than its object so small movements don't
+// change the tree, and the tree is kept balanced with rotations as leaves are
+// added and removed so queries stay logarithmic.
+class AABBTree {
+ private:
+  // Node is either a leaf holding an object id or a branch with two children
+  struct Node {
+    AABB box;
+    int parent;
+    int left;
+    int right;
+    int height;
+    int id;
+
+    bool IsLeaf() const {return left == AABB_TREE_NULL;}
+  };
+
+  std::vector<Node> nodes;
+  int root;
+  int free_list;
+  std::unordered_map<int, int> leaves;
+
+  // returns the index of an unused node
+  int AllocateNode();
+
+  // index is a node
+  // puts the node back on the free list
+  void FreeNode(int index);
+
+  // leaf is a node that isn't in the tree
+  // adds leaf to the tree next to the sibling that grows the tree least
+  void InsertLeaf(int leaf);
+
+  // leaf is a node in the tree
+  // takes leaf out of the tree
+  void RemoveLeaf(int leaf);
+
+  // index is a node
+  // walks from index to the root refitting boxes and balancing
+  void Refit(int index);
+
+  // index is a branch
+  // rotates the taller grandchild up if the children's heights differ by
+  // more than one and returns the node now at index's place in the tree
+  int Balance(int index);
+
+ public:
+  // Default Constructor
+  AABBTree();
+
+  // id is an object id and box is its bounds
+  // adds id to the tree
+  void Insert(int id, const AABB &box);
+
+  // id is an object id and box is its new bounds
+  // moves id in the tree if box has left its padded bounds and returns false
+  // if id isn't in the tree
+  bool Update(int id, const AABB &box);
+
+  // id is an object id
+  // takes id out of the tree
+  void Remove(int id);
+
+  // returns whether id is in the tree
+  bool Contains(int id) const;
+
+  // box is a region and ids is where to put the results
+  // fills ids with every object whose padded bounds overlap box
+  void Query(const AABB &box, std::vector<int>* ids) const;
+
+  // start and end define a line segment and test returns the distance from
+  // start an object first hits the segment or -1 if it doesn't
+  // visits nearer boxes first and skips any box farther than the closest hit
+  // so far, returns the closest hit distance or -1 if nothing was hit
+  float RayCast(glm::vec3 start, glm::vec3 end,
+                const std::function<float(int)> &test) const;
+
+  // start and end define a line segment and test is given up to
+  // RAYCAST_BATCH_SIZE ids at a time and returns whether any of them hit the
+  // segment
+  // returns whether anything hit the segment, stopping at the first batch
+  // with a hit since which object is closest doesn't matter
+  bool RayAny(glm::vec3 start, glm::vec3 end,
+              const std::function<bool(const int*, int)> &test) const;
+
+  // returns the height of the tree
+  int GetHeight() const;
+
+  // empties the tree
+  void Clear();
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_AABB_TREE_H_
@@ -17,14 +17,23 @@ AnimationController::AnimationController() {
 
 // delta is the amount of time since last frame in seconds
 // updates position, scale, and orientation to match the current animation
-void AnimationController::Update(float delta) {
-  if (animations.find(current_animation) != animations.end()) {
-    Animation* anim = animations[current_animation];
-    position = anim->GetPosition();
-    scale = anim->GetScale();
-    orientation = anim->GetOrientation();
+// and returns whether any of them changed
+bool AnimationController::Update(float delta) {
+  bool changed = false;
+  auto found = animations.find(current_animation);
+  if (found != animations.end()) {
+    Animation* anim = found->second;
+    glm::vec3 new_position = anim->GetPosition();
+    glm::vec3 new_scale = anim->GetScale();
+    glm::quat new_orientation = anim->GetOrientation();
+    changed = new_position != position || new_scale != scale ||
+              new_orientation != orientation;
+    position = new_position;
+    scale = new_scale;
+    orientation = new_orientation;
     anim->NextFrame(delta);
   }
+  return changed;
 }
 
 // animation is a pointer to a declared animation
@@ -34,7 +34,8 @@ class AnimationController {
 
   // delta is the amount of time since last frame in seconds
   // updates position, scale, and orientation to match the current animation
-  void Update(float delta);
+  // and returns whether any of them changed
+  bool Update(float delta);
 
   // animation is a pointer to a declared animation
   // adds animation to animations at name
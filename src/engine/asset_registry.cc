@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/asset_registry.h"
+
+#include <climits>
+#include <cstdlib>
+
+namespace engine {
+
+// assets is a map of weak handles and key is a canonical path
+// returns the asset at key if it is still alive and null otherwise
+template <typename T>
+std::shared_ptr<const T> FindAsset(
+    std::map<std::string, std::weak_ptr<const T>>* assets,
+    const std::string &key) {
+  auto found = assets->find(key);
+  if (found == assets->end()) {
+    return std::shared_ptr<const T>();
+  }
+  return found->second.lock();
+}
+
+// assets is a map of weak handles
+// erases every handle whose asset has been freed
+template <typename T>
+void PruneAssets(std::map<std::string, std::weak_ptr<const T>>* assets) {
+  for (auto it = assets->begin(); it != assets->end();) {
+    if (it->second.expired()) {
+      it = assets->erase(it);
+    } else {
+      it++;
+    }
+  }
+}
+
+// assets is a map of weak handles
+// returns how many of the assets are still alive
+template <typename T>
+int CountAssets(const std::map<std::string, std::weak_ptr<const T>> &assets) {
+  int count = 0;
+  for (auto const& asset : assets) {
+    if (!asset.second.expired()) {
+      count++;
+    }
+  }
+  return count;
+}
+
+// file_name is the path to an .obj file
+// returns a handle to the model loaded from file_name
+ModelHandle AssetRegistry::GetModel(const std::string &file_name) {
+  std::string key = CanonicalPath(file_name);
+  ModelHandle model = FindAsset(&models, key);
+  if (!model) {
+    model = ModelHandle(new Model(file_name, this));
+    models[key] = model;
+  }
+  return model;
+}
+
+// file_name is the path to a .mtl file
+// returns a handle to the materials described in file_name
+MaterialLibraryHandle AssetRegistry::GetMaterialLibrary(
+    const std::string &file_name) {
+  std::string key = CanonicalPath(file_name);
+  MaterialLibraryHandle library = FindAsset(&libraries, key);
+  if (!library) {
+    MaterialLibrary* loaded = new MaterialLibrary();
+    library = MaterialLibraryHandle(loaded);
+    LoadMaterialLibrary(file_name, loaded, this);
+    libraries[key] = library;
+  }
+  return library;
+}
+
+// file_name is the path to a .ppm or .pam file
+// returns a handle to the texture loaded from file_name
+TextureHandle AssetRegistry::GetTexture(const std::string &file_name) {
+  std::string key = CanonicalPath(file_name);
+  TextureHandle texture = FindAsset(&textures, key);
+  if (!texture) {
+    texture = TextureHandle(new Texture(file_name));
+    textures[key] = texture;
+  }
+  return texture;
+}
+
+// forgets every asset that is no longer in use
+void AssetRegistry::Prune() {
+  PruneAssets(&models);
+  PruneAssets(&libraries);
+  PruneAssets(&textures);
+}
+
+// returns the number of assets that are still in use
+int AssetRegistry::GetNumLoaded() const {
+  return CountAssets(models) + CountAssets(libraries) + CountAssets(textures);
+}
+
+// file_name is a path to a file
+// returns the absolute path of file_name with links and dots resolved so the
+// same file always gives the same key, or file_name if it doesn't exist
+std::string CanonicalPath(const std::string &file_name) {
+#ifdef _WIN32
+  char* resolved = _fullpath(nullptr, file_name.c_str(), 0);
+#else
+  char* resolved = realpath(file_name.c_str(), nullptr);
+#endif
+  if (resolved == nullptr) {
+    return file_name;
+  }
+  std::string path(resolved);
+  free(resolved);
+  return path;
+}
+
+}  // namespace engine
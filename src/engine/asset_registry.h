@@ -0,0 +1,70 @@
+#ifndef SRC_ENGINE_ASSET_REGISTRY_H_
+#define SRC_ENGINE_ASSET_REGISTRY_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <map>
+#include <memory>
+#include <string>
+
+// src
+#include "engine/material.h"
+#include "engine/model.h"
+#include "engine/texture.h"
+
+namespace engine {
+
+// MaterialLibraryHandle keeps a shared material library alive
+typedef std::shared_ptr<const MaterialLibrary> MaterialLibraryHandle;
+
+// AssetRegistry hands out shared handles to models, material libraries, and
+// textures so each file is only loaded once no matter how many objects use it.
+// The registry doesn't keep assets alive itself, an asset is freed as soon as
+// the last handle to it is released and is loaded again if it's asked for
+// after that.
+class AssetRegistry {
+ private:
+  std::map<std::string, std::weak_ptr<const Model>> models;
+  std::map<std::string, std::weak_ptr<const MaterialLibrary>> libraries;
+  std::map<std::string, std::weak_ptr<const Texture>> textures;
+
+ public:
+  // Default Constructor
+  AssetRegistry() {}
+
+  // file_name is the path to an .obj file
+  // returns a handle to the model loaded from file_name
+  ModelHandle GetModel(const std::string &file_name);
+
+  // file_name is the path to a .mtl file
+  // returns a handle to the materials described in file_name
+  MaterialLibraryHandle GetMaterialLibrary(const std::string &file_name);
+
+  // file_name is the path to a .ppm or .pam file
+  // returns a handle to the texture loaded from file_name
+  TextureHandle GetTexture(const std::string &file_name);
+
+  // forgets every asset that is no longer in use
+  void Prune();
+
+  // returns the number of assets that are still in use
+  int GetNumLoaded() const;
+
+  // delete the copy constructor
+  AssetRegistry(const AssetRegistry& registry) = delete;
+
+  // delete the assignment operator
+  AssetRegistry& operator=(const AssetRegistry& registry) = delete;
+};
+
+// file_name is a path to a file
+// returns the absolute path of file_name with links and dots resolved so the
+// same file always gives the same key, or file_name if it doesn't exist
+std::string CanonicalPath(const std::string &file_name);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_ASSET_REGISTRY_H_
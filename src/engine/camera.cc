@@ -45,6 +45,8 @@ void Camera::MultProjectionMatrix(int width, int height) const {
 // multiplies the camera’s current view matrix, calculated usings it’s
 // current position and orientation, with the current matrix.
 void Camera::MultViewMatrix() const {
+  glm::vec3 position = GetPosition();
+  glm::quat orientation = GetOrientation();
   glm::vec3 axis = glm::axis(orientation);
   glm::mat4 rot_mat = glm::toMat4(glm::inverse(orientation));
   axis = glm::axis(glm::inverse(orientation));
@@ -52,6 +54,18 @@ void Camera::MultViewMatrix() const {
   glTranslatef(-position.x, -position.y, -position.z);
 }
 
+// ratio is the window's width over its height
+// returns the planes around what the camera sees in world space, worked
+// out from its field of view, z_near, z_far, position, and orientation
+Frustum Camera::GetFrustum(float ratio) const {
+  float frust_size = tanf(deg2rad(fov/2.0f)) * z_near;
+  glm::mat4 projection = glm::frustum(-ratio*frust_size, ratio*frust_size,
+                                      -frust_size, frust_size, z_near, z_far);
+  glm::mat4 view = glm::translate(glm::toMat4(glm::inverse(GetOrientation())),
+                                  -GetPosition());
+  return MakeFrustum(projection * view);
+}
+
 // delta is the fraction of a second a frame takes
 void Camera::Update(float delta) {
   // Nothing to do for now
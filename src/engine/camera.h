@@ -9,10 +9,12 @@
 
 #include "glm/gtx/quaternion.hpp"
 #include "glm/gtc/type_ptr.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 #include "glm/vec3.hpp"
 #include "engine/game_object.h"
 #include "engine/constants.h"
 #include "engine/helper.h"
+#include "engine/frustum.h"
 
 namespace engine {
 
@@ -45,6 +47,11 @@ class Camera : public GameObject {
   // current position and orientation, with the current matrix.
   void MultViewMatrix() const;
 
+  // ratio is the window's width over its height
+  // returns the planes around what the camera sees in world space, worked
+  // out from its field of view, z_near, z_far, position, and orientation
+  Frustum GetFrustum(float ratio) const;
+
   // delta is the fraction of a second a frame takes
   // creates the frustum for display
   // sets the matrix mode to GL_PROJECTION
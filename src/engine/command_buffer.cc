@@ -0,0 +1,49 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/command_buffer.h"
+#include "engine/projectile_system.h"
+
+namespace engine {
+
+// the command buffer each thread is recording into
+static thread_local CommandBuffer* recording = nullptr;
+
+// runs every command in the order they were pushed and empties this,
+// commands pushed while it runs are run too
+void CommandBuffer::Execute() {
+  // walked by index because a command can push more, each spawn runs just
+  // before the first command pushed after it
+  int next_spawn = 0;
+  for (int i = 0; ; i++) {
+    for (; next_spawn < spawns.size() && spawns[next_spawn].commands <= i;
+         next_spawn++) {
+      const ProjectileSpawn &spawn = spawns[next_spawn];
+      spawn.system->Spawn(spawn.type, spawn.position, spawn.orientation,
+                          spawn.velocity);
+    }
+    if (i >= commands.size()) {
+      break;
+    }
+    std::function<void()> command = std::move(commands[i]);
+    command();
+  }
+  commands.clear();
+  spawns.clear();
+}
+
+// returns the command buffer the calling thread is recording into or
+// nullptr if changes to shared state can be made right away
+CommandBuffer* RecordingCommands() {
+  return recording;
+}
+
+// buffer is a command buffer or nullptr
+// makes the calling thread record changes to shared state into buffer until
+// it is called again with nullptr
+void SetRecordingCommands(CommandBuffer* buffer) {
+  recording = buffer;
+}
+
+}  // namespace engine
@@ -0,0 +1,81 @@
+#ifndef SRC_ENGINE_COMMAND_BUFFER_H_
+#define SRC_ENGINE_COMMAND_BUFFER_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <functional>
+#include <vector>
+// lib
+#include "glm/vec3.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+namespace engine {
+
+class ProjectileSystem;
+
+// ProjectileSpawn is a projectile an update asked for. Shots are fired every
+// step, so they are kept as plain records instead of commands, which would
+// allocate for every one.
+struct ProjectileSpawn {
+  ProjectileSystem* system;
+  int type;
+  glm::vec3 position;
+  glm::quat orientation;
+  glm::vec3 velocity;
+  // commands is how many commands were pushed before it, so it runs in
+  // order with them
+  int commands;
+};
+
+// CommandBuffer holds the changes to shared state, like spawning, removing,
+// or moving things in the broadphase, that code running on a job thread
+// asked for. They are made later on one thread in the order they were asked
+// for.
+class CommandBuffer {
+ private:
+  std::vector<std::function<void()>> commands;
+  std::vector<ProjectileSpawn> spawns;
+
+ public:
+  // command is a change to shared state
+  // adds command to the end of this
+  void Push(std::function<void()> command) {
+    commands.push_back(std::move(command));
+  }
+
+  // spawn is a projectile to add
+  // adds spawn to the end of this, its commands is filled in here
+  void PushSpawn(ProjectileSpawn spawn) {
+    spawn.commands = commands.size();
+    spawns.push_back(spawn);
+  }
+
+  // returns whether this has no commands
+  bool Empty() const {return commands.empty() && spawns.empty();}
+
+  // throws away every command without running it
+  void Clear() {
+    commands.clear();
+    spawns.clear();
+  }
+
+  // runs every command in the order they were pushed and empties this,
+  // commands pushed while it runs are run too
+  void Execute();
+};
+
+// returns the command buffer the calling thread is recording into or
+// nullptr if changes to shared state can be made right away
+CommandBuffer* RecordingCommands();
+
+// buffer is a command buffer or nullptr
+// makes the calling thread record changes to shared state into buffer until
+// it is called again with nullptr
+void SetRecordingCommands(CommandBuffer* buffer);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_COMMAND_BUFFER_H_
@@ -8,11 +8,13 @@
 #define NUM_VERTEX_TOKENS 5
 #define NUM_FACE_TOKENS 4
 #define NUM_TEXTURE_VERTEX_TOKENS 3
+#define NUM_COLOR_TOKENS 4
 #define W_DEFAULT 1.0f
 #define VERTEX_SIZE 4
 #define TEXTURE_VERTEX_SIZE 2
 #define FACE_SIZE 3
 #define NORMAL_SIZE 3
+#define INTERLEAVED_SIZE (VERTEX_SIZE+NORMAL_SIZE+TEXTURE_VERTEX_SIZE)
 #define COLOR_SIZE 4
 #define GLUBYTE_SHIFT 8
 #define EOS '\0'
@@ -30,14 +32,46 @@
 #define RGB_MAX 255
 #define RGB_SIZE 3
 #define NUM_PPM_ATTRIBUTES 3
+#define PARSE_BUFFER_SIZE 64
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define MESH_CACHE_MAGIC 0x4853454dU
+#define MESH_CACHE_VERSION 1
+#define MESH_CACHE_EXTENSION ".mesh"
+#define TEXTURE_CACHE_MAGIC 0x4c584554U
+#define TEXTURE_CACHE_VERSION 1
+#define TEXTURE_CACHE_EXTENSION ".tex"
+#define INPUT_LOG_MAGIC 0x54504e49U
+#define INPUT_LOG_VERSION 1
 #define NUM_BOX_POINTS 8
 #define NUM_BOX_AXIS 6
+#define AABB_TREE_NULL -1
+#define AABB_TREE_MARGIN 0.1f
+#define OBB_EPSILON 1e-6f
+#define RAYCAST_MIN_DISTANCE 0.01f
+#define RAYCAST_BATCH_SIZE 4
+#define TILE_GRID_ID -2
+#define TILE_GRID_EPSILON 1e-4f
+#define PROJECTILE_POOL_SIZE 1024
+#define TAG_MAX 64
+#define SLOT_MAP_NULL -1
+#define SLOT_MAP_INDEX_BITS 20
+#define SLOT_MAP_INDEX_MASK ((1 << SLOT_MAP_INDEX_BITS) - 1)
+#define SLOT_MAP_GENERATION_MASK ((1 << (31 - SLOT_MAP_INDEX_BITS)) - 1)
+#define TRANSFORM_STORE_NULL -1
+#define FRUSTUM_PLANES 6
+#define FRUSTUM_CULL_MARGIN 0.5f
 #define WINDOW_WIDTH 1920
 #define WINDOW_HEIGHT 1080
 #define ENGINE_CURSOR_X 0
 #define ENGINE_CURSOR_Y 1
 #define ENGINE_DEAD_ZONE 0.2f
+#define ENGINE_COLLISION_RADIUS 1.0f
+#define ENGINE_RENDER_DISTANCE 100.0f
 #define ENGINE_MOUSE_SENSITIVITY 10
+#define ENGINE_TICK_RATE 60
+#define ENGINE_MAX_CATCH_UP_STEPS 5
+#define UPDATE_JOB_SIZE 64
 #define UI_MAX_WIDTH 100
 #define UI_MAX_HEIGHT 100
 #define UI_NUM_VERTICES 4
@@ -50,4 +84,6 @@ enum ui_positions {UI_LEFT_TOP, UI_CENTER_TOP, UI_RIGHT_TOP,
                UI_LEFT_BOTTOM, UI_CENTER_BOTTOM, UI_RIGHT_BOTTOM};
 enum ui_fixed {UI_NOT_FIX, UI_FIX_WIDTH, UI_FIX_HEIGHT};
 enum animation_actions {ANIMATION_STOP, ANIMATION_REPEAT, ANIMATION_TRANSITION};
+enum frame_phases {PHASE_INPUT, PHASE_UPDATE, PHASE_PHYSICS, PHASE_LATE_UPDATE,
+                   PHASE_CULL, PHASE_RENDER, PHASE_DESTROY, NUM_FRAME_PHASES};
 #endif  // SRC_ENGINE_CONSTANTS_H_
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/frustum.h"
+
+namespace engine {
+
+// view_projection is a projection matrix times a view matrix
+// returns the frustum that view_projection maps onto the clip box
+Frustum MakeFrustum(const glm::mat4 &view_projection) {
+  // a point is inside the clip box when -w <= x, y, z <= w, so each plane is
+  // the last row of the matrix plus or minus one of the others
+  glm::vec4 row[4];
+  for (int i = 0; i < 4; i++) {
+    row[i] = glm::vec4(view_projection[0][i], view_projection[1][i],
+                       view_projection[2][i], view_projection[3][i]);
+  }
+  Frustum frustum;
+  for (int i = 0; i < 3; i++) {
+    frustum.planes[i * 2] = row[3] + row[i];
+    frustum.planes[i * 2 + 1] = row[3] - row[i];
+  }
+  for (int i = 0; i < FRUSTUM_PLANES; i++) {
+    glm::vec4 &plane = frustum.planes[i];
+    plane /= std::sqrt(plane.x * plane.x + plane.y * plane.y +
+                       plane.z * plane.z);
+  }
+  return frustum;
+}
+
+// frustum is a frustum, minimum and maximum are the x, y, and z arrays of
+// count world space boxes, margin is how far outside a plane a box can be and
+// still count, and visible is an array of count flags
+// sets visible[i] to 1 if box i might be inside frustum and 0 if it is fully
+// outside one of its planes, each plane is tested against 4 boxes at a time
+// when SSE is available
+void CullBoxes(const Frustum &frustum, const float* const minimum[3],
+               const float* const maximum[3], int count, float margin,
+               uint8_t* visible) {
+  // corner[p][axis] is the array holding the corner of each box furthest
+  // along plane p's normal, if that corner is outside the plane the whole box
+  // is
+  const float* corner[FRUSTUM_PLANES][3];
+  for (int p = 0; p < FRUSTUM_PLANES; p++) {
+    for (int axis = 0; axis < 3; axis++) {
+      corner[p][axis] = frustum.planes[p][axis] >= 0 ? maximum[axis] :
+                                                       minimum[axis];
+    }
+  }
+  int i = 0;
+#ifdef ENGINE_FRUSTUM_SSE
+  __m128 normal[FRUSTUM_PLANES][3];
+  __m128 offset[FRUSTUM_PLANES];
+  for (int p = 0; p < FRUSTUM_PLANES; p++) {
+    for (int axis = 0; axis < 3; axis++) {
+      normal[p][axis] = _mm_set1_ps(frustum.planes[p][axis]);
+    }
+    offset[p] = _mm_set1_ps(frustum.planes[p].w + margin);
+  }
+  __m128 zero = _mm_setzero_ps();
+  for (; i + 4 <= count; i += 4) {
+    __m128 outside = _mm_setzero_ps();
+    for (int p = 0; p < FRUSTUM_PLANES; p++) {
+      __m128 dist = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(normal[p][0], _mm_loadu_ps(corner[p][0] + i)),
+                   _mm_mul_ps(normal[p][1], _mm_loadu_ps(corner[p][1] + i))),
+        _mm_add_ps(_mm_mul_ps(normal[p][2], _mm_loadu_ps(corner[p][2] + i)),
+                   offset[p]));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+    }
+    int mask = _mm_movemask_ps(outside);
+    for (int lane = 0; lane < 4; lane++) {
+      visible[i + lane] = !((mask >> lane) & 1);
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    bool outside = false;
+    for (int p = 0; p < FRUSTUM_PLANES; p++) {
+      const glm::vec4 &plane = frustum.planes[p];
+      outside |= plane.x * corner[p][0][i] + plane.y * corner[p][1][i] +
+                 plane.z * corner[p][2][i] + plane.w + margin < 0;
+    }
+    visible[i] = !outside;
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,51 @@
+#ifndef SRC_ENGINE_FRUSTUM_H_
+#define SRC_ENGINE_FRUSTUM_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENGINE_FRUSTUM_SSE
+#endif
+
+// lib
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+
+// src
+#include "engine/constants.h"
+
+namespace engine {
+
+// Frustum is the planes around everything a camera can see in world space,
+// in the order left, right, bottom, top, near, far. Each plane's x y z is a
+// unit normal pointing inside and w is its offset, so a point p is on the
+// inside of a plane when dot(xyz, p) + w >= 0.
+struct Frustum {
+  glm::vec4 planes[FRUSTUM_PLANES];
+};
+
+// view_projection is a projection matrix times a view matrix
+// returns the frustum that view_projection maps onto the clip box
+Frustum MakeFrustum(const glm::mat4 &view_projection);
+
+// frustum is a frustum, minimum and maximum are the x, y, and z arrays of
+// count world space boxes, margin is how far outside a plane a box can be and
+// still count, and visible is an array of count flags
+// sets visible[i] to 1 if box i might be inside frustum and 0 if it is fully
+// outside one of its planes, each plane is tested against 4 boxes at a time
+// when SSE is available
+void CullBoxes(const Frustum &frustum, const float* const minimum[3],
+               const float* const maximum[3], int count, float margin,
+               uint8_t* visible);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_FRUSTUM_H_
@@ -3,6 +3,7 @@
  */
 
 #include "engine/game_object.h"
+#include "engine/project.h"
 
 namespace engine {
 
@@ -12,32 +13,53 @@ namespace engine {
 
   // Default Constructor
   GameObject::GameObject() {
-    position = {0.0f, 0.0f, 0.0f};
-    scale = {1.0f, 1.0f, 1.0f};
-    glm::vec3 axis = {0.0f, 0.0f, -1.0f};
-    orientation = glm::angleAxis(0.0f, axis);
-    SetBoundingBox(glm::vec3(0, 0, 0), glm::vec3(0, 0, 0));
-    bounding_box_axis_aligned = false;
+    project = nullptr;
+    id = -1;
+    scene_list = nullptr;
+    scene_index = -1;
+    // new transforms start at the origin with no rotation, a scale of one,
+    // and an empty bounding box
+    transform = Transforms().Insert(this);
+  }
+
+  // Copy Constructor
+  GameObject::GameObject(const GameObject &other) {
+    project = nullptr;
+    id = -1;
+    scene_list = nullptr;
+    scene_index = -1;
+    tags = other.tags;
+    transform = Transforms().Insert(this);
+    Transforms().Copy(other.transform, transform);
+  }
+
+  // Deconstructor
+  GameObject::~GameObject() {
+    Transforms().Remove(transform);
+  }
+
+  // Assignment Operator
+  GameObject& GameObject::operator=(const GameObject &other) {
+    if (this != &other) {
+      tags = other.tags;
+      Transforms().Copy(other.transform, transform);
+    }
+    return *this;
   }
 
   // tag is a string
   // returns if tag is in tags
-  bool GameObject::HasTag(std::string tag) {
-    bool found = false;
-    int i = 0;
-    while (i < tags.size() && !found) {
-      if (tags[i] == tag) {
-        found = true;
-      }
-      i++;
-    }
-    return found;
+  bool GameObject::HasTag(const std::string &tag) {
+    return tags.Has(tag);
   }
 
   // position is the new position
   // sets this.position to position
   void GameObject::SetPosition(glm::vec3 position) {
-    this->position = position;
+    Transforms().SetPosition(transform, position);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
   }
 
   // x, y, and z describe a location
@@ -49,7 +71,10 @@ namespace engine {
   // orientation is the new orientation
   // sets this.orientation to orientation
   void GameObject::SetOrientation(glm::quat orientation) {
-    this->orientation = orientation;
+    Transforms().SetOrientation(transform, orientation);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
   }
 
   // angle and axis describe an angle axis and radians is whether angle is
@@ -62,42 +87,127 @@ namespace engine {
   // scale is the new scale
   // sets this.scale to scale
   void GameObject::SetScale(glm::vec3 scale) {
-    this->scale = scale;
+    Transforms().SetScale(transform, scale);
   }
 
   // minimum and maximum define a bounding box
   // sets the bounding box memeber data
   void GameObject::SetBoundingBox(glm::vec3 minimum, glm::vec3 maximum) {
-    bounding_box_min = minimum;
-    bounding_box_max = maximum;
+    Transforms().SetBoundingBox(transform, minimum, maximum);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
+  }
+
+  // aligned is whether the bounding box should ignore the orientation
+  // sets whether the bounding box is axis aligned
+  void GameObject::SetBoundingBoxAxisAligned(bool aligned) {
+    Transforms().SetAxisAligned(transform, aligned);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
   }
 
   // returns the position
-  glm::vec3 GameObject::GetPosition() {
-    return position;
+  glm::vec3 GameObject::GetPosition() const {
+    return Transforms().GetPosition(transform);
   }
 
   // returns the orientation
-  glm::quat GameObject::GetOrientation() {
-    return orientation;
+  glm::quat GameObject::GetOrientation() const {
+    return Transforms().GetOrientation(transform);
   }
 
   // returns the scale
-  glm::vec3 GameObject::GetScale() {
-    return scale;
+  glm::vec3 GameObject::GetScale() const {
+    return Transforms().GetScale(transform);
+  }
+
+  // parent is a game object or nullptr
+  // attaches this to parent so it follows it, or detaches it if parent is
+  // nullptr, without moving this
+  void GameObject::SetParent(GameObject* parent) {
+    Transforms().SetParent(transform, parent ? parent->transform :
+                                              TRANSFORM_STORE_NULL);
+  }
+
+  // returns the game object this is attached to or nullptr
+  GameObject* GameObject::GetParent() const {
+    int parent = Transforms().GetParent(transform);
+    return parent == TRANSFORM_STORE_NULL ? nullptr :
+                                            Transforms().GetOwner(parent);
+  }
+
+  // position is relative to the parent
+  // sets this's position relative to its parent
+  void GameObject::SetLocalPosition(glm::vec3 position) {
+    Transforms().SetLocalPosition(transform, position);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
+  }
+
+  // orientation is relative to the parent
+  // sets this's orientation relative to its parent
+  void GameObject::SetLocalOrientation(glm::quat orientation) {
+    Transforms().SetLocalOrientation(transform, orientation);
+    if (project != nullptr) {
+      project->UpdateBroadphase(this);
+    }
+  }
+
+  // scale is relative to the parent
+  // sets this's scale relative to its parent
+  void GameObject::SetLocalScale(glm::vec3 scale) {
+    Transforms().SetLocalScale(transform, scale);
+  }
+
+  // returns the position relative to the parent
+  glm::vec3 GameObject::GetLocalPosition() const {
+    return Transforms().GetLocalPosition(transform);
+  }
+
+  // returns the orientation relative to the parent
+  glm::quat GameObject::GetLocalOrientation() const {
+    return Transforms().GetLocalOrientation(transform);
+  }
+
+  // returns the scale relative to the parent
+  glm::vec3 GameObject::GetLocalScale() const {
+    return Transforms().GetLocalScale(transform);
+  }
+
+  // returns the matrix from this's model space to world space, it is cached
+  // and only rebuilt after the transform changes
+  const glm::mat4& GameObject::GetWorldMatrix() const {
+    TransformStore &transforms = Transforms();
+    if (transforms.IsDirty(transform)) {
+      transforms.SetWorldMatrix(transform, ComputeWorldMatrix());
+    }
+    return transforms.GetWorldMatrix(transform);
+  }
+
+  // marks the cached world matrix as out of date
+  void GameObject::SetWorldMatrixDirty() {
+    Transforms().SetDirty(transform);
+  }
+
+  // returns the world matrix built from the position, orientation, and scale
+  glm::mat4 GameObject::ComputeWorldMatrix() const {
+    return ComposeMatrix(GetPosition(), GetOrientation(), GetScale());
   }
 
   // changes the game object’s current position by moving it relative to its
   // current position and orientation by the specified vector
   void GameObject::Move(glm::vec3 distance) {
-    SetPosition(position + (orientation * distance));
+    SetPosition(GetPosition() + (GetOrientation() * distance));
   }
 
   // changes the game object’s current orientation by turning it relative to
   // its current orientation by the specified angle around the specified vector
   void GameObject::Turn(GLfloat angle, glm::vec3 axis, bool radians) {
     glm::quat rotate_by = AxisToQuat(angle, axis, radians);
-    SetOrientation(orientation * rotate_by);
+    SetOrientation(GetOrientation() * rotate_by);
   }
 
   // changes the game object’s current position and orientation. The position
@@ -107,12 +217,24 @@ namespace engine {
   // z-axis points from the eye position to the center position.
   void GameObject::LookAt(glm::vec3 eye, glm::vec3 center, glm::vec3 up) {
     SetPosition(eye);
+    LookAt(center, up);
+  }
+
+  // turns the game object in place so it “looks at” the specified center
+  // position with the specified up vector
+  void GameObject::LookAt(glm::vec3 center, glm::vec3 up) {
+    glm::vec3 eye = GetPosition();
     glm::mat4 rot_mat = glm::inverse(glm::lookAt(eye, center, up));
     SetOrientation(glm::quat_cast(rot_mat));
   }
 
   // returns an array of size 8 that represents all vertices in our bounding box
   glm::vec3 * GameObject::GetBoundingBoxPoints() const {
+    TransformStore &transforms = Transforms();
+    glm::vec3 bounding_box_min = transforms.GetBoundingBoxMin(transform);
+    glm::vec3 bounding_box_max = transforms.GetBoundingBoxMax(transform);
+    glm::vec3 position = transforms.GetPosition(transform);
+    glm::quat orientation = transforms.GetOrientation(transform);
     glm::vec3 * rv = new glm::vec3[NUM_BOX_POINTS];
     glm::vec3 points[NUM_BOX_POINTS] = {
       bounding_box_min,
@@ -127,7 +249,7 @@ namespace engine {
 
     for (int i = 0; i < NUM_BOX_POINTS; i++) {
       glm::vec3 temp = points[i];
-      if (!bounding_box_axis_aligned) {
+      if (!transforms.GetAxisAligned(transform)) {
         temp = glm::rotate(orientation, temp);
       }
       temp += position;
@@ -137,12 +259,44 @@ namespace engine {
     return rv;
   }
 
+  // returns the smallest world space axis aligned box around the bounding box
+  AABB GameObject::GetWorldBounds() const {
+    return Transforms().GetWorldBounds(transform);
+  }
+
+  // returns the bounding box in world space
+  OBB GameObject::GetOBB() const {
+    TransformStore &transforms = Transforms();
+    glm::vec3 bounding_box_min = transforms.GetBoundingBoxMin(transform);
+    glm::vec3 bounding_box_max = transforms.GetBoundingBoxMax(transform);
+    OBB box;
+    glm::vec3 center = (bounding_box_min + bounding_box_max) * 0.5f;
+    box.half_extents = (bounding_box_max - bounding_box_min) * 0.5f;
+    if (transforms.GetAxisAligned(transform)) {
+      box.axes[0] = glm::vec3(1, 0, 0);
+      box.axes[1] = glm::vec3(0, 1, 0);
+      box.axes[2] = glm::vec3(0, 0, 1);
+    } else {
+      glm::mat3 rot = glm::toMat3(transforms.GetOrientation(transform));
+      center = rot * center;
+      for (int i = 0; i < 3; i++) {
+        box.axes[i] = rot[i];
+      }
+    }
+    box.center = center + transforms.GetPosition(transform);
+    return box;
+  }
+
   // point is a global position
   // returns true if point is in or touching the bounding box of this and
   // false otherwise
   bool GameObject::Intersects(glm::vec3 point) const {
-    point -= position;
-    point = glm::rotate(glm::inverse(orientation), point);
+    TransformStore &transforms = Transforms();
+    glm::vec3 bounding_box_min = transforms.GetBoundingBoxMin(transform);
+    glm::vec3 bounding_box_max = transforms.GetBoundingBoxMax(transform);
+    point -= transforms.GetPosition(transform);
+    point = glm::rotate(glm::inverse(transforms.GetOrientation(transform)),
+                        point);
     return (point.x >= bounding_box_min.x && point.x <= bounding_box_max.x &&
             point.y >= bounding_box_min.y && point.y <= bounding_box_max.y &&
             point.z >= bounding_box_min.z && point.z <= bounding_box_max.z);
@@ -152,66 +306,26 @@ namespace engine {
   // returns true if the other gameobject is colliding with this and false
   // otherwise
   bool GameObject::Intersects(const GameObject & other) const {
-    bool rv = true;
-    glm::vec3 * my_points = GetBoundingBoxPoints();
-    glm::vec3 * other_points = other.GetBoundingBoxPoints();
-    glm::vec3 axises[NUM_BOX_AXIS] = {
-      glm::normalize(my_points[0] - my_points[1]),
-      glm::normalize(my_points[0] - my_points[2]),
-      glm::normalize(my_points[0] - my_points[3]),
-      glm::normalize(other_points[0] - other_points[1]),
-      glm::normalize(other_points[0] - other_points[2]),
-      glm::normalize(other_points[0] - other_points[3])
-    };
-
-    for (int i = 0; i < NUM_BOX_AXIS && rv; i++) {
-      float my_min_max[2] = {0, 0};
-      float other_min_max[2] = {0, 0};
-
-      GetMinMaxOnAxis(my_min_max, axises[i], my_points);
-      GetMinMaxOnAxis(other_min_max, axises[i], other_points);
-
-      if ((my_min_max[0] > other_min_max[1] && my_min_max[0] > other_min_max[0])
-      || (my_min_max[1] < other_min_max[1] && my_min_max[1] < other_min_max[0])
-      ) {
-        rv = false;
-      }
-    }
-
-    delete[] my_points;
-    delete[] other_points;
-    return rv;
+    return OverlapOBB(GetOBB(), other.GetOBB());
   }
 
   // start and end define a line segment in 3d space
   // returns the first position on that segment that this intersects or -1 if
   // this doesn't intersect
   float GameObject::RayCast(glm::vec3 start, glm::vec3 end) const {
-    float rv = -1;
-    // Create points and faces for bounding box
-    glm::vec3* points = GetBoundingBoxPoints();
-    int faces[6][4] = {
-      {0, 1, 3, 6},
-      {0, 3, 5, 2},
-      {2, 5, 4, 7},
-      {1, 6, 4, 7},
-      {0, 2, 1, 7},
-      {3, 5, 4, 6}
-    };
-
-    // get the first intersection
-    for (int i = 0; i < 6; i++) {
-      float temp = GetCollisionOnLine(start, end, faces[i], points);
-      if (temp != -1) {
-        if (rv == -1 || temp < rv) {
-          rv = temp;
-        }
-      }
-    }
+    return RayCastOBB(GetOBB(), start, end);
+  }
 
-    // clean up heap
-    delete[] points;
-    return rv;
+  // hash is the hash to continue from
+  // returns hash with this's id, position, orientation, and scale mixed in
+  uint64_t GameObject::Hash(uint64_t hash) const {
+    glm::vec3 position = GetPosition();
+    glm::quat orientation = GetOrientation();
+    glm::vec3 scale = GetScale();
+    hash = HashBytes(&id, sizeof(id), hash);
+    hash = HashBytes(&position, sizeof(position), hash);
+    hash = HashBytes(&orientation, sizeof(orientation), hash);
+    return HashBytes(&scale, sizeof(scale), hash);
   }
 
   // Overload << operator
@@ -223,12 +337,14 @@ namespace engine {
         os << ", ";
       }
     }
-    glm::vec3 pos = go.position;
+    glm::vec3 pos = go.GetPosition();
+    glm::quat orientation = go.GetOrientation();
+    glm::vec3 scale = go.GetScale();
     os << "}, {p: (" << pos.x << ", " << pos.y << ", " << pos.z << "), o: {"
-    << glm::angle(go.orientation) << ", (";
-    glm::vec3 r_axis = glm::axis(go.orientation);
+    << glm::angle(orientation) << ", (";
+    glm::vec3 r_axis = glm::axis(orientation);
     os << r_axis.x << ", " << r_axis.y << ", " << r_axis.z << ")}, s: (" <<
-    go.scale.x << ", " << go.scale.y << ", " << go.scale.z << ")}";
+    scale.x << ", " << scale.y << ", " << scale.z << ")}";
     return os;
   }
 
@@ -17,8 +17,13 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtx/vector_angle.hpp"
 
+#include "engine/aabb_tree.h"
+#include "engine/obb.h"
 #include "engine/constants.h"
 #include "engine/helper.h"
+#include "engine/scene_list.h"
+#include "engine/tags.h"
+#include "engine/transform_store.h"
 
 namespace engine {
 
@@ -26,25 +31,34 @@ namespace engine {
 class Project;
 class GameObject {
  protected:
-  glm::vec3 position;
-  glm::vec3 scale;
-  glm::quat orientation;
-
-  // Bounding Box
-  glm::vec3 bounding_box_min, bounding_box_max;
+  // transform is this's handle in Transforms(), which holds its position,
+  // orientation, scale, and bounding box
+  int transform;
 
  public:
   Project* project;
   int id;
-  std::vector<std::string> tags;
-  bool bounding_box_axis_aligned;
+  // scene_list is the camera, rigidbody, or ui list this is in and
+  // scene_index is where, so the project can remove it without searching
+  SceneListBase* scene_list;
+  int scene_index;
+  TagList tags;
 
   // Default Constructor
   GameObject();
 
+  // Copy Constructor
+  GameObject(const GameObject &other);
+
+  // Deconstructor
+  virtual ~GameObject();
+
+  // Assignment Operator
+  GameObject& operator=(const GameObject &other);
+
   // tag is a string
   // returns if tag is in tags
-  bool HasTag(std::string tag);
+  bool HasTag(const std::string &tag);
 
   // position is the new position
   // sets this.position to position
@@ -71,14 +85,60 @@ class GameObject {
   // sets the bounding box memeber data
   void SetBoundingBox(glm::vec3 minimum, glm::vec3 maximum);
 
+  // aligned is whether the bounding box should ignore the orientation
+  // sets whether the bounding box is axis aligned
+  void SetBoundingBoxAxisAligned(bool aligned);
+
   // returns the position
-  glm::vec3 GetPosition();
+  glm::vec3 GetPosition() const;
 
   // returns the orientation
-  glm::quat GetOrientation();
+  glm::quat GetOrientation() const;
 
   // returns the scale
-  glm::vec3 GetScale();
+  glm::vec3 GetScale() const;
+
+  // returns the handle of this's transform in Transforms()
+  int GetTransform() const {return transform;}
+
+  // parent is a game object or nullptr
+  // attaches this to parent so it follows it, or detaches it if parent is
+  // nullptr, without moving this
+  void SetParent(GameObject* parent);
+
+  // returns the game object this is attached to or nullptr
+  GameObject* GetParent() const;
+
+  // position is relative to the parent
+  // sets this's position relative to its parent
+  void SetLocalPosition(glm::vec3 position);
+
+  // orientation is relative to the parent
+  // sets this's orientation relative to its parent
+  void SetLocalOrientation(glm::quat orientation);
+
+  // scale is relative to the parent
+  // sets this's scale relative to its parent
+  void SetLocalScale(glm::vec3 scale);
+
+  // returns the position relative to the parent
+  glm::vec3 GetLocalPosition() const;
+
+  // returns the orientation relative to the parent
+  glm::quat GetLocalOrientation() const;
+
+  // returns the scale relative to the parent
+  glm::vec3 GetLocalScale() const;
+
+  // returns the matrix from this's model space to world space, it is cached
+  // and only rebuilt after the transform changes
+  const glm::mat4& GetWorldMatrix() const;
+
+  // marks the cached world matrix as out of date
+  void SetWorldMatrixDirty();
+
+  // returns the world matrix built from the position, orientation, and scale
+  virtual glm::mat4 ComputeWorldMatrix() const;
 
   // changes the game object’s current position by moving it relative to its
   // current position and orientation by the specified vector
@@ -95,9 +155,19 @@ class GameObject {
   // z-axis points from the eye position to the center position.
   void LookAt(glm::vec3 eye, glm::vec3 center, glm::vec3 up);
 
+  // turns the game object in place so it “looks at” the specified center
+  // position with the specified up vector
+  void LookAt(glm::vec3 center, glm::vec3 up);
+
   // returns an array of size 8 that represents all vertices in our bounding box
   glm::vec3 * GetBoundingBoxPoints() const;
 
+  // returns the smallest world space axis aligned box around the bounding box
+  AABB GetWorldBounds() const;
+
+  // returns the bounding box in world space
+  OBB GetOBB() const;
+
   // point is a global position
   // returns true if point is in or touching the bounding box of this and
   // false otherwise
@@ -116,6 +186,16 @@ class GameObject {
   // Virtual Function Update
   virtual void Update(float delta) = 0;
 
+  // type is the projectile type that hit this
+  // called by the projectile system when one of its projectiles hits this
+  virtual void OnProjectileHit(int type) {}
+
+  // hash is the hash to continue from
+  // returns hash with this's id, position, orientation, and scale mixed in,
+  // subclasses with state of their own mix it in too so replays that drift
+  // apart can be caught
+  virtual uint64_t Hash(uint64_t hash) const;
+
   // Overload << operator
   friend std::ostream& operator<<(std::ostream& os, const GameObject& go);
 };
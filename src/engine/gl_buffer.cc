@@ -0,0 +1,59 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/gl_buffer.h"
+
+namespace engine {
+
+typedef void (APIENTRY *GenBuffersProc)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *BufferDataProc)(GLenum target, ptrdiff_t size,
+                                        const GLvoid* data, GLenum usage);
+typedef void (APIENTRY *DeleteBuffersProc)(GLsizei n, const GLuint* buffers);
+
+static GenBuffersProc gen_buffers = nullptr;
+static BindBufferProc bind_buffer = nullptr;
+static BufferDataProc buffer_data = nullptr;
+static DeleteBuffersProc delete_buffers = nullptr;
+static bool loaded = false;
+
+// returns whether vertex and index buffer objects can be used in the current
+// context
+bool BufferObjectsSupported() {
+  if (Headless()) {
+    return false;
+  }
+  if (!loaded && glGetString(GL_VERSION) != nullptr) {
+    // a context is current so the driver can be asked for the functions
+    gen_buffers = reinterpret_cast<GenBuffersProc>(
+      glfwGetProcAddress("glGenBuffers"));
+    bind_buffer = reinterpret_cast<BindBufferProc>(
+      glfwGetProcAddress("glBindBuffer"));
+    buffer_data = reinterpret_cast<BufferDataProc>(
+      glfwGetProcAddress("glBufferData"));
+    delete_buffers = reinterpret_cast<DeleteBuffersProc>(
+      glfwGetProcAddress("glDeleteBuffers"));
+    loaded = true;
+  }
+  return gen_buffers != nullptr && bind_buffer != nullptr &&
+         buffer_data != nullptr && delete_buffers != nullptr;
+}
+
+void GenBuffers(GLsizei n, GLuint* buffers) {
+  gen_buffers(n, buffers);
+}
+
+void BindBuffer(GLenum target, GLuint buffer) {
+  bind_buffer(target, buffer);
+}
+
+void BufferData(GLenum target, size_t size, const GLvoid* data, GLenum usage) {
+  buffer_data(target, size, data, usage);
+}
+
+void DeleteBuffers(GLsizei n, const GLuint* buffers) {
+  delete_buffers(n, buffers);
+}
+
+}  // namespace engine
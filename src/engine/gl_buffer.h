@@ -0,0 +1,45 @@
+#ifndef SRC_ENGINE_GL_BUFFER_H_
+#define SRC_ENGINE_GL_BUFFER_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <GLFW/glfw3.h>
+#include <cstddef>
+
+// src
+#include "engine/headless.h"
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW 0x88E4
+#endif
+
+namespace engine {
+
+// OpenGL 1.1 headers (and opengl32 on windows) don't provide buffer objects,
+// so these functions are loaded from the driver the first time a context is
+// current. When the driver doesn't have them models fall back to client side
+// arrays.
+
+// returns whether vertex and index buffer objects can be used in the current
+// context
+bool BufferObjectsSupported();
+
+// wrappers around the loaded buffer object functions, only call these when
+// BufferObjectsSupported returns true
+void GenBuffers(GLsizei n, GLuint* buffers);
+void BindBuffer(GLenum target, GLuint buffer);
+void BufferData(GLenum target, size_t size, const GLvoid* data, GLenum usage);
+void DeleteBuffers(GLsizei n, const GLuint* buffers);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_GL_BUFFER_H_
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/headless.h"
+
+namespace engine {
+
+static bool headless = false;
+
+// returns whether OpenGL calls are skipped because there is no context
+bool Headless() {
+  return headless;
+}
+
+// headless is whether there is no OpenGL context
+// sets what Headless returns, it has to be set before anything is loaded
+void SetHeadless(bool headless) {
+  engine::headless = headless;
+}
+
+}  // namespace engine
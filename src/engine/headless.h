@@ -0,0 +1,25 @@
+#ifndef SRC_ENGINE_HEADLESS_H_
+#define SRC_ENGINE_HEADLESS_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+namespace engine {
+
+// A headless program has no window and no OpenGL context, like a test or a
+// bot match on a machine without a display. Everything that talks to OpenGL
+// checks Headless first and only keeps its data when it is set, so models,
+// materials, textures, and lights can still be loaded and used by the
+// simulation.
+
+// returns whether OpenGL calls are skipped because there is no context
+bool Headless();
+
+// headless is whether there is no OpenGL context
+// sets what Headless returns, it has to be set before anything is loaded
+void SetHeadless(bool headless);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_HEADLESS_H_
@@ -36,6 +36,116 @@ std::vector<std::string> Tokenize(std::string str, std::string sep) {
   return tokens;
 }
 
+// str is a null terminated string
+// returns whether this token has the same characters as str
+bool Token::operator==(const char* str) const {
+  size_t i = 0;
+  while (i < size && str[i] != EOS && str[i] == data[i]) {
+    i++;
+  }
+  return i == size && str[i] == EOS;
+}
+
+// begin and end bound a line of text, sep is a character to tokenize by, '\0'
+// is whitespace
+// fills tokens with views of all items in the line seperated by sep
+void Tokenize(const char* begin, const char* end, std::vector<Token>* tokens,
+              char sep) {
+  tokens->clear();
+  const char* start = nullptr;
+  bool found = false;
+  for (const char* c = begin; c < end; c++) {
+    found = (sep == EOS) ? (isspace(*c)) : (*c == sep);
+    if (found) {
+      if (start != nullptr) {
+        // a token was found
+        tokens->push_back({start, static_cast<size_t>(c-start)});
+        start = nullptr;
+      }
+    } else if (start == nullptr) {
+      start = c;
+    }
+    if (*c == '#') {
+      // the comment character ends the line but stays in the final token
+      tokens->push_back({start, static_cast<size_t>(c+1-start)});
+      return;
+    }
+  }
+  if (start != nullptr) {
+    // final token
+    tokens->push_back({start, static_cast<size_t>(end-start)});
+  }
+}
+
+// token is a view of a number
+// sets value and returns true if token starts with a float the same way
+// std::stof would and returns false otherwise
+bool ParseFloat(const Token& token, float* value) {
+  // strtof needs a null terminated string so copy short tokens to the stack
+  char buffer[PARSE_BUFFER_SIZE];
+  std::string long_token;
+  const char* str = buffer;
+  if (token.size < PARSE_BUFFER_SIZE) {
+    std::copy(token.data, token.data+token.size, buffer);
+    buffer[token.size] = EOS;
+  } else {
+    long_token = token.ToString();
+    str = long_token.c_str();
+  }
+  char* str_end;
+  errno = 0;
+  float rv = strtof(str, &str_end);
+  if (str_end == str || errno == ERANGE) {
+    return false;
+  }
+  *value = rv;
+  return true;
+}
+
+// token is a view of a number
+// sets value and returns true if token starts with an int the same way
+// std::stoi would and returns false otherwise
+bool ParseInt(const Token& token, int* value) {
+  const char* c = token.data;
+  const char* end = token.data + token.size;
+  while (c < end && isspace(*c)) {
+    c++;
+  }
+  bool negative = false;
+  if (c < end && (*c == '-' || *c == '+')) {
+    negative = (*c == '-');
+    c++;
+  }
+  if (c == end || !isdigit(*c)) {
+    return false;
+  }
+  int64_t rv = 0;
+  while (c < end && isdigit(*c)) {
+    rv = (rv * 10) + (*c - '0');
+    if (rv > static_cast<int64_t>(INT_MAX) + 1) {
+      return false;
+    }
+    c++;
+  }
+  rv = negative ? -rv : rv;
+  if (rv > INT_MAX || rv < INT_MIN) {
+    return false;
+  }
+  *value = static_cast<int>(rv);
+  return true;
+}
+
+// data points to size bytes and hash is the hash to continue from
+// returns the 64 bit FNV-1a hash of the bytes
+uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
 // returns returns value clamped to min and max
 float clamp(float value, float min, float max) {
   if (min > value) {
@@ -227,6 +337,19 @@ glm::quat AxisToQuat(float angle, glm::vec3 axis, bool radians) {
   return glm::angleAxis(angle, axis);
 }
 
+// position, orientation, and scale describe a transform
+// returns the matrix that scales, then rotates, then translates, the same as
+// glTranslatef, glMultMatrixf, and glScalef in that order
+glm::mat4 ComposeMatrix(glm::vec3 position, glm::quat orientation,
+                        glm::vec3 scale) {
+  glm::mat4 rv = glm::toMat4(orientation);
+  for (int i = 0; i < 3; i++) {
+    rv[i] *= scale[i];
+  }
+  rv[3] = glm::vec4(position, 1.0f);
+  return rv;
+}
+
 // axis is an axis in 3d space and point is a point in 3d space
 // returns the value of how far along the axis point is
 float ValueOnAxis(glm::vec3 axis, glm::vec3 point) {
@@ -7,6 +7,11 @@
 
 #include <GLFW/glfw3.h>
 #include <math.h>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -21,10 +26,50 @@
 
 namespace engine {
 
+// Token is a view of a run of characters in a larger buffer, it does not own
+// or copy the characters
+struct Token {
+  const char* data;
+  size_t size;
+
+  // str is a null terminated string
+  // returns whether this token has the same characters as str
+  bool operator==(const char* str) const;
+
+  // str is a null terminated string
+  // returns whether this token doesn't have the same characters as str
+  bool operator!=(const char* str) const {return !(*this == str);}
+
+  // returns a copy of the characters as a string
+  std::string ToString() const {return std::string(data, size);}
+};
+
 // str is a string, sep is a character to tokenize str by, "ws" is whitespace
 // returns a vector of all items in str seperated by whitespace
 std::vector<std::string> Tokenize(std::string str, std::string sep = "ws");
 
+// begin and end bound a line of text, sep is a character to tokenize by, '\0'
+// is whitespace
+// fills tokens with views of all items in the line seperated by sep, tokens is
+// cleared first so it can be reused without allocating
+void Tokenize(const char* begin, const char* end, std::vector<Token>* tokens,
+              char sep = '\0');
+
+// token is a view of a number
+// sets value and returns true if token starts with a float the same way
+// std::stof would and returns false otherwise
+bool ParseFloat(const Token& token, float* value);
+
+// token is a view of a number
+// sets value and returns true if token starts with an int the same way
+// std::stoi would and returns false otherwise
+bool ParseInt(const Token& token, int* value);
+
+// data points to size bytes and hash is the hash to continue from
+// returns the 64 bit FNV-1a hash of the bytes
+uint64_t HashBytes(const void* data, size_t size,
+                   uint64_t hash = FNV_OFFSET_BASIS);
+
 // returns returns value clamped to min and max
 float clamp(float value, float min, float max);
 
@@ -71,6 +116,12 @@ glm::quat GetAligningRotation(glm::vec3 axis, glm::vec3 d_axis);
 // returns a quaternion that represents the axis angle
 glm::quat AxisToQuat(float angle, glm::vec3 axis, bool radians);
 
+// position, orientation, and scale describe a transform
+// returns the matrix that scales, then rotates, then translates, the same as
+// glTranslatef, glMultMatrixf, and glScalef in that order
+glm::mat4 ComposeMatrix(glm::vec3 position, glm::quat orientation,
+                        glm::vec3 scale);
+
 // axis is an axis in 3d space and point is a point in 3d space
 // returns the value of how far along the axis point is
 float ValueOnAxis(glm::vec3 axis, glm::vec3 point);
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/input_log.h"
+
+namespace engine {
+
+// offsets into a snapshot are stored as uint16s
+static_assert(sizeof(InputState) <= UINT16_MAX,
+              "InputState is too big for an input log");
+
+// makes a log that is neither recording nor replaying
+InputLog::InputLog() {
+  memset(&last, 0, sizeof(last));
+}
+
+// filename is the file to record to
+// starts writing a new log to filename, throws if it can't be opened
+void InputLog::Record(const std::string &filename) {
+  Close();
+  out.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::string("could not open input log ") + filename;
+  }
+  uint32_t header[3] = {INPUT_LOG_MAGIC, INPUT_LOG_VERSION,
+                        sizeof(InputState)};
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+// filename is a log written by Record
+// starts reading filename, throws if it can't be opened or wasn't
+// written by this version of the engine
+void InputLog::Replay(const std::string &filename) {
+  Close();
+  in.open(filename, std::ios::in | std::ios::binary);
+  if (!in.is_open()) {
+    throw std::string("could not open input log ") + filename;
+  }
+  uint32_t header[3];
+  if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+      header[0] != INPUT_LOG_MAGIC || header[1] != INPUT_LOG_VERSION ||
+      header[2] != sizeof(InputState)) {
+    in.close();
+    throw filename + " is not an input log this engine can replay";
+  }
+}
+
+// stops recording or replaying and closes the file
+void InputLog::Close() {
+  if (out.is_open()) {
+    out.close();
+  }
+  if (in.is_open()) {
+    in.close();
+  }
+  memset(&last, 0, sizeof(last));
+}
+
+// input is the snapshot a step used and delta is its length in seconds
+// appends the step to the log
+void InputLog::Write(const InputState &input, float delta) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&input);
+  uint8_t* last_bytes = reinterpret_cast<uint8_t*>(&last);
+  uint16_t changed = 0;
+  for (int i = 0; i < sizeof(InputState); i++) {
+    changed += bytes[i] != last_bytes[i];
+  }
+  out.write(reinterpret_cast<const char*>(&delta), sizeof(delta));
+  out.write(reinterpret_cast<const char*>(&changed), sizeof(changed));
+  for (uint16_t i = 0; i < sizeof(InputState); i++) {
+    if (bytes[i] != last_bytes[i]) {
+      out.write(reinterpret_cast<const char*>(&i), sizeof(i));
+      out.write(reinterpret_cast<const char*>(&bytes[i]), 1);
+      last_bytes[i] = bytes[i];
+    }
+  }
+}
+
+// input and delta are where to put the next step's snapshot and length
+// reads the next step and returns false once the log has run out
+bool InputLog::Read(InputState* input, float* delta) {
+  uint16_t changed;
+  if (!in.read(reinterpret_cast<char*>(delta), sizeof(*delta)) ||
+      !in.read(reinterpret_cast<char*>(&changed), sizeof(changed))) {
+    return false;
+  }
+  uint8_t* last_bytes = reinterpret_cast<uint8_t*>(&last);
+  for (int i = 0; i < changed; i++) {
+    uint16_t offset;
+    uint8_t value;
+    if (!in.read(reinterpret_cast<char*>(&offset), sizeof(offset)) ||
+        !in.read(reinterpret_cast<char*>(&value), 1) ||
+        offset >= sizeof(InputState)) {
+      return false;
+    }
+    last_bytes[offset] = value;
+  }
+  memcpy(input, &last, sizeof(last));
+  return true;
+}
+
+}  // namespace engine
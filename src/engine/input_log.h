@@ -0,0 +1,70 @@
+#ifndef SRC_ENGINE_INPUT_LOG_H_
+#define SRC_ENGINE_INPUT_LOG_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+// src
+#include "engine/constants.h"
+#include "engine/input_state.h"
+
+namespace engine {
+
+// InputLog writes the input snapshot and length of every simulation step to
+// a binary file, or reads them back so a session can be stepped through
+// again exactly as it was played. Only the bytes of a snapshot that changed
+// since the step before are stored, so held keys and an idle gamepad cost
+// nothing.
+//
+// An input log is laid out as:
+//   uint32 magic, uint32 version, uint32 size of an InputState
+//   then for each step: float delta, uint16 number of changed bytes, then
+//     for each: uint16 offset into the InputState, uint8 new value
+class InputLog {
+ private:
+  std::ofstream out;
+  std::ifstream in;
+  // last is the snapshot of the last step written or read
+  InputState last;
+
+ public:
+  // Constructor
+  // makes a log that is neither recording nor replaying
+  InputLog();
+
+  // filename is the file to record to
+  // starts writing a new log to filename, throws if it can't be opened
+  void Record(const std::string &filename);
+
+  // filename is a log written by Record
+  // starts reading filename, throws if it can't be opened or wasn't
+  // written by this version of the engine
+  void Replay(const std::string &filename);
+
+  // stops recording or replaying and closes the file
+  void Close();
+
+  // returns whether steps are being written
+  bool IsRecording() const {return out.is_open();}
+
+  // returns whether steps are being read
+  bool IsReplaying() const {return in.is_open();}
+
+  // input is the snapshot a step used and delta is its length in seconds
+  // appends the step to the log
+  void Write(const InputState &input, float delta);
+
+  // input and delta are where to put the next step's snapshot and length
+  // reads the next step and returns false once the log has run out
+  bool Read(InputState* input, float* delta);
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_INPUT_LOG_H_
@@ -0,0 +1,32 @@
+#ifndef SRC_ENGINE_INPUT_STATE_H_
+#define SRC_ENGINE_INPUT_STATE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <GLFW/glfw3.h>
+#include <cstdint>
+
+// lib
+#include "glm/vec2.hpp"
+
+namespace engine {
+
+// InputState is what every key, mouse button, and gamepad control was doing
+// at the start of a frame, so everything updated in that frame sees the same
+// input whenever it asks and the simulation doesn't need a window to read it
+struct InputState {
+  // 1 if pressed and 0 if not
+  uint8_t keys[GLFW_KEY_LAST + 1];
+  uint8_t mouse_buttons[GLFW_MOUSE_BUTTON_LAST + 1];
+  uint8_t gamepad_buttons[GLFW_GAMEPAD_BUTTON_LAST + 1];
+  float gamepad_axes[GLFW_GAMEPAD_AXIS_LAST + 1];
+  // cursor_offset is how far the cursor moved since the last frame in pixels
+  glm::vec2 cursor_offset;
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_INPUT_STATE_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/job_system.h"
+
+namespace engine {
+
+// the job system a worker thread belongs to and the queue it owns
+static thread_local const JobSystem* current_system = nullptr;
+static thread_local int current_queue = 0;
+
+// returns the queue of the calling thread, threads that aren't workers of
+// this use queue 0
+int JobSystem::CurrentQueue() const {
+  return current_system == this ? current_queue : 0;
+}
+
+// queue is a queue in this and job is where to put what was found
+// takes the newest job in queue or the oldest one in any other queue and
+// returns whether there was one
+bool JobSystem::Take(int queue, Job* job) {
+  if (pending.load() == 0) {
+    return false;
+  }
+  for (int i = 0; i < queues.size(); i++) {
+    WorkQueue* from = queues[(queue + i) % queues.size()];
+    std::lock_guard<std::mutex> guard(from->lock);
+    if (!from->jobs.empty()) {
+      if (i == 0) {
+        *job = std::move(from->jobs.back());
+        from->jobs.pop_back();
+      } else {
+        *job = std::move(from->jobs.front());
+        from->jobs.pop_front();
+      }
+      pending--;
+      return true;
+    }
+  }
+  return false;
+}
+
+// queue is the calling thread's queue
+// runs one job if there is any and returns whether it did
+bool JobSystem::RunOne(int queue) {
+  Job job;
+  if (!Take(queue, &job)) {
+    return false;
+  }
+  job.work();
+  job.counter->fetch_sub(1);
+  return true;
+}
+
+// queue is the worker's queue
+// runs jobs until this is destroyed
+void JobSystem::WorkerLoop(int queue) {
+  current_system = this;
+  current_queue = queue;
+  while (running.load()) {
+    if (!RunOne(queue)) {
+      std::unique_lock<std::mutex> guard(sleep_lock);
+      wake.wait(guard, [this] {
+        return !running.load() || pending.load() > 0;
+      });
+    }
+  }
+}
+
+// num_threads is how many threads run jobs, counting the calling thread
+JobSystem::JobSystem(int num_threads) : pending(0), running(true) {
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  for (int i = 0; i < num_threads; i++) {
+    queues.push_back(new WorkQueue());
+  }
+  for (int i = 1; i < num_threads; i++) {
+    workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+  }
+}
+
+// waits for the workers to finish their current jobs and stops them
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> guard(sleep_lock);
+    running = false;
+  }
+  wake.notify_all();
+  for (int i = 0; i < workers.size(); i++) {
+    workers[i].join();
+  }
+  for (int i = 0; i < queues.size(); i++) {
+    delete queues[i];
+  }
+}
+
+// work is a job and counter is the counter of the group it is in
+// adds 1 to counter and queues work on the calling thread, counter goes
+// back down when work finishes, work must not throw
+void JobSystem::Run(std::function<void()> work, JobCounter* counter) {
+  counter->fetch_add(1);
+  {
+    // taking the lock makes sure a worker about to sleep sees the new job
+    std::lock_guard<std::mutex> guard(sleep_lock);
+    pending++;
+  }
+  WorkQueue* queue = queues[CurrentQueue()];
+  {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    queue->jobs.push_back({std::move(work), counter});
+  }
+  wake.notify_one();
+}
+
+// counter is a group's counter
+// runs queued jobs until every job in the group has finished
+void JobSystem::Wait(JobCounter* counter) {
+  int queue = CurrentQueue();
+  while (counter->load() > 0) {
+    if (!RunOne(queue)) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// count is how many items there are, grain is how many items a job
+// covers, and body is called with the start and end of each job's range
+// splits 0 to count into ranges of grain items, runs body on every range
+// across the threads, and returns once they are all done, if body throws
+// the exception from the earliest range that threw is rethrown then
+void JobSystem::ParallelFor(int count, int grain,
+                            const std::function<void(int, int)> &body) {
+  if (grain < 1) {
+    grain = 1;
+  }
+  JobCounter counter(0);
+  // jobs can't throw, so a range's exception is kept until every job that
+  // points at counter is done, the earliest one wins however the threads
+  // were scheduled
+  std::mutex error_lock;
+  std::exception_ptr error;
+  int error_begin = count;
+  for (int begin = 0; begin < count; begin += grain) {
+    int end = std::min(begin + grain, count);
+    Run([&, begin, end] {
+      try {
+        body(begin, end);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_lock);
+        if (begin < error_begin) {
+          error = std::current_exception();
+          error_begin = begin;
+        }
+      }
+    }, &counter);
+  }
+  Wait(&counter);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace engine
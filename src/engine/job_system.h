@@ -0,0 +1,102 @@
+#ifndef SRC_ENGINE_JOB_SYSTEM_H_
+#define SRC_ENGINE_JOB_SYSTEM_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+// JobCounter is how many jobs in a group haven't finished yet, a group is
+// done when it reaches 0
+typedef std::atomic<int> JobCounter;
+
+// JobSystem runs jobs on a pool of threads. Every thread has its own queue,
+// it takes the newest job from its own queue and when that is empty steals
+// the oldest job from another thread's, so big batches queued by one thread
+// spread out over all of them. The thread that made the system counts as
+// thread 0 and only runs jobs while it waits for them.
+class JobSystem {
+ private:
+  // Job is some work and the counter of the group it is in
+  struct Job {
+    std::function<void()> work;
+    JobCounter* counter;
+  };
+
+  // WorkQueue is one thread's jobs
+  struct WorkQueue {
+    std::mutex lock;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<WorkQueue*> queues;
+  std::vector<std::thread> workers;
+  // pending is how many jobs are queued, idle workers sleep on wake until
+  // there are some
+  std::atomic<int> pending;
+  std::atomic<bool> running;
+  std::mutex sleep_lock;
+  std::condition_variable wake;
+
+  // returns the queue of the calling thread, threads that aren't workers of
+  // this use queue 0
+  int CurrentQueue() const;
+
+  // queue is a queue in this and job is where to put what was found
+  // takes the newest job in queue or the oldest one in any other queue and
+  // returns whether there was one
+  bool Take(int queue, Job* job);
+
+  // queue is the calling thread's queue
+  // runs one job if there is any and returns whether it did
+  bool RunOne(int queue);
+
+  // queue is the worker's queue
+  // runs jobs until this is destroyed
+  void WorkerLoop(int queue);
+
+ public:
+  // Constructor
+  // num_threads is how many threads run jobs, counting the calling thread
+  explicit JobSystem(int num_threads);
+
+  // Deconstructor
+  // waits for the workers to finish their current jobs and stops them
+  ~JobSystem();
+
+  // returns how many threads run jobs, counting the one that made this
+  int GetNumThreads() const {return queues.size();}
+
+  // work is a job and counter is the counter of the group it is in
+  // adds 1 to counter and queues work on the calling thread, counter goes
+  // back down when work finishes, work must not throw
+  void Run(std::function<void()> work, JobCounter* counter);
+
+  // counter is a group's counter
+  // runs queued jobs until every job in the group has finished
+  void Wait(JobCounter* counter);
+
+  // count is how many items there are, grain is how many items a job
+  // covers, and body is called with the start and end of each job's range
+  // splits 0 to count into ranges of grain items, runs body on every range
+  // across the threads, and returns once they are all done, if body throws
+  // the exception from the earliest range that threw is rethrown then
+  void ParallelFor(int count, int grain,
+                   const std::function<void(int, int)> &body);
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_JOB_SYSTEM_H_
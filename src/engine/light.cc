@@ -20,7 +20,9 @@ bool Light::used_lights[] = {false, false, false, false,
 // respectively, Position set to the origin, Spot direction set down the
 // negative z axis, light is active, or 'on'.
 void Light::SetDefaults(float r, float g, float b) {
-  light = NextAvailableLight();
+  // without a context there are no lights to take, so none of the setters
+  // touch OpenGL
+  light = Headless() ? -1 : NextAvailableLight();
   GLfloat ambient[] = {0.0f, 0.0f, 0.0f, 1.0f};
   SetPosition(glm::vec3(0.0f, 0.0f, 0.0f));
   GameObject::SetOrientation(0.0f, glm::vec3(0.0f, 0.0f, -1.0f), false);
@@ -51,7 +53,9 @@ int Light::NextAvailableLight() {
 // Calls SetDefaults with white
 Light::Light() {
   SetDefaults(1.0f, 1.0f, 1.0f);
-  glEnable(GL_LIGHTING);
+  if (!Headless()) {
+    glEnable(GL_LIGHTING);
+  }
   tags.push_back("light");
 }
 
@@ -60,7 +64,9 @@ Light::Light() {
 // calls SetDefaults with the color
 Light::Light(float r, float g, float b) {
   SetDefaults(r, g, b);
-  glEnable(GL_LIGHTING);
+  if (!Headless()) {
+    glEnable(GL_LIGHTING);
+  }
   tags.push_back("light");
 }
 
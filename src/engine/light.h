@@ -8,6 +8,7 @@
 #include <string>
 #include "engine/game_object.h"
 #include "engine/constants.h"
+#include "engine/headless.h"
 #include "glm/gtx/quaternion.hpp"
 #include "glm/vec3.hpp"
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/mapped_file.h"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine {
+
+// Default Constructor
+MappedFile::MappedFile() {
+  data = nullptr;
+  size = 0;
+  is_open = false;
+}
+
+// file_name is a path to a file
+// maps file_name into memory
+MappedFile::MappedFile(const std::string &file_name) {
+  data = nullptr;
+  size = 0;
+  is_open = false;
+  Open(file_name);
+}
+
+// file_name is a path to a file
+// maps file_name into memory and returns whether it was successful
+bool MappedFile::Open(const std::string &file_name) {
+  Close();
+#ifdef _WIN32
+  std::ifstream file(file_name, std::ios::in | std::ios::binary);
+  if (file.is_open()) {
+    file.seekg(0, std::ios::end);
+    buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(buffer.data(), buffer.size());
+    data = buffer.data();
+    size = buffer.size();
+    is_open = true;
+  }
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd != -1) {
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+      size = info.st_size;
+      if (size == 0) {
+        // mmap can't map an empty file, but an empty file is still open
+        is_open = true;
+      } else {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+          madvise(mapping, size, MADV_SEQUENTIAL);
+          data = static_cast<const char*>(mapping);
+          is_open = true;
+        } else {
+          size = 0;
+        }
+      }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+  }
+#endif
+  return is_open;
+}
+
+// unmaps the file if one is open
+void MappedFile::Close() {
+#ifdef _WIN32
+  std::vector<char>().swap(buffer);
+#else
+  if (data != nullptr) {
+    munmap(const_cast<char*>(data), size);
+  }
+#endif
+  data = nullptr;
+  size = 0;
+  is_open = false;
+}
+
+// Deconstructor
+// unmaps the file
+MappedFile::~MappedFile() {
+  Close();
+}
+
+}  // namespace engine
@@ -0,0 +1,64 @@
+#ifndef SRC_ENGINE_MAPPED_FILE_H_
+#define SRC_ENGINE_MAPPED_FILE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace engine {
+
+// MappedFile gives read only access to the bytes of a file without copying
+// them. On POSIX systems the file is memory mapped, everywhere else it is read
+// into a buffer once.
+class MappedFile {
+ private:
+  const char* data;
+  size_t size;
+  bool is_open;
+
+  // buffer holds the file contents when memory mapping isn't available
+  std::vector<char> buffer;
+
+ public:
+  // Default Constructor
+  MappedFile();
+
+  // file_name is a path to a file
+  // maps file_name into memory
+  explicit MappedFile(const std::string &file_name);
+
+  // file_name is a path to a file
+  // maps file_name into memory and returns whether it was successful
+  bool Open(const std::string &file_name);
+
+  // unmaps the file if one is open
+  void Close();
+
+  // returns whether a file is mapped
+  bool IsOpen() const {return is_open;}
+
+  // returns a pointer to the first byte of the file
+  const char* Data() const {return data;}
+
+  // returns the number of bytes in the file
+  size_t Size() const {return size;}
+
+  // Deconstructor
+  // unmaps the file
+  ~MappedFile();
+
+  // delete the copy constructor
+  MappedFile(const MappedFile& file) = delete;
+
+  // delete the assignment operator
+  MappedFile& operator=(const MappedFile& file) = delete;
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_MAPPED_FILE_H_
@@ -3,6 +3,7 @@
  */
 
 #include "engine/material.h"
+#include "engine/asset_registry.h"
 
 namespace engine {
 
@@ -13,8 +14,6 @@ Material::Material() {
   SetSpecular(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
   SetEmission(glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
   SetShininess(0.0f);
-  tex_name[0] = -1;
-  image_width = image_height = 0;
 }
 
 // Constructor
@@ -25,12 +24,13 @@ Material::Material(glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular,
   SetSpecular(specular);
   SetEmission(glm::vec3(0.0f, 0.0f, 0.0f));
   SetShininess(shininess);
-  tex_name[0] = -1;
-  image_width = image_height = 0;
 }
 
 // sets this material to the current drawing material
 void Material::Activate() const {
+  if (Headless()) {
+    return;
+  }
   // Textures
   glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambient);
   glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, diffuse);
@@ -47,12 +47,24 @@ void Material::Activate() const {
 
 // returns the tex_name[0]
 GLuint Material::GetTexName() const {
-  return tex_name[0];
+  return texture ? texture->GetTexName() : -1;
 }
 
 // returns the width/height
 float Material::GetRatio() const {
-  return image_width/image_height;
+  return texture ? texture->GetRatio() : 0.0f;
+}
+
+// returns the plain data that describes this material
+MaterialRecord Material::GetRecord() const {
+  MaterialRecord record;
+  std::copy(ambient, ambient+AMBIENT_SIZE, record.ambient);
+  std::copy(diffuse, diffuse+DIFFUSE_SIZE, record.diffuse);
+  std::copy(specular, specular+SPECULAR_SIZE, record.specular);
+  std::copy(emission, emission+EMISSION_SIZE, record.emission);
+  record.shininess = shininess;
+  record.texture_file = texture ? texture->GetFile() : "";
+  return record;
 }
 
 // Setters
@@ -128,40 +140,117 @@ void Material::SetShininess(float shininess) {
 // filename is a string
 // loads the ppm file into texture
 void Material::SetTexture(std::string filename) {
-  float d;
-  std::string ext = filename.substr(filename.find_last_of(".") + 1);
-  if (ext == "ppm" || ext == "pam") {
-    if (ext == "ppm") {
-      image = LoadPPM(filename, &image_width, &image_height);
-    } else {
-      image = LoadPAM(filename, &image_width, &image_height, &d);
-    }
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  std::shared_ptr<Texture> loaded(new Texture());
+  if (loaded->Load(filename)) {
+    texture = loaded;
+  }
+}
 
-    glGenTextures(1, tex_name);
-    glBindTexture(GL_TEXTURE_2D, tex_name[0]);
+// texture is a loaded texture
+// sets this material to draw with texture
+void Material::SetTexture(TextureHandle texture) {
+  this->texture = texture;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    // float colors[4] = {0, 0, 0, 0};
-    // glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_BLEND);
-    // glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, colors);
+// record describes a material and assets may be null
+// sets this material to match record and loads its texture if it has one,
+// through assets when it is given
+void Material::SetRecord(const MaterialRecord &record, AssetRegistry* assets) {
+  std::copy(record.ambient, record.ambient+AMBIENT_SIZE, ambient);
+  std::copy(record.diffuse, record.diffuse+DIFFUSE_SIZE, diffuse);
+  std::copy(record.specular, record.specular+SPECULAR_SIZE, specular);
+  std::copy(record.emission, record.emission+EMISSION_SIZE, emission);
+  shininess = record.shininess;
+  if (record.texture_file != "") {
+    if (assets != nullptr) {
+      SetTexture(assets->GetTexture(record.texture_file));
+    } else {
+      SetTexture(record.texture_file);
+    }
+  }
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_width, image_height, 0,
-      GL_RGBA, GL_UNSIGNED_BYTE, image.data());
-  } else {
-    std::cout << "Only PPM and PAM files are supported, you gave a " << ext <<
-    " file." << std::endl;
+// tokens is a material line with a keyword followed by 3 floats
+// returns the color described by tokens and throws an exception if it's not
+// formatted correctly
+glm::vec3 ParseColor(const std::vector<Token> &tokens) {
+  glm::vec3 color;
+  if (tokens.size() < NUM_COLOR_TOKENS ||
+      !ParseFloat(tokens[1], &color.r) ||
+      !ParseFloat(tokens[2], &color.g) ||
+      !ParseFloat(tokens[3], &color.b)) {
+    throw tokens[0].ToString() + " takes 3 arguements, " +
+          std::to_string(tokens.size()-1) + " were given.";
   }
+  return color;
 }
 
-// Deconstructor
-// Free texture
-Material::~Material() {
-  glDeleteTextures(1, tex_name);
+// mat_file is the path to a .mtl file and assets may be null
+// adds all materials described in mat_file to materials, loading textures
+// through assets when it is given, and throws a string exception if the file
+// isn't formatted correctly
+void LoadMaterialLibrary(const std::string &mat_file,
+                         MaterialLibrary* materials,
+                         AssetRegistry* assets) {
+  std::string mat_name = "";
+  MappedFile file(mat_file);
+  if (file.IsOpen()) {
+    try {
+      std::vector<Token> tokens;
+      const char* line = file.Data();
+      const char* file_end = file.Data() + file.Size();
+      while (line < file_end) {
+        const char* line_end = static_cast<const char*>(
+          memchr(line, '\n', file_end-line));
+        if (line_end == nullptr) {
+          line_end = file_end;
+        }
+        Tokenize(line, line_end, &tokens);
+        line = line_end + 1;
+        if (tokens.size() > 0) {
+          if (tokens[0] == "newmtl") {
+            if (tokens.size() < 2) {
+              throw std::string("new materials must have a name");
+            }
+            mat_name = tokens[1].ToString();
+            materials->insert({mat_name, Material()});
+          } else if (mat_name != "") {
+          if (tokens[0] == "Ka") {
+            materials->at(mat_name).SetAmbient(ParseColor(tokens));
+          } else if (tokens[0] == "Kd") {
+            materials->at(mat_name).SetDiffuse(ParseColor(tokens));
+          } else if (tokens[0] == "Ks") {
+            materials->at(mat_name).SetSpecular(ParseColor(tokens));
+          } else if (tokens[0] == "Ke") {
+            materials->at(mat_name).SetEmission(ParseColor(tokens));
+          } else if (tokens[0] == "Ns") {
+            float shininess;
+            if (tokens.size() < 2 || !ParseFloat(tokens[1], &shininess)) {
+              throw "Ns takes 1 arguement, " + std::to_string(tokens.size()-1)
+                    + " were given.";
+            }
+            materials->at(mat_name).SetShininess(shininess);
+          } else if (tokens[0] == "map_Ka") {
+            if (tokens.size() == 2) {
+              std::string texture_file = "data/" + tokens[1].ToString();
+              if (assets != nullptr) {
+                materials->at(mat_name).SetTexture(
+                  assets->GetTexture(texture_file));
+              } else {
+                materials->at(mat_name).SetTexture(texture_file);
+              }
+            } else {
+              throw "map_Ka takes 1 arguement, " +
+                    std::to_string(tokens.size()-1) + "were given.";
+            }
+          }
+          }
+        }
+      }
+    } catch (const std::string msg) {
+      throw "Material Library Error: " + msg;
+    }
+  }
 }
 
 }  // namespace engine
@@ -7,12 +7,18 @@
 
 // C/C++ lib
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 // src
 #include "engine/constants.h"
 #include "engine/helper.h"
+#include "engine/mapped_file.h"
+#include "engine/texture.h"
 
 // lib
 #include "glm/vec3.hpp"
@@ -20,6 +26,19 @@
 
 namespace engine {
 
+class AssetRegistry;
+
+// MaterialRecord is the plain data that describes a material so it can be
+// stored in a cooked mesh
+struct MaterialRecord {
+  float ambient[AMBIENT_SIZE];
+  float diffuse[DIFFUSE_SIZE];
+  float specular[SPECULAR_SIZE];
+  float emission[EMISSION_SIZE];
+  float shininess;
+  std::string texture_file;
+};
+
 class Material {
  private:
   float ambient[AMBIENT_SIZE];
@@ -28,9 +47,8 @@ class Material {
   float emission[EMISSION_SIZE];
   float shininess;
 
-  GLuint tex_name[1];
-  std::vector<GLubyte> image;
-  float image_width, image_height;
+  // texture is shared with every other material using the same image
+  TextureHandle texture;
 
  public:
   // Default Constructor
@@ -50,6 +68,9 @@ class Material {
   // returns the width/height
   float GetRatio() const;
 
+  // returns the plain data that describes this material
+  MaterialRecord GetRecord() const;
+
   // Setters
   // ambient is an rgba color
   void SetAmbient(glm::vec3 ambient);
@@ -82,11 +103,32 @@ class Material {
   // loads the ppm file into texture
   void SetTexture(std::string filename);
 
-  // Deconstructor
-  // Free texture
-  ~Material();
+  // texture is a loaded texture
+  // sets this material to draw with texture
+  void SetTexture(TextureHandle texture);
+
+  // record describes a material and assets may be null
+  // sets this material to match record and loads its texture if it has one,
+  // through assets when it is given
+  void SetRecord(const MaterialRecord &record, AssetRegistry* assets = nullptr);
 };
 
+// MaterialLibrary matches material names to materials
+typedef std::map<std::string, Material> MaterialLibrary;
+
+// tokens is a material line with a keyword followed by 3 floats
+// returns the color described by tokens and throws an exception if it's not
+// formatted correctly
+glm::vec3 ParseColor(const std::vector<Token> &tokens);
+
+// mat_file is the path to a .mtl file and assets may be null
+// adds all materials described in mat_file to materials, loading textures
+// through assets when it is given, and throws a string exception if the file
+// isn't formatted correctly
+void LoadMaterialLibrary(const std::string &mat_file,
+                         MaterialLibrary* materials,
+                         AssetRegistry* assets = nullptr);
+
 }  // namespace engine
 
 #endif  // SRC_ENGINE_MATERIAL_H_
@@ -0,0 +1,314 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/mesh_cache.h"
+
+namespace engine {
+
+// PRIVATE
+
+// bytes and end bound the unread part of a mapped .mesh file
+// copies the next size bytes into value and returns false if the file is too
+// short
+bool CookedMesh::Read(const char** bytes, const char* end, void* value,
+                      size_t size) {
+  if (static_cast<size_t>(end-*bytes) < size) {
+    return false;
+  }
+  memcpy(value, *bytes, size);
+  *bytes += size;
+  return true;
+}
+
+// bytes and end bound the unread part of a mapped .mesh file, count is a
+// number of values read from the file, and size is the size of each
+// returns whether count values fit in the unread part, the product is taken
+// in 64 bits so a corrupt count can't wrap around to a small size
+bool CookedMesh::Fits(const char* bytes, const char* end, uint64_t count,
+                      uint64_t size) {
+  return count * size <= static_cast<uint64_t>(end-bytes);
+}
+
+// bytes and end bound the unread part of a mapped .mesh file
+// reads a length prefixed string into value and returns false if the file is
+// too short
+bool CookedMesh::Read(const char** bytes, const char* end,
+                      std::string* value) {
+  uint32_t length;
+  if (!Read(bytes, end, &length, sizeof(length)) ||
+      static_cast<size_t>(end-*bytes) < length) {
+    return false;
+  }
+  value->assign(*bytes, length);
+  *bytes += length;
+  return true;
+}
+
+// file is an open binary stream
+// writes the size bytes at value
+void CookedMesh::Write(std::ofstream* file, const void* value, size_t size) {
+  file->write(static_cast<const char*>(value), size);
+}
+
+// file is an open binary stream
+// writes value as a length prefixed string
+void CookedMesh::Write(std::ofstream* file, const std::string &value) {
+  uint32_t length = value.size();
+  Write(file, &length, sizeof(length));
+  Write(file, value.data(), length);
+}
+
+// PUBLIC
+
+// empties all data
+void CookedMesh::Clear() {
+  vertex_data.clear();
+  normal_data.clear();
+  texture_vertex_data.clear();
+  face_data.clear();
+  materials.clear();
+  sources.clear();
+  bound_min = glm::vec3(0, 0, 0);
+  bound_max = glm::vec3(0, 0, 0);
+}
+
+// returns the number of vertices
+int CookedMesh::GetNumVertices() const {
+  return vertex_data.size()/VERTEX_SIZE;
+}
+
+// path is a file the mesh was built from
+// adds path and its current size, time, and hash to sources
+bool CookedMesh::AddSource(const std::string &path) {
+  MeshSource source;
+  source.path = path;
+  bool rv = GetMeshSource(path, &source);
+  if (rv) {
+    sources.push_back(source);
+  }
+  return rv;
+}
+
+// returns true if every source still matches the file on disk
+// a source with a new modified time but the same hash is still current, its
+// time is updated and touched is set to true so the file can be rewritten
+bool CookedMesh::IsCurrent(bool* touched) {
+  *touched = false;
+  bool rv = true;
+  for (int i = 0; i < sources.size() && rv; i++) {
+    rv = IsSourceCurrent(&sources[i], touched);
+  }
+  return rv;
+}
+
+// file_name is a path to a .mesh file
+// maps the file and fills this with its data, returns false and leaves this
+// empty if the file is missing, from another version, truncated, or has a
+// count larger than the file or an index past the last vertex
+bool CookedMesh::Read(const std::string &file_name) {
+  Clear();
+  MappedFile file(file_name);
+  if (!file.IsOpen()) {
+    return false;
+  }
+  const char* bytes = file.Data();
+  const char* end = file.Data() + file.Size();
+  uint32_t magic, version, count;
+  bool rv = Read(&bytes, end, &magic, sizeof(magic)) &&
+            Read(&bytes, end, &version, sizeof(version)) &&
+            magic == MESH_CACHE_MAGIC && version == MESH_CACHE_VERSION;
+
+  // Sources
+  rv = rv && Read(&bytes, end, &count, sizeof(count));
+  for (uint32_t i = 0; i < count && rv; i++) {
+    MeshSource source;
+    rv = Read(&bytes, end, &source.path) &&
+         Read(&bytes, end, &source.size, sizeof(source.size)) &&
+         Read(&bytes, end, &source.modified, sizeof(source.modified)) &&
+         Read(&bytes, end, &source.hash, sizeof(source.hash));
+    sources.push_back(source);
+  }
+
+  // Bounds and vertex streams
+  rv = rv && Read(&bytes, end, &bound_min, sizeof(bound_min)) &&
+       Read(&bytes, end, &bound_max, sizeof(bound_max)) &&
+       Read(&bytes, end, &count, sizeof(count)) &&
+       Fits(bytes, end, count, (VERTEX_SIZE + NORMAL_SIZE +
+                                TEXTURE_VERTEX_SIZE) * sizeof(GLfloat));
+  uint32_t num_vertices = count;
+  if (rv) {
+    vertex_data.resize(count*VERTEX_SIZE);
+    normal_data.resize(count*NORMAL_SIZE);
+    texture_vertex_data.resize(count*TEXTURE_VERTEX_SIZE);
+    rv = Read(&bytes, end, vertex_data.data(),
+              vertex_data.size()*sizeof(GLfloat)) &&
+         Read(&bytes, end, normal_data.data(),
+              normal_data.size()*sizeof(GLfloat)) &&
+         Read(&bytes, end, texture_vertex_data.data(),
+              texture_vertex_data.size()*sizeof(GLfloat));
+  }
+
+  // Materials
+  rv = rv && Read(&bytes, end, &count, sizeof(count));
+  for (uint32_t i = 0; i < count && rv; i++) {
+    std::string name;
+    MaterialRecord record;
+    rv = Read(&bytes, end, &name) &&
+         Read(&bytes, end, record.ambient, sizeof(record.ambient)) &&
+         Read(&bytes, end, record.diffuse, sizeof(record.diffuse)) &&
+         Read(&bytes, end, record.specular, sizeof(record.specular)) &&
+         Read(&bytes, end, record.emission, sizeof(record.emission)) &&
+         Read(&bytes, end, &record.shininess, sizeof(record.shininess)) &&
+         Read(&bytes, end, &record.texture_file);
+    materials[name] = record;
+  }
+
+  // Faces
+  rv = rv && Read(&bytes, end, &count, sizeof(count));
+  for (uint32_t i = 0; i < count && rv; i++) {
+    std::string name;
+    uint32_t num_indices;
+    rv = Read(&bytes, end, &name) &&
+         Read(&bytes, end, &num_indices, sizeof(num_indices)) &&
+         Fits(bytes, end, num_indices, sizeof(GLuint));
+    if (rv) {
+      std::vector<GLuint> &indices = face_data[name];
+      indices.resize(num_indices);
+      rv = Read(&bytes, end, indices.data(), num_indices*sizeof(GLuint));
+      // every index has to name a vertex or drawing reads past the buffers
+      for (uint32_t j = 0; j < num_indices && rv; j++) {
+        rv = indices[j] < num_vertices;
+      }
+    }
+  }
+
+  if (!rv) {
+    Clear();
+  }
+  return rv;
+}
+
+// file_name is a path to a .mesh file
+// writes this to file_name and returns whether it was successful
+bool CookedMesh::Write(const std::string &file_name) const {
+  // write to a temporary file first so a half written cache is never read
+  std::string temp_name = file_name + ".tmp";
+  std::ofstream file(temp_name, std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  uint32_t magic = MESH_CACHE_MAGIC;
+  uint32_t version = MESH_CACHE_VERSION;
+  Write(&file, &magic, sizeof(magic));
+  Write(&file, &version, sizeof(version));
+
+  // Sources
+  uint32_t count = sources.size();
+  Write(&file, &count, sizeof(count));
+  for (auto const& source : sources) {
+    Write(&file, source.path);
+    Write(&file, &source.size, sizeof(source.size));
+    Write(&file, &source.modified, sizeof(source.modified));
+    Write(&file, &source.hash, sizeof(source.hash));
+  }
+
+  // Bounds and vertex streams
+  count = GetNumVertices();
+  Write(&file, &bound_min, sizeof(bound_min));
+  Write(&file, &bound_max, sizeof(bound_max));
+  Write(&file, &count, sizeof(count));
+  Write(&file, vertex_data.data(), vertex_data.size()*sizeof(GLfloat));
+  Write(&file, normal_data.data(), normal_data.size()*sizeof(GLfloat));
+  Write(&file, texture_vertex_data.data(),
+        texture_vertex_data.size()*sizeof(GLfloat));
+
+  // Materials
+  count = materials.size();
+  Write(&file, &count, sizeof(count));
+  for (auto const& mat : materials) {
+    Write(&file, mat.first);
+    Write(&file, mat.second.ambient, sizeof(mat.second.ambient));
+    Write(&file, mat.second.diffuse, sizeof(mat.second.diffuse));
+    Write(&file, mat.second.specular, sizeof(mat.second.specular));
+    Write(&file, mat.second.emission, sizeof(mat.second.emission));
+    Write(&file, &mat.second.shininess, sizeof(mat.second.shininess));
+    Write(&file, mat.second.texture_file);
+  }
+
+  // Faces
+  count = face_data.size();
+  Write(&file, &count, sizeof(count));
+  for (auto const& faces : face_data) {
+    uint32_t num_indices = faces.second.size();
+    Write(&file, faces.first);
+    Write(&file, &num_indices, sizeof(num_indices));
+    Write(&file, faces.second.data(), num_indices*sizeof(GLuint));
+  }
+
+  bool rv = file.good();
+  file.close();
+  if (rv) {
+    std::remove(file_name.c_str());
+    rv = (std::rename(temp_name.c_str(), file_name.c_str()) == 0);
+  }
+  if (!rv) {
+    std::remove(temp_name.c_str());
+  }
+  return rv;
+}
+
+// obj_file_name is a path to a .obj file
+// returns the path of the .mesh file it is cooked to
+std::string MeshCachePath(const std::string &obj_file_name) {
+  size_t dot = obj_file_name.find_last_of('.');
+  size_t slash = obj_file_name.find_last_of("/\\");
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash)) {
+    return obj_file_name + MESH_CACHE_EXTENSION;
+  }
+  return obj_file_name.substr(0, dot) + MESH_CACHE_EXTENSION;
+}
+
+// path is a path to a file and source is the MeshSource to fill
+// sets the size, modified time, and hash of source and returns false if the
+// file can't be read
+bool GetMeshSource(const std::string &path, MeshSource* source) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    return false;
+  }
+  MappedFile file(path);
+  if (!file.IsOpen()) {
+    return false;
+  }
+  source->size = file.Size();
+  source->modified = info.st_mtime;
+  source->hash = HashBytes(file.Data(), file.Size());
+  return true;
+}
+
+// source is a file a cache was built from
+// returns true if source still matches the file on disk, a source with a new
+// modified time but the same hash is still current, its time is updated and
+// touched is set to true
+bool IsSourceCurrent(MeshSource* source, bool* touched) {
+  struct stat info;
+  bool rv = true;
+  if (stat(source->path.c_str(), &info) != 0 ||
+      static_cast<uint64_t>(info.st_size) != source->size) {
+    rv = false;
+  } else if (static_cast<int64_t>(info.st_mtime) != source->modified) {
+    // the file was touched, only rebuild if its contents changed
+    MeshSource current;
+    current.path = source->path;
+    rv = GetMeshSource(current.path, &current) && current.hash == source->hash;
+    if (rv) {
+      *source = current;
+      *touched = true;
+    }
+  }
+  return rv;
+}
+
+}  // namespace engine
@@ -0,0 +1,130 @@
+#ifndef SRC_ENGINE_MESH_CACHE_H_
+#define SRC_ENGINE_MESH_CACHE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <GLFW/glfw3.h>
+#include <sys/stat.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+// lib
+#include "glm/vec3.hpp"
+// src
+#include "engine/constants.h"
+#include "engine/helper.h"
+#include "engine/mapped_file.h"
+#include "engine/material.h"
+
+namespace engine {
+
+// MeshSource is a file a cooked mesh was built from
+struct MeshSource {
+  std::string path;
+  uint64_t size;
+  int64_t modified;
+  uint64_t hash;
+};
+
+// CookedMesh holds a model in the expanded form it is drawn in, one vertex,
+// normal, and texture vertex per face attribute and a list of indices per
+// material. It can be written to and read from a binary .mesh file so later
+// runs don't have to parse the .obj again.
+//
+// A .mesh file is laid out as:
+//   uint32 magic, uint32 version
+//   uint32 number of sources, then for each: string path, uint64 size,
+//     int64 modified time, uint64 FNV-1a hash
+//   float[3] bound_min, float[3] bound_max
+//   uint32 number of vertices, then vertex_data, normal_data, and
+//     texture_vertex_data
+//   uint32 number of materials, then for each: string name, float[4] ambient,
+//     diffuse, specular, and emission, float shininess, string texture file
+//   uint32 number of face groups, then for each: string material name,
+//     uint32 number of indices, GLuint indices
+// where a string is a uint32 length followed by its characters
+class CookedMesh {
+  // the texture cache is read and written with the same helpers
+  friend class CookedTexture;
+
+ private:
+  // bytes and end bound the unread part of a mapped .mesh file
+  // these copy the next value out and return false if the file is too short
+  static bool Read(const char** bytes, const char* end, void* value,
+                   size_t size);
+  static bool Read(const char** bytes, const char* end, std::string* value);
+
+  // bytes and end bound the unread part of a mapped .mesh file, count is a
+  // number of values read from the file, and size is the size of each
+  // returns whether count values fit in the unread part, the product is taken
+  // in 64 bits so a corrupt count can't wrap around to a small size
+  static bool Fits(const char* bytes, const char* end, uint64_t count,
+                   uint64_t size);
+
+  // file is an open binary stream
+  // these write value in the layout Read expects
+  static void Write(std::ofstream* file, const void* value, size_t size);
+  static void Write(std::ofstream* file, const std::string &value);
+
+ public:
+  std::vector<GLfloat> vertex_data;
+  std::vector<GLfloat> normal_data;
+  std::vector<GLfloat> texture_vertex_data;
+  std::map<std::string, std::vector<GLuint>> face_data;
+  std::map<std::string, MaterialRecord> materials;
+  std::vector<MeshSource> sources;
+  glm::vec3 bound_min;
+  glm::vec3 bound_max;
+
+  // empties all data
+  void Clear();
+
+  // returns the number of vertices
+  int GetNumVertices() const;
+
+  // path is a file the mesh was built from
+  // adds path and its current size, time, and hash to sources
+  bool AddSource(const std::string &path);
+
+  // returns true if every source still matches the file on disk
+  // a source with a new modified time but the same hash is still current,
+  // its time is updated and touched is set to true so the file can be
+  // rewritten
+  bool IsCurrent(bool* touched);
+
+  // file_name is a path to a .mesh file
+  // maps the file and fills this with its data, returns false and leaves this
+  // empty if the file is missing, from another version, truncated, or has a
+  // count larger than the file or an index past the last vertex
+  bool Read(const std::string &file_name);
+
+  // file_name is a path to a .mesh file
+  // writes this to file_name and returns whether it was successful
+  bool Write(const std::string &file_name) const;
+};
+
+// obj_file_name is a path to a .obj file
+// returns the path of the .mesh file it is cooked to
+std::string MeshCachePath(const std::string &obj_file_name);
+
+// path is a path to a file and source is the MeshSource to fill
+// sets the size, modified time, and hash of source and returns false if the
+// file can't be read
+bool GetMeshSource(const std::string &path, MeshSource* source);
+
+// source is a file a cache was built from
+// returns true if source still matches the file on disk, a source with a new
+// modified time but the same hash is still current, its time is updated and
+// touched is set to true
+bool IsSourceCurrent(MeshSource* source, bool* touched);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_MESH_CACHE_H_
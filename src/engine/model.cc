@@ -3,6 +3,7 @@
  */
 
 #include "engine/model.h"
+#include "engine/asset_registry.h"
 
 namespace engine {
 
@@ -10,17 +11,16 @@ namespace engine {
 
 // vertex is a line that starts with v and contains vertex data
 // Adds the vertex described in vertex
-void Model::AddVertex(std::vector<std::string> vertex) {
+void Model::AddVertex(const std::vector<Token> &vertex) {
   glm::vec4 v;
   if (vertex.size() == NUM_VERTEX_TOKENS
       || vertex.size() == NUM_VERTEX_TOKENS-1) {
     // vertex is formatted correctly
     for (int i = 1; i < vertex.size(); i++) {
       // Convert and check if vertex[i] is a valid float
-      try {
-        v[i-1] = std::stof(vertex[i]);
-      } catch (std::exception& e) {
-        throw "Invalid Vertex Definition: '" + vertex[i] + "' is not a float";
+      if (!ParseFloat(vertex[i], &v[i-1])) {
+        throw "Invalid Vertex Definition: '" + vertex[i].ToString() +
+              "' is not a float";
       }
     }
     if (vertex.size() == NUM_VERTEX_TOKENS-1) {
@@ -45,17 +45,17 @@ void Model::AddVertex(std::vector<std::string> vertex) {
 // texture vertex starts with vt and is the definition of a texture vertex
 // adds the specified texture vertex to the texture_vertices and throw a
 // string exception if the line is defined incorrectly
-void Model::AddTextureVertex(std::vector<std::string> texture_vertex) {
+void Model::AddTextureVertex(const std::vector<Token> &texture_vertex) {
   // ASSERT: texture_vertex[1] is the u coordinate and ..[2] is the v coord
   if (texture_vertex.size() == NUM_TEXTURE_VERTEX_TOKENS) {
-    try {
-      glm::vec2 texture_vert;
-      texture_vert.x = std::stof(texture_vertex[1]);  // u coord
-      texture_vert.y = std::stof(texture_vertex[2]);  // v coord
+    glm::vec2 texture_vert;
+    if (ParseFloat(texture_vertex[1], &texture_vert.x) &&  // u coord
+        ParseFloat(texture_vertex[2], &texture_vert.y)) {  // v coord
       texture_vertices.push_back(texture_vert);
-    } catch (std::exception& e) {
-      throw "Invalid Texture Vertex Definition: Either " + texture_vertex[1] +
-            " or " + texture_vertex[2] + " is not a float";
+    } else {
+      throw "Invalid Texture Vertex Definition: Either " +
+            texture_vertex[1].ToString() + " or " +
+            texture_vertex[2].ToString() + " is not a float";
     }
   } else {
     throw "Invalid Texture Vertex Definition: A Texture Vertex has " +
@@ -67,70 +67,71 @@ void Model::AddTextureVertex(std::vector<std::string> texture_vertex) {
 // normal is a line that starts with vn and contains normal data
 // adds the normal descibed to normal_vector and returns true iff the data is
 // formatted correctly and returns false otherwise
-void Model::AddNormal(std::vector<std::string> normal) {
-  try {
-    glm::vec3 normal_v3 = {
-      std::stof(normal[1]),
-      std::stof(normal[2]),
-      std::stof(normal[3])
-    };
-
+void Model::AddNormal(const std::vector<Token> &normal) {
+  glm::vec3 normal_v3;
+  if (normal.size() > NORMAL_SIZE &&
+      ParseFloat(normal[1], &normal_v3.x) &&
+      ParseFloat(normal[2], &normal_v3.y) &&
+      ParseFloat(normal[3], &normal_v3.z)) {
     normals.push_back(normal_v3);
-  } catch (std::exception& e) {
-    throw "Invalid Vertex Normal Definition: " + normal[0] + " " + normal[1] +
-          " " + normal[2] + " " + normal[3];
+  } else {
+    std::string line = "";
+    for (int i = 0; i < normal.size(); i++) {
+      line += ((i == 0) ? "" : " ") + normal[i].ToString();
+    }
+    throw "Invalid Vertex Normal Definition: " + line;
   }
 }
 
 // face is a line that starts with f and contains face data
 // Adds the face described in face and throws an exception if it's not formatted
 // correctly
-void Model::AddFace(std::vector<std::string> face) {
+void Model::AddFace(const std::vector<Token> &face) {
   if (face.size() == NUM_FACE_TOKENS) {
     // face is formatted correctly
     glm::vec3 f;
+    std::vector<Token> &tokens = face_tokens;
     for (int i = 1; i < NUM_FACE_TOKENS; i++) {
       // Convert and check if face[i] is a valid int
-      try {
-        std::vector<std::string> tokens = Tokenize(face[i], "/");
-        int num_slash = std::count(face[i].begin(), face[i].end(), '/');
-        int vertex_index = std::stoi(tokens[0])-1;
-        int normal_index;
-        int texture_index;
-        if (tokens.size() == 1) {
-          normal_index = 0;
-          texture_index = 0;
-        } else if (num_slash == 1) {
-          normal_index = 0;
-          texture_index = stoi(tokens[1]);
-        } else {  // num_slash == 2
-          normal_index = std::stoi((tokens.size() == 2)?tokens[1]:tokens[2]);
-          texture_index = std::stoi((tokens.size() == 2)?"0":tokens[1]);
-        }
-        normal_index--;
-        texture_index--;
-        glm::vec3 fa = {vertex_index, texture_index, normal_index};
-        // fa is the face attributes this face uses
-        int index = 0;
-        bool searching = true;
-        while (searching && index < face_attributes.size()) {
-          if (face_attributes[index].x == fa.x &&  // vertex
-              face_attributes[index].y == fa.y &&  // texture vertex
-              face_attributes[index].z == fa.z) {  // normal
-            searching = false;
-          } else {
-            index++;
-          }
-        }
-        int fa_index = index;
-        if (fa_index == face_attributes.size()) {
-          // fa is a new face attribute set
-          face_attributes.push_back(fa);
-        }
-        f[i-1] = fa_index;
-      } catch(std::exception& e) {
-        throw "Invalid Face Definition: '" + face[i] + "' is not made of ints";
+      Tokenize(face[i].data, face[i].data+face[i].size, &tokens, '/');
+      int num_slash = std::count(face[i].data, face[i].data+face[i].size, '/');
+      int vertex_index;
+      int normal_index;
+      int texture_index;
+      bool valid = tokens.size() > 0 && ParseInt(tokens[0], &vertex_index);
+      if (!valid) {
+        // the vertex index is missing or isn't an int
+      } else if (tokens.size() == 1) {
+        normal_index = 0;
+        texture_index = 0;
+      } else if (num_slash == 1) {
+        normal_index = 0;
+        valid = ParseInt(tokens[1], &texture_index);
+      } else if (tokens.size() == 2) {  // num_slash == 2 with no texture
+        texture_index = 0;
+        valid = ParseInt(tokens[1], &normal_index);
+      } else {  // num_slash == 2
+        valid = ParseInt(tokens[2], &normal_index) &&
+                ParseInt(tokens[1], &texture_index);
+      }
+      if (!valid) {
+        throw "Invalid Face Definition: '" + face[i].ToString() +
+              "' is not made of ints";
       }
+      vertex_index--;
+      normal_index--;
+      texture_index--;
+      glm::vec3 fa = {vertex_index, texture_index, normal_index};
+      // fa is the face attributes this face uses
+      FaceAttribute key = {vertex_index, texture_index, normal_index};
+      std::pair<std::unordered_map<FaceAttribute, int,
+        FaceAttributeHash>::iterator, bool> found =
+        face_attribute_indices.insert({key, face_attributes.size()});
+      if (found.second) {
+        // fa is a new face attribute set
+        face_attributes.push_back(fa);
+      }
+      f[i-1] = found.first->second;
     }
     objects[current_material].push_back(f);
     // faces contains the face described
@@ -144,75 +145,12 @@ void Model::AddFace(std::vector<std::string> face) {
 // mat_file is the name of a material library
 // adds all materials described in mat_file to materials
 void Model::AddMaterials(std::string mat_file) {
-  std::string mat_name = "";
-  std::string line = "";
-  std::ifstream file("data/" + mat_file);
-  if (file.is_open()) {
-    try {
-      while (getline(file, line)) {
-        std::vector<std::string> tokens = Tokenize(line);
-        if (tokens.size() > 0) {
-          if (tokens[0] == "newmtl") {
-            try {
-              mat_name = tokens[1];
-              materials.insert({mat_name, Material()});
-            } catch (std::exception& e) {
-              throw "new materials must have a name";
-            }
-          } else if (mat_name != "") {
-          if (tokens[0] == "Ka") {
-            try {
-              materials.at(mat_name).SetAmbient(glm::vec3(std::stof(tokens[1]),
-                             std::stof(tokens[2]), std::stof(tokens[3])));
-            } catch (std::exception& e) {
-              throw "Ka takes 3 arguements, " + std::to_string(tokens.size()-1)
-                    + " were given.";
-            }
-          } else if (tokens[0] == "Kd") {
-            try {
-              materials.at(mat_name).SetDiffuse(glm::vec3(std::stof(tokens[1]),
-                             std::stof(tokens[2]), std::stof(tokens[3])));
-            } catch (std::exception& e) {
-              throw "Kd takes 3 arguements, " + std::to_string(tokens.size()-1)
-                    + " were given.";
-            }
-          } else if (tokens[0] == "Ks") {
-            try {
-              materials.at(mat_name).SetSpecular(glm::vec3(std::stof(tokens[1]),
-                              std::stof(tokens[2]), std::stof(tokens[3])));
-            } catch (std::exception& e) {
-              throw "Ks takes 3 arguements, " + std::to_string(tokens.size()-1)
-                    + " were given.";
-            }
-          } else if (tokens[0] == "Ke") {
-            try {
-              materials.at(mat_name).SetEmission(glm::vec3(std::stof(tokens[1]),
-                              std::stof(tokens[2]), std::stof(tokens[3])));
-            } catch (std::exception& e) {
-              throw "Ke takes 3 arguements, " + std::to_string(tokens.size()-1)
-                    + " were given.";
-            }
-          } else if (tokens[0] == "Ns") {
-            try {
-              materials.at(mat_name).SetShininess(std::stof(tokens[1]));
-            } catch (std::exception& e) {
-              throw "Ns takes 1 arguement, " + std::to_string(tokens.size()-1)
-                    + " were given.";
-            }
-          } else if (tokens[0] == "map_Ka") {
-            if (tokens.size() == 2) {
-              materials.at(mat_name).SetTexture("data/" + tokens[1]);
-            } else {
-              throw "map_Ka takes 1 arguement, " +
-                    std::to_string(tokens.size()-1) + "were given.";
-            }
-          }
-          }
-        }
-      }
-    } catch (const std::string msg) {
-      throw "Material Library Error: " + msg;
-    }
+  if (assets != nullptr) {
+    MaterialLibraryHandle library = assets->GetMaterialLibrary(
+      "data/" + mat_file);
+    materials.insert(library->begin(), library->end());
+  } else {
+    LoadMaterialLibrary("data/" + mat_file, &materials);
   }
 }
 
@@ -223,35 +161,165 @@ void Model::Clear() {
   texture_vertices.clear();
   normals.clear();
   face_attributes.clear();
-  // faces.clear();
+  face_attribute_indices.clear();
+  objects.clear();
+  material_libraries.clear();
+  cooked.Clear();
+}
+
+// fills cooked with the expanded vertex, normal, texture vertex, and face
+// data, call this whenever the verticies, normals, texture vertices, face
+// attributes, or objects change
+void Model::Cook() {
+  int num_vertices = face_attributes.size();
+  cooked.vertex_data.assign(num_vertices * VERTEX_SIZE, 0);
+  cooked.normal_data.assign(num_vertices * NORMAL_SIZE, 0);
+  cooked.texture_vertex_data.assign(num_vertices * TEXTURE_VERTEX_SIZE, 0);
+  for (int i = 0; i < num_vertices; i++) {
+    // indices that are missing (-1) or out of range are left as 0s
+    int v = face_attributes[i].x;
+    int t = face_attributes[i].y;
+    int n = face_attributes[i].z;
+    if (v >= 0 && v < verticies.size()) {
+      for (int j = 0; j < VERTEX_SIZE; j++) {
+        cooked.vertex_data[(i*VERTEX_SIZE)+j] = verticies[v][j];
+      }
+    }
+    if (t >= 0 && t < texture_vertices.size()) {
+      for (int j = 0; j < TEXTURE_VERTEX_SIZE; j++) {
+        cooked.texture_vertex_data[(i*TEXTURE_VERTEX_SIZE)+j] =
+          texture_vertices[t][j];
+      }
+    }
+    if (n >= 0 && n < normals.size()) {
+      for (int j = 0; j < NORMAL_SIZE; j++) {
+        cooked.normal_data[(i*NORMAL_SIZE)+j] = normals[n][j];
+      }
+    }
+  }
+  cooked.face_data.clear();
+  for (auto const& obj : objects) {
+    std::vector<GLuint> &indices = cooked.face_data[obj.first];
+    indices.resize(obj.second.size() * FACE_SIZE);
+    for (int i = 0; i < obj.second.size(); i++) {
+      for (int j = 0; j < FACE_SIZE; j++) {
+        indices[(i*FACE_SIZE)+j] = obj.second[i][j];
+      }
+    }
+  }
+  cooked.bound_min = bound_min;
+  cooked.bound_max = bound_max;
+  BuildBuffers();
+}
+
+// fills interleaved_data, index_data, and draw_ranges from cooked
+void Model::BuildBuffers() {
+  int num_vertices = cooked.GetNumVertices();
+  interleaved_data.resize(num_vertices * INTERLEAVED_SIZE);
+  for (int i = 0; i < num_vertices; i++) {
+    GLfloat* vertex = &interleaved_data[i*INTERLEAVED_SIZE];
+    std::copy(&cooked.vertex_data[i*VERTEX_SIZE],
+              &cooked.vertex_data[i*VERTEX_SIZE] + VERTEX_SIZE, vertex);
+    std::copy(&cooked.normal_data[i*NORMAL_SIZE],
+              &cooked.normal_data[i*NORMAL_SIZE] + NORMAL_SIZE,
+              vertex + VERTEX_SIZE);
+    std::copy(&cooked.texture_vertex_data[i*TEXTURE_VERTEX_SIZE],
+              &cooked.texture_vertex_data[i*TEXTURE_VERTEX_SIZE] +
+              TEXTURE_VERTEX_SIZE, vertex + VERTEX_SIZE + NORMAL_SIZE);
+  }
+  index_data.clear();
+  draw_ranges.clear();
+  for (auto const& faces : cooked.face_data) {
+    DrawRange range = {faces.first, nullptr,
+                       static_cast<GLsizei>(index_data.size()),
+                       static_cast<GLsizei>(faces.second.size())};
+    index_data.insert(index_data.end(), faces.second.begin(),
+                      faces.second.end());
+    draw_ranges.push_back(range);
+  }
+  buffers_dirty = true;
+}
+
+// copies interleaved_data and index_data to the gpu if buffer objects are
+// supported and matches each draw range to its material
+void Model::Upload() const {
+  if (BufferObjectsSupported()) {
+    if (vertex_buffer == 0) {
+      GenBuffers(1, &vertex_buffer);
+      GenBuffers(1, &index_buffer);
+    }
+    BindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    BufferData(GL_ARRAY_BUFFER, interleaved_data.size()*sizeof(GLfloat),
+               interleaved_data.data(), GL_STATIC_DRAW);
+    BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    BufferData(GL_ELEMENT_ARRAY_BUFFER, index_data.size()*sizeof(GLuint),
+               index_data.data(), GL_STATIC_DRAW);
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+  // faces whose material was never defined aren't drawn
+  for (auto & range : draw_ranges) {
+    auto mat = materials.find(range.material_name);
+    range.material = (mat == materials.end()) ? nullptr : &mat->second;
+  }
+  buffers_dirty = false;
+}
+
+// cache_file_name is the path to a .mesh file
+// loads the cooked mesh if it is still current with its sources and returns
+// whether it was used
+bool Model::LoadCache(const std::string &cache_file_name) {
+  bool touched = false;
+  if (!cooked.Read(cache_file_name) || !cooked.IsCurrent(&touched)) {
+    cooked.Clear();
+    return false;
+  }
+  if (touched) {
+    // a source was saved without changing, store its new time
+    cooked.Write(cache_file_name);
+  }
+  for (auto const& mat : cooked.materials) {
+    materials[mat.first].SetRecord(mat.second, assets);
+  }
+  bound_min = cooked.bound_min;
+  bound_max = cooked.bound_max;
+  BuildBuffers();
+  return true;
+}
+
+// cache_file_name is the path to a .mesh file
+// writes cooked and the materials to cache_file_name
+void Model::SaveCache(const std::string &cache_file_name,
+                      const std::string &obj_file_name) {
+  cooked.sources.clear();
+  cooked.materials.clear();
+  bool found = cooked.AddSource(obj_file_name);
+  for (int i = 0; i < material_libraries.size() && found; i++) {
+    found = cooked.AddSource("data/" + material_libraries[i]);
+  }
+  for (auto const& mat : materials) {
+    cooked.materials[mat.first] = mat.second.GetRecord();
+  }
+  if (found) {
+    // the cache is only an optimization, so failing to write it is fine
+    cooked.Write(cache_file_name);
+  }
 }
 
 // returns a pointer to an array containing all verticies
 // user must call delete on the value returned when they are done using it
 GLfloat * Model::GetVertexData() const {
-  GLfloat * rv = new GLfloat[face_attributes.size() * VERTEX_SIZE];
-  for (int i = 0; i < face_attributes.size(); i++) {
-    for (int j = 0; j < VERTEX_SIZE; j++) {
-      rv[(i*VERTEX_SIZE)+j] = verticies[face_attributes[i].x][j];
-    }
-  }
+  GLfloat * rv = new GLfloat[cooked.vertex_data.size()];
+  std::copy(cooked.vertex_data.begin(), cooked.vertex_data.end(), rv);
   return rv;
 }
 
 // returns a pointer to an array containing all texture vertices
 // user must call delete on the value returned when they are done using it
 GLfloat * Model::GetTextureVertexData() const {
-  GLfloat * rv = new GLfloat[face_attributes.size() * TEXTURE_VERTEX_SIZE];
-  for (int i = 0; i < face_attributes.size(); i++) {
-    for (int j = 0; j < TEXTURE_VERTEX_SIZE; j++) {
-      if (face_attributes[i].y == -1) {
-        rv[(i*TEXTURE_VERTEX_SIZE)+j] = 0;
-      } else {
-        rv[(i*TEXTURE_VERTEX_SIZE)+j] =
-          texture_vertices[face_attributes[i].y][j];
-      }
-    }
-  }
+  GLfloat * rv = new GLfloat[cooked.texture_vertex_data.size()];
+  std::copy(cooked.texture_vertex_data.begin(),
+            cooked.texture_vertex_data.end(), rv);
   return rv;
 }
 
@@ -259,16 +327,8 @@ GLfloat * Model::GetTextureVertexData() const {
 // verticies
 // user must call delete on the value returned when they are done using it
 GLfloat * Model::GetNormalData() const {
-  GLfloat * rv = new GLfloat[face_attributes.size() * NORMAL_SIZE];
-  for (int i = 0; i < face_attributes.size(); i++) {
-    for (int j = 0; j < NORMAL_SIZE; j++) {
-      if (face_attributes[i].z == -1) {
-        rv[(i*NORMAL_SIZE)+j] = 0;
-      } else {
-        rv[(i*NORMAL_SIZE)+j] = normals[face_attributes[i].z][j];
-      }
-    }
-  }
+  GLfloat * rv = new GLfloat[cooked.normal_data.size()];
+  std::copy(cooked.normal_data.begin(), cooked.normal_data.end(), rv);
   return rv;
 }
 
@@ -276,13 +336,9 @@ GLfloat * Model::GetNormalData() const {
 // returns a pointer to an array of indicies of verticies that make up faces
 // user must call delete on the value returned when they are done using it
 GLuint * Model::GetFaceData(const std::string material_name) const {
-  std::vector<glm::vec3> faces = objects.at(material_name);
-  GLuint * rv = new GLuint[faces.size() * FACE_SIZE];
-  for (int i = 0; i < faces.size(); i++) {
-    for (int j = 0; j < FACE_SIZE; j++) {
-      rv[(i*FACE_SIZE)+j] = faces[i][j];
-    }
-  }
+  const std::vector<GLuint> &faces = cooked.face_data.at(material_name);
+  GLuint * rv = new GLuint[faces.size()];
+  std::copy(faces.begin(), faces.end(), rv);
   return rv;
 }
 
@@ -296,32 +352,46 @@ Model::Model() {
   objects.insert({current_material, std::vector<glm::vec3>()});
   bound_min = glm::vec3(0, 0, 0);
   bound_max = glm::vec3(0, 0, 0);
+  vertex_buffer = index_buffer = 0;
+  buffers_dirty = true;
+  assets = nullptr;
 }
 
-// obj_file_name is the path to an .obj file
-// the .obj file specified is loaded into this
-Model::Model(const std::string &obj_file_name) {
+// obj_file_name is the path to an .obj file and assets may be null
+// the .obj file specified is loaded into this, sharing its materials and
+// textures through assets when it is given
+Model::Model(const std::string &obj_file_name, AssetRegistry* assets) {
   // Set the current material to the default material
   current_material = "engine::default";
   materials[current_material] = engine::Material();
   bound_min = glm::vec3(0, 0, 0);
   bound_max = glm::vec3(0, 0, 0);
+  vertex_buffer = index_buffer = 0;
+  buffers_dirty = true;
+  this->assets = assets;
   // Load obj file
   Load(obj_file_name);
 }
 
 // obj_file_name is the path to an .obj file
-// the .obj file specified is loaded into this
-void Model::Load(const std::string &obj_file_name) {
-  // Empty Previous Data
-  Clear();
-
-  std::string line;
-  std::ifstream file(obj_file_name);
-  if (file.is_open()) {
+// parses the .obj file into this and returns whether it was successful
+bool Model::Import(const std::string &obj_file_name) {
+  bool rv = false;
+  MappedFile file(obj_file_name);
+  if (file.IsOpen()) {
+    rv = true;
     try {
-      while (getline(file, line)) {
-        std::vector<std::string> tokens = Tokenize(line);
+      std::vector<Token> tokens;
+      const char* line = file.Data();
+      const char* file_end = file.Data() + file.Size();
+      while (line < file_end) {
+        const char* line_end = static_cast<const char*>(
+          memchr(line, '\n', file_end-line));
+        if (line_end == nullptr) {
+          line_end = file_end;
+        }
+        Tokenize(line, line_end, &tokens);
+        line = line_end + 1;
         // tokens is each item on the line seperated by whitespace
         if (tokens.size() > 0) {
           if (tokens[0] == "v") {
@@ -336,16 +406,16 @@ void Model::Load(const std::string &obj_file_name) {
           } else if (tokens[0] == "vt") {
             // Line is a texture vertex
             AddTextureVertex(tokens);
-          } else if (tokens[0] == "mtllib") {
-            AddMaterials(tokens[1]);
+          } else if (tokens[0] == "mtllib" && tokens.size() > 1) {
+            material_libraries.push_back(tokens[1].ToString());
+            AddMaterials(material_libraries.back());
           } else if (tokens[0] == "usemtl") {
-            try {
-              current_material = tokens[1];
-              if (objects.find(current_material) == objects.end()) {
-                objects.insert({current_material, std::vector<glm::vec3>()});
-              }
-            } catch(std::exception& e) {
-              throw "Invalid Material Switch Statement";
+            if (tokens.size() < 2) {
+              throw std::string("Invalid Material Switch Statement");
+            }
+            current_material = tokens[1].ToString();
+            if (objects.find(current_material) == objects.end()) {
+              objects.insert({current_material, std::vector<glm::vec3>()});
             }
           }
         }
@@ -353,44 +423,130 @@ void Model::Load(const std::string &obj_file_name) {
     } catch(const std::string msg) {
       Clear();
       std::cerr << msg << std::endl;
+      rv = false;
     }
-    file.close();
+    file.Close();
   }
+  // The lookups are only needed while reading faces so free them
+  std::unordered_map<FaceAttribute, int, FaceAttributeHash>().swap(
+    face_attribute_indices);
+  std::vector<Token>().swap(face_tokens);
+  return rv;
 }
 
-// An object has been loaded
-// renders the obj file loaded
-void Model::Draw() const {
-  GLfloat * v_data = GetVertexData();
-  GLfloat * n_data = GetNormalData();
-  GLfloat * t_data = GetTextureVertexData();
+// obj_file_name is the path to an .obj file
+// the .obj file specified is loaded into this, the first time a file is
+// loaded it is cooked into a .mesh file next to it which is used instead of
+// the .obj file until the .obj or its .mtl files change
+void Model::Load(const std::string &obj_file_name) {
+  // Empty Previous Data
+  Clear();
+
+  std::string cache_file_name = MeshCachePath(obj_file_name);
+  if (!LoadCache(cache_file_name)) {
+    bool imported = Import(obj_file_name);
+    Cook();
+    if (imported) {
+      SaveCache(cache_file_name, obj_file_name);
+    }
+  }
+}
+
+// points the vertex, normal, and texture arrays at this model's vertices
+// returns where the indices start, 0 when they are in a buffer object
+uintptr_t Model::BindArrays() const {
+  if (buffers_dirty) {
+    Upload();
+  }
+
+  // With buffer objects the pointers are offsets into the bound buffers,
+  // otherwise they point at the arrays in memory
+  uintptr_t vertices = 0;
+  uintptr_t indices = 0;
+  if (vertex_buffer != 0) {
+    BindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    BindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+  } else {
+    vertices = reinterpret_cast<uintptr_t>(interleaved_data.data());
+    indices = reinterpret_cast<uintptr_t>(index_data.data());
+  }
+  GLsizei stride = INTERLEAVED_SIZE*sizeof(GLfloat);
 
   glEnableClientState(GL_VERTEX_ARRAY);
-  glVertexPointer(VERTEX_SIZE, GL_FLOAT, 0, v_data);
+  glVertexPointer(VERTEX_SIZE, GL_FLOAT, stride,
+    reinterpret_cast<const GLvoid*>(vertices));
   glEnableClientState(GL_NORMAL_ARRAY);
-  glNormalPointer(GL_FLOAT, 0, n_data);
+  glNormalPointer(GL_FLOAT, stride,
+    reinterpret_cast<const GLvoid*>(vertices + VERTEX_SIZE*sizeof(GLfloat)));
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-  glTexCoordPointer(TEXTURE_VERTEX_SIZE, GL_FLOAT, 0, t_data);
+  glTexCoordPointer(TEXTURE_VERTEX_SIZE, GL_FLOAT, stride,
+    reinterpret_cast<const GLvoid*>(vertices +
+    (VERTEX_SIZE+NORMAL_SIZE)*sizeof(GLfloat)));
+  return indices;
+}
 
-  for (auto const& mat : materials) {
-    // std::cout << mat.first << std::endl;
-    if (objects.find(mat.first) != objects.end()) {
-      GLuint * f_data = GetFaceData(mat.first);
-      mat.second.Activate();
-      glDrawElements(GL_TRIANGLES, objects.at(mat.first).size()*
-        FACE_SIZE, GL_UNSIGNED_INT, f_data);
-      delete[] f_data;
+// unbinds this model's buffer objects if it has them
+void Model::UnbindArrays() const {
+  if (vertex_buffer != 0) {
+    BindBuffer(GL_ARRAY_BUFFER, 0);
+    BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+}
+
+// An object has been loaded
+// renders the obj file loaded
+void Model::Draw() const {
+  if (Headless()) {
+    return;
+  }
+  uintptr_t indices = BindArrays();
+  for (auto const& range : draw_ranges) {
+    if (range.material != nullptr) {
+      range.material->Activate();
+      glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT,
+        reinterpret_cast<const GLvoid*>(indices +
+        range.offset*sizeof(GLuint)));
     }
   }
+  UnbindArrays();
+}
 
-  delete[] v_data;
-  delete[] n_data;
-  delete[] t_data;
+// transforms is an array of count model matrices
+// renders the obj file loaded once for each transform, the arrays are set
+// up once and each material is only activated once for all of them
+void Model::DrawBatch(const glm::mat4* transforms, int count) const {
+  if (count <= 0 || Headless()) {
+    return;
+  }
+  uintptr_t indices = BindArrays();
+  for (auto const& range : draw_ranges) {
+    if (range.material != nullptr) {
+      range.material->Activate();
+      for (int i = 0; i < count; i++) {
+        glPushMatrix();
+          glMultMatrixf(glm::value_ptr(transforms[i]));
+          glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT,
+            reinterpret_cast<const GLvoid*>(indices +
+            range.offset*sizeof(GLuint)));
+        glPopMatrix();
+      }
+    }
+  }
+  UnbindArrays();
+}
+
+// Deconstructor
+// frees the vertex and index buffers
+Model::~Model() {
+  if (vertex_buffer != 0) {
+    DeleteBuffers(1, &vertex_buffer);
+    DeleteBuffers(1, &index_buffer);
+  }
 }
 
 // returns the number of veriticies
 int Model::GetNumVerticies() const {
-  return face_attributes.size()*VERTEX_SIZE;
+  return cooked.vertex_data.size();
 }
 
 // Returns bound_min
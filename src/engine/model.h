@@ -7,23 +7,65 @@
 
 #include <GLFW/glfw3.h>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <exception>
 #include <algorithm>
+#include <cstdint>
 
 #include "glm/glm.hpp"
 #include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
 #include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/type_ptr.hpp"
 #include "engine/material.h"
+#include "engine/gl_buffer.h"
+#include "engine/headless.h"
+#include "engine/mapped_file.h"
+#include "engine/mesh_cache.h"
+#include "engine/helper.h"
 #include "engine/constants.h"
 
 namespace engine {
 
+// FaceAttribute is the vertex, texture vertex, and normal index triple a face
+// corner references
+struct FaceAttribute {
+  int vertex;
+  int texture_vertex;
+  int normal;
+
+  bool operator==(const FaceAttribute& other) const {
+    return vertex == other.vertex && texture_vertex == other.texture_vertex &&
+           normal == other.normal;
+  }
+};
+
+// hashes a FaceAttribute so it can be used as an unordered_map key
+struct FaceAttributeHash {
+  size_t operator()(const FaceAttribute& fa) const {
+    size_t h = std::hash<int>()(fa.vertex);
+    h = (h * 31) + std::hash<int>()(fa.texture_vertex);
+    h = (h * 31) + std::hash<int>()(fa.normal);
+    return h;
+  }
+};
+
+// DrawRange is a run of index_data drawn with a single material
+struct DrawRange {
+  std::string material_name;
+  const Material* material;
+  GLsizei offset;
+  GLsizei count;
+};
+
 class Model {
  protected:
   // member data
@@ -41,6 +83,14 @@ class Model {
   // and normals
   std::vector<glm::vec3> face_attributes;
 
+  // face_attribute_indices maps a face attribute to its index in
+  // face_attributes, it is only filled while Load is running
+  std::unordered_map<FaceAttribute, int, FaceAttributeHash>
+    face_attribute_indices;
+
+  // face_tokens is reused to split face corners while Load is running
+  std::vector<Token> face_tokens;
+
   // Faces is a c++ vector of vectors
   // std::vector<glm::vec3> faces;
 
@@ -48,11 +98,33 @@ class Model {
   std::map<std::string, std::vector<glm::vec3>> objects;
 
   // materials is a map that matches material names to materials
-  std::map<std::string, engine::Material> materials;
+  MaterialLibrary materials;
+
+  // assets shares material libraries and textures with other models, it is
+  // null when the model was loaded on its own
+  AssetRegistry* assets;
 
   // current_material is the material to assign to any face read in
   std::string current_material;
 
+  // material_libraries are the .mtl files the loaded .obj file uses
+  std::vector<std::string> material_libraries;
+
+  // cooked is the model expanded to one vertex per face attribute, it is what
+  // gets drawn and what is stored in the .mesh cache
+  CookedMesh cooked;
+
+  // interleaved_data holds each vertex followed by its normal and texture
+  // vertex, and index_data holds the faces of every material back to back.
+  // They are built whenever the model is cooked and uploaded to the vertex
+  // and index buffers the next time it is drawn.
+  std::vector<GLfloat> interleaved_data;
+  std::vector<GLuint> index_data;
+  mutable std::vector<DrawRange> draw_ranges;
+  mutable GLuint vertex_buffer;
+  mutable GLuint index_buffer;
+  mutable bool buffers_dirty;
+
   // wrapping bounding box
   glm::vec3 bound_min;
   glm::vec3 bound_max;
@@ -62,22 +134,22 @@ class Model {
   // vertex is a line that starts with v and contains vertex data
   // Adds the vertex described in vertex and returns true if the data is
   // formatted correctly and returns false otherwise
-  void AddVertex(std::vector<std::string> vertex);
+  void AddVertex(const std::vector<Token> &vertex);
 
   // face is a line that starts with f and contains face data
   // Adds the face described in face and returns true if the data is
   // formatted correctly and returns false otherwise
-  void AddFace(std::vector<std::string> face);
+  void AddFace(const std::vector<Token> &face);
 
   // texture vertex starts with vt and is the definition of a texture vertex
   // adds the specified texture vertex to the texture_vertices and throw a
   // string exception if the line is defined incorrectly
-  void AddTextureVertex(std::vector<std::string> texture_vertex);
+  void AddTextureVertex(const std::vector<Token> &texture_vertex);
 
   // normal is a line that starts with vn and contains normal data
   // adds the normal descibed to normal_vector and returns true iff the data is
   // formatted correctly and returns false otherwise
-  void AddNormal(std::vector<std::string> normal);
+  void AddNormal(const std::vector<Token> &normal);
 
   // mat_file is the name of a material library
   // adds all materials described in mat_file to materials
@@ -86,6 +158,39 @@ class Model {
   // empties the verticies and faces vectors
   void Clear();
 
+  // fills cooked with the expanded vertex, normal, texture vertex, and face
+  // data, call this whenever the verticies, normals, texture vertices, face
+  // attributes, or objects change
+  void Cook();
+
+  // fills interleaved_data, index_data, and draw_ranges from cooked
+  void BuildBuffers();
+
+  // copies interleaved_data and index_data to the gpu if buffer objects are
+  // supported and matches each draw range to its material
+  void Upload() const;
+
+  // points the vertex, normal, and texture arrays at this model's vertices
+  // returns where the indices start, 0 when they are in a buffer object
+  uintptr_t BindArrays() const;
+
+  // unbinds this model's buffer objects if it has them
+  void UnbindArrays() const;
+
+  // obj_file_name is the path to an .obj file
+  // parses the .obj file into this and returns whether it was successful
+  bool Import(const std::string &obj_file_name);
+
+  // cache_file_name is the path to a .mesh file
+  // loads the cooked mesh if it is still current with its sources and returns
+  // whether it was used
+  bool LoadCache(const std::string &cache_file_name);
+
+  // cache_file_name is the path to a .mesh file
+  // writes cooked and the materials to cache_file_name
+  void SaveCache(const std::string &cache_file_name,
+                 const std::string &obj_file_name);
+
   // returns a pointer to an array containing all verticies
   // user must call delete on the value returned when they are done using it
   GLfloat * GetVertexData() const;
@@ -108,18 +213,31 @@ class Model {
   // Default Constructor
   Model();
 
-  // obj_file_name is the path to an .obj file
-  // the .obj file specified is loaded into this
-  explicit Model(const std::string &obj_file_name);
+  // obj_file_name is the path to an .obj file and assets may be null
+  // the .obj file specified is loaded into this, sharing its materials and
+  // textures through assets when it is given
+  explicit Model(const std::string &obj_file_name,
+                 AssetRegistry* assets = nullptr);
 
   // obj_file_name is the path to an .obj file
-  // the .obj file specified is loaded into this
+  // the .obj file specified is loaded into this, the first time a file is
+  // loaded it is cooked into a .mesh file next to it which is used instead of
+  // the .obj file until the .obj or its .mtl files change
   void Load(const std::string &obj_file_name);
 
   // An object has been loaded
   // renders the obj file loaded
   void Draw() const;
 
+  // transforms is an array of count model matrices
+  // renders the obj file loaded once for each transform, the arrays are set
+  // up once and each material is only activated once for all of them
+  void DrawBatch(const glm::mat4* transforms, int count) const;
+
+  // Deconstructor
+  // frees the vertex and index buffers
+  ~Model();
+
   // returns the number of veriticies
   int GetNumVerticies() const;
 
@@ -135,6 +253,10 @@ class Model {
   // delete the assignment operator
   Model& operator=(const Model& model);
 };
+
+// ModelHandle keeps a shared model alive
+typedef std::shared_ptr<const Model> ModelHandle;
+
 }  // namespace engine
 
 #endif  // SRC_ENGINE_MODEL_H_
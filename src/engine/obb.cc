@@ -0,0 +1,373 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/obb.h"
+
+namespace engine {
+
+// entry and leave are where a line enters and leaves a box and length is the
+// length of the segment
+// returns the first of them on the segment past RAYCAST_MIN_DISTANCE or -1
+static inline float FirstFaceHit(float entry, float leave, float length) {
+  float rv = -1;
+  if (entry <= leave) {
+    if (entry >= RAYCAST_MIN_DISTANCE && entry <= length) {
+      rv = entry;
+    } else if (leave >= RAYCAST_MIN_DISTANCE && leave <= length) {
+      rv = leave;
+    }
+  }
+  return rv;
+}
+
+// a and b are boxes
+// returns true if a and b overlap or touch by checking all 15 separating
+// axes, the 3 face normals of each box and the 9 cross products of their edges
+bool OverlapOBB(const OBB &a, const OBB &b) {
+  const glm::vec3 &ea = a.half_extents;
+  const glm::vec3 &eb = b.half_extents;
+
+  // r is b's axes in a's frame, abs_r is padded so parallel edges whose
+  // cross product is near zero don't report a false separation
+  float r[3][3], abs_r[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      r[i][j] = glm::dot(a.axes[i], b.axes[j]);
+      abs_r[i][j] = std::fabs(r[i][j]) + OBB_EPSILON;
+    }
+  }
+
+  // t is the offset between the centers in a's frame
+  glm::vec3 d = b.center - a.center;
+  float t[3] = {glm::dot(d, a.axes[0]), glm::dot(d, a.axes[1]),
+                glm::dot(d, a.axes[2])};
+
+  // a's face normals
+  for (int i = 0; i < 3; i++) {
+    float rb = eb[0]*abs_r[i][0] + eb[1]*abs_r[i][1] + eb[2]*abs_r[i][2];
+    if (std::fabs(t[i]) > ea[i] + rb) return false;
+  }
+
+  // b's face normals
+  for (int j = 0; j < 3; j++) {
+    float ra = ea[0]*abs_r[0][j] + ea[1]*abs_r[1][j] + ea[2]*abs_r[2][j];
+    float dist = t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j];
+    if (std::fabs(dist) > ra + eb[j]) return false;
+  }
+
+  // a's axis i crossed with b's axis j, i1 and i2 are the other two axes of a
+  // and j1 and j2 the other two of b
+  for (int i = 0; i < 3; i++) {
+    int i1 = (i+1) % 3;
+    int i2 = (i+2) % 3;
+    for (int j = 0; j < 3; j++) {
+      int j1 = (j+1) % 3;
+      int j2 = (j+2) % 3;
+      float ra = ea[i1]*abs_r[i2][j] + ea[i2]*abs_r[i1][j];
+      float rb = eb[j1]*abs_r[i][j2] + eb[j2]*abs_r[i][j1];
+      float dist = t[i2]*r[i1][j] - t[i1]*r[i2][j];
+      if (std::fabs(dist) > ra + rb) return false;
+    }
+  }
+  return true;
+}
+
+#ifdef ENGINE_OBB_SSE
+// v is 4 floats
+// returns the absolute value of each
+static inline __m128 Abs4(__m128 v) {
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// a0, a1, a2 and b0, b1, b2 are 4 vectors stored one component per register
+// returns the 4 dot products
+static inline __m128 Dot4(__m128 a0, __m128 a1, __m128 a2,
+                          __m128 b0, __m128 b1, __m128 b2) {
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, b0), _mm_mul_ps(a1, b1)),
+                    _mm_mul_ps(a2, b2));
+}
+
+// box is a box and others is an array of 4 boxes
+// returns a mask with every bit of a lane set if box overlaps that box, this
+// is OverlapOBB run on 4 boxes at once without early outs
+static int OverlapOBB4(const OBB &box, const OBB* others) {
+  // gather b's centers, extents, and axes one component per register
+  float c[3][4], e[3][4], u[3][3][4];
+  for (int lane = 0; lane < 4; lane++) {
+    const OBB &b = others[lane];
+    for (int k = 0; k < 3; k++) {
+      c[k][lane] = b.center[k] - box.center[k];
+      e[k][lane] = b.half_extents[k];
+      for (int j = 0; j < 3; j++) {
+        u[j][k][lane] = b.axes[j][k];
+      }
+    }
+  }
+  __m128 d[3], eb[3], ea[3], a_axis[3][3], b_axis[3][3];
+  for (int k = 0; k < 3; k++) {
+    d[k] = _mm_loadu_ps(c[k]);
+    eb[k] = _mm_loadu_ps(e[k]);
+    ea[k] = _mm_set1_ps(box.half_extents[k]);
+    for (int j = 0; j < 3; j++) {
+      a_axis[j][k] = _mm_set1_ps(box.axes[j][k]);
+      b_axis[j][k] = _mm_loadu_ps(u[j][k]);
+    }
+  }
+
+  __m128 epsilon = _mm_set1_ps(OBB_EPSILON);
+  __m128 r[3][3], abs_r[3][3], t[3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      r[i][j] = Dot4(a_axis[i][0], a_axis[i][1], a_axis[i][2],
+                     b_axis[j][0], b_axis[j][1], b_axis[j][2]);
+      abs_r[i][j] = _mm_add_ps(Abs4(r[i][j]), epsilon);
+    }
+    t[i] = Dot4(d[0], d[1], d[2], a_axis[i][0], a_axis[i][1], a_axis[i][2]);
+  }
+
+  // separated has a lane set once any axis separates that pair
+  __m128 separated = _mm_setzero_ps();
+  for (int i = 0; i < 3; i++) {
+    __m128 rb = Dot4(eb[0], eb[1], eb[2],
+                     abs_r[i][0], abs_r[i][1], abs_r[i][2]);
+    separated = _mm_or_ps(separated,
+      _mm_cmpgt_ps(Abs4(t[i]), _mm_add_ps(ea[i], rb)));
+  }
+  for (int j = 0; j < 3; j++) {
+    __m128 ra = Dot4(ea[0], ea[1], ea[2],
+                     abs_r[0][j], abs_r[1][j], abs_r[2][j]);
+    __m128 dist = Dot4(t[0], t[1], t[2], r[0][j], r[1][j], r[2][j]);
+    separated = _mm_or_ps(separated,
+      _mm_cmpgt_ps(Abs4(dist), _mm_add_ps(ra, eb[j])));
+  }
+  for (int i = 0; i < 3; i++) {
+    int i1 = (i+1) % 3;
+    int i2 = (i+2) % 3;
+    for (int j = 0; j < 3; j++) {
+      int j1 = (j+1) % 3;
+      int j2 = (j+2) % 3;
+      __m128 ra = _mm_add_ps(_mm_mul_ps(ea[i1], abs_r[i2][j]),
+                             _mm_mul_ps(ea[i2], abs_r[i1][j]));
+      __m128 rb = _mm_add_ps(_mm_mul_ps(eb[j1], abs_r[i][j2]),
+                             _mm_mul_ps(eb[j2], abs_r[i][j1]));
+      __m128 dist = _mm_sub_ps(_mm_mul_ps(t[i2], r[i1][j]),
+                               _mm_mul_ps(t[i1], r[i2][j]));
+      separated = _mm_or_ps(separated,
+        _mm_cmpgt_ps(Abs4(dist), _mm_add_ps(ra, rb)));
+    }
+  }
+  return ~_mm_movemask_ps(separated) & 0xF;
+}
+#endif
+
+// box is a box, others is an array of count boxes, and results is an array of
+// count flags
+// sets results[i] to 1 if box overlaps others[i] and 0 otherwise, testing
+// 4 boxes at a time when SSE is available
+void OverlapOBBBatch(const OBB &box, const OBB* others, int count,
+                     uint8_t* results) {
+  int i = 0;
+#ifdef ENGINE_OBB_SSE
+  for (; i + 4 <= count; i += 4) {
+    int mask = OverlapOBB4(box, others + i);
+    for (int lane = 0; lane < 4; lane++) {
+      results[i + lane] = (mask >> lane) & 1;
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    results[i] = OverlapOBB(box, others[i]);
+  }
+}
+
+// box is a box and start and end define a line segment
+// returns the distance from start to the first place the segment crosses a
+// face of box that is at least RAYCAST_MIN_DISTANCE away, or -1 if there
+// isn't one, the segment is moved into the box's frame once and clipped
+// against each pair of faces
+float RayCastOBB(const OBB &box, glm::vec3 start, glm::vec3 end) {
+  float length = glm::length(end - start);
+  if (length == 0) {
+    return -1;
+  }
+  glm::vec3 direction = (end - start) / length;
+  glm::vec3 offset = start - box.center;
+  // entry and leave are the distances along the whole line where it is
+  // between every pair of faces
+  float entry = -INFINITY;
+  float leave = INFINITY;
+  for (int i = 0; i < 3; i++) {
+    float s = glm::dot(offset, box.axes[i]);
+    float d = glm::dot(direction, box.axes[i]);
+    float e = box.half_extents[i];
+    if (std::fabs(d) < OBB_EPSILON) {
+      // parallel to these faces so it never crosses them
+      if (std::fabs(s) > e) {
+        return -1;
+      }
+    } else {
+      float t1 = (-e - s) / d;
+      float t2 = (e - s) / d;
+      entry = std::max(entry, std::min(t1, t2));
+      leave = std::min(leave, std::max(t1, t2));
+    }
+  }
+  return FirstFaceHit(entry, leave, length);
+}
+
+#ifdef ENGINE_OBB_SSE
+// offset and direction are 4 lines relative to 4 box centers, axes and half
+// are the boxes' axes and half extents, and length is each segment's length,
+// all stored one component per register
+// results is where to put the 4 distances, this is the slab test of
+// RayCastOBB run on 4 line and box pairs at once
+static void ClipSlabs4(const __m128 offset[3], const __m128 direction[3],
+                       const __m128 axes[3][3], const __m128 half[3],
+                       const float* length, float* results) {
+  __m128 epsilon = _mm_set1_ps(OBB_EPSILON);
+  __m128 entry = _mm_set1_ps(-INFINITY);
+  __m128 leave = _mm_set1_ps(INFINITY);
+  // missed has a lane set when the line is parallel to and outside a slab
+  __m128 missed = _mm_setzero_ps();
+  for (int i = 0; i < 3; i++) {
+    __m128 s = Dot4(offset[0], offset[1], offset[2],
+                    axes[i][0], axes[i][1], axes[i][2]);
+    __m128 d = Dot4(direction[0], direction[1], direction[2],
+                    axes[i][0], axes[i][1], axes[i][2]);
+    __m128 parallel = _mm_cmplt_ps(Abs4(d), epsilon);
+    missed = _mm_or_ps(missed,
+      _mm_and_ps(parallel, _mm_cmpgt_ps(Abs4(s), half[i])));
+    // parallel lanes divide by 1 so they can't produce nan and are then
+    // ignored
+    __m128 safe_d = _mm_or_ps(_mm_and_ps(parallel, _mm_set1_ps(1.0f)),
+                              _mm_andnot_ps(parallel, d));
+    __m128 t1 = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), half[i]),
+                                      s), safe_d);
+    __m128 t2 = _mm_div_ps(_mm_sub_ps(half[i], s), safe_d);
+    __m128 slab_entry = _mm_or_ps(
+      _mm_and_ps(parallel, _mm_set1_ps(-INFINITY)),
+      _mm_andnot_ps(parallel, _mm_min_ps(t1, t2)));
+    __m128 slab_exit = _mm_or_ps(
+      _mm_and_ps(parallel, _mm_set1_ps(INFINITY)),
+      _mm_andnot_ps(parallel, _mm_max_ps(t1, t2)));
+    entry = _mm_max_ps(entry, slab_entry);
+    leave = _mm_min_ps(leave, slab_exit);
+  }
+
+  float entries[4], exits[4];
+  _mm_storeu_ps(entries, entry);
+  _mm_storeu_ps(exits, leave);
+  int miss_mask = _mm_movemask_ps(missed);
+  for (int lane = 0; lane < 4; lane++) {
+    results[lane] = ((miss_mask >> lane) & 1) ? -1 :
+                    FirstFaceHit(entries[lane], exits[lane], length[lane]);
+  }
+}
+
+// start and direction define a line, length is how long the segment is, and
+// boxes is an array of 4 boxes and results is where to put their distances
+// this is RayCastOBB run on 4 boxes at once
+static void RayCastOBB4(glm::vec3 start, glm::vec3 direction, float length,
+                        const OBB* boxes, float* results) {
+  // gather each box's values one component per register
+  float c[3][4], e[3][4], u[3][3][4];
+  for (int lane = 0; lane < 4; lane++) {
+    const OBB &b = boxes[lane];
+    for (int k = 0; k < 3; k++) {
+      c[k][lane] = start[k] - b.center[k];
+      e[k][lane] = b.half_extents[k];
+      for (int j = 0; j < 3; j++) {
+        u[j][k][lane] = b.axes[j][k];
+      }
+    }
+  }
+  __m128 offset[3], dir[3], axes[3][3], half[3];
+  for (int k = 0; k < 3; k++) {
+    offset[k] = _mm_loadu_ps(c[k]);
+    dir[k] = _mm_set1_ps(direction[k]);
+    half[k] = _mm_loadu_ps(e[k]);
+    for (int j = 0; j < 3; j++) {
+      axes[j][k] = _mm_loadu_ps(u[j][k]);
+    }
+  }
+  float lengths[4] = {length, length, length, length};
+  ClipSlabs4(offset, dir, axes, half, lengths, results);
+}
+
+// box is a box, starts and ends define 4 line segments, and results is where
+// to put their distances
+// this is RayCastOBB run on 4 segments at once
+static void RayCastOBBPacket4(const OBB &box, const glm::vec3* starts,
+                              const glm::vec3* ends, float* results) {
+  // gather each segment's values one component per register, a segment
+  // with no length gets no direction and is reported as a miss below
+  float c[3][4], v[3][4], lengths[4];
+  for (int lane = 0; lane < 4; lane++) {
+    lengths[lane] = glm::length(ends[lane] - starts[lane]);
+    glm::vec3 direction(0, 0, 0);
+    if (lengths[lane] != 0) {
+      direction = (ends[lane] - starts[lane]) / lengths[lane];
+    }
+    for (int k = 0; k < 3; k++) {
+      c[k][lane] = starts[lane][k] - box.center[k];
+      v[k][lane] = direction[k];
+    }
+  }
+  __m128 offset[3], dir[3], axes[3][3], half[3];
+  for (int k = 0; k < 3; k++) {
+    offset[k] = _mm_loadu_ps(c[k]);
+    dir[k] = _mm_loadu_ps(v[k]);
+    half[k] = _mm_set1_ps(box.half_extents[k]);
+    for (int j = 0; j < 3; j++) {
+      axes[j][k] = _mm_set1_ps(box.axes[j][k]);
+    }
+  }
+  ClipSlabs4(offset, dir, axes, half, lengths, results);
+  for (int lane = 0; lane < 4; lane++) {
+    if (lengths[lane] == 0) {
+      results[lane] = -1;
+    }
+  }
+}
+#endif
+
+// start and end define a line segment, boxes is an array of count boxes,
+// and results is an array of count distances
+// sets results[i] to RayCastOBB(boxes[i], start, end), testing 4 boxes at a
+// time when SSE is available
+void RayCastOBBBatch(glm::vec3 start, glm::vec3 end, const OBB* boxes,
+                     int count, float* results) {
+  int i = 0;
+#ifdef ENGINE_OBB_SSE
+  float length = glm::length(end - start);
+  if (length != 0) {
+    glm::vec3 direction = (end - start) / length;
+    for (; i + 4 <= count; i += 4) {
+      RayCastOBB4(start, direction, length, boxes + i, results + i);
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    results[i] = RayCastOBB(boxes[i], start, end);
+  }
+}
+
+// box is a box, starts and ends are arrays of count line segments, and
+// results is an array of count distances
+// sets results[i] to RayCastOBB(box, starts[i], ends[i]), testing 4 segments
+// at a time when SSE is available
+void RayCastOBBPacket(const OBB &box, const glm::vec3* starts,
+                      const glm::vec3* ends, int count, float* results) {
+  int i = 0;
+#ifdef ENGINE_OBB_SSE
+  for (; i + 4 <= count; i += 4) {
+    RayCastOBBPacket4(box, starts + i, ends + i, results + i);
+  }
+#endif
+  for (; i < count; i++) {
+    results[i] = RayCastOBB(box, starts[i], ends[i]);
+  }
+}
+
+}  // namespace engine
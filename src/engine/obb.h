@@ -0,0 +1,70 @@
+#ifndef SRC_ENGINE_OBB_H_
+#define SRC_ENGINE_OBB_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENGINE_OBB_SSE
+#endif
+
+// lib
+#include "glm/vec3.hpp"
+#include "glm/geometric.hpp"
+
+// src
+#include "engine/constants.h"
+
+namespace engine {
+
+// OBB is an oriented bounding box in world space
+struct OBB {
+  glm::vec3 center;
+  glm::vec3 half_extents;
+  // axes are the box's unit length local x, y, and z axes
+  glm::vec3 axes[3];
+};
+
+// a and b are boxes
+// returns true if a and b overlap or touch by checking all 15 separating
+// axes, the 3 face normals of each box and the 9 cross products of their edges
+bool OverlapOBB(const OBB &a, const OBB &b);
+
+// box is a box, others is an array of count boxes, and results is an array of
+// count flags
+// sets results[i] to 1 if box overlaps others[i] and 0 otherwise, testing
+// 4 boxes at a time when SSE is available
+void OverlapOBBBatch(const OBB &box, const OBB* others, int count,
+                     uint8_t* results);
+
+// box is a box and start and end define a line segment
+// returns the distance from start to the first place the segment crosses a
+// face of box that is at least RAYCAST_MIN_DISTANCE away, or -1 if there
+// isn't one, the segment is moved into the box's frame once and clipped
+// against each pair of faces
+float RayCastOBB(const OBB &box, glm::vec3 start, glm::vec3 end);
+
+// start and end define a line segment, boxes is an array of count boxes,
+// and results is an array of count distances
+// sets results[i] to RayCastOBB(boxes[i], start, end), testing 4 boxes at a
+// time when SSE is available
+void RayCastOBBBatch(glm::vec3 start, glm::vec3 end, const OBB* boxes,
+                     int count, float* results);
+
+// box is a box, starts and ends are arrays of count line segments, and
+// results is an array of count distances
+// sets results[i] to RayCastOBB(box, starts[i], ends[i]), testing 4 segments
+// at a time when SSE is available
+void RayCastOBBPacket(const OBB &box, const glm::vec3* starts,
+                      const glm::vec3* ends, int count, float* results);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_OBB_H_
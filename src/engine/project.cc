@@ -6,58 +6,145 @@
 
 namespace engine {
 
-// type is a type_index and types is a list of type_indexs
-// returns if type is in types
-bool Project::ShouldIgnore(GameObject* obj, std::vector<std::string> tags) {
-  bool rv = true;
-  if (WithInRender(obj->GetPosition()) || obj->HasTag("floor")) {
-    rv = false;
-    for (int i = 0; i < tags.size() && !rv; i++) {
-      if (obj->HasTag(tags[i])) {
-        rv = true;
-      }
+// obj is a game object and ignore is the tags to ignore
+// returns whether obj is outside the render box, unless it is the floor, or
+// has a tag in ignore
+bool Project::ShouldIgnore(GameObject* obj, TagMask ignore) {
+  TagMask mask = obj->tags.GetMask();
+  return (mask & ignore) != 0 ||
+         (!(mask & floor_tag) && !WithInRender(obj->GetPosition()));
+}
+
+// ignore is the tags to ignore
+// returns the current scene's tile grid or nullptr if it has no tiles or
+// they have a tag in ignore
+const TileGrid* Project::CollidableTiles(TagMask ignore) {
+  auto found = tile_grids.find(current_scene);
+  if (found == tile_grids.end() || found->second.GetNumTiles() == 0 ||
+      (found->second.tags.GetMask() & ignore) != 0) {
+    return nullptr;
+  }
+  return &found->second;
+}
+
+// object is a game object
+// takes object out of its scene list by moving the last item into its place
+void Project::RemoveFromSceneList(GameObject* object) {
+  if (object->scene_list) {
+    object->scene_list->RemoveAt(object->scene_index);
+    object->scene_list = nullptr;
+    object->scene_index = -1;
+  }
+}
+
+// returns the current scene's broadphase after resizing its cells to
+// collision_radius if it changed
+SpatialHash& Project::SceneBroadphase() {
+  SpatialHash &hash = broadphase[current_scene];
+  if (collision_radius > 0 && hash.GetCellSize() != collision_radius) {
+    hash.SetCellSize(collision_radius);
+  }
+  return hash;
+}
+
+// works out where every attached object ended up after its parents moved
+// and updates the broadphase for the ones in this
+void Project::PropagateTransforms() {
+  TransformStore &transforms = Transforms();
+  moved_transforms.clear();
+  transforms.UpdateHierarchy(&moved_transforms);
+  for (int i = 0; i < moved_transforms.size(); i++) {
+    GameObject* moved = transforms.GetOwner(moved_transforms[i]);
+    if (moved && moved->project == this) {
+      UpdateBroadphase(moved);
+    }
+  }
+}
+
+// returns the last enabled camera in the current scene or nullptr if there
+// isn't one
+Camera* Project::GetActiveCamera() {
+  Camera* rv = nullptr;
+  SceneList<Camera> &scene_cameras = cameras[current_scene];
+  for (int i = 0; i < scene_cameras.size(); i++) {
+    if (scene_cameras[i]->enabled) {
+      rv = scene_cameras[i];
     }
   }
   return rv;
 }
 
+// phase is a frame phase and start is when it started
+// records how long phase took in phase_times and returns the time it ended
+std::chrono::steady_clock::time_point Project::EndPhase(int phase,
+    std::chrono::steady_clock::time_point start) {
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  phase_times[phase] +=
+    std::chrono::duration<double, std::milli>(end - start).count();
+  return end;
+}
+
 // Run the trash collector
 void Project::TrashCollector() {
-  // Trash Collection
+  // Unlink everything first so nothing being deleted can still be found
   for (int i = 0; i < trashcan.size(); i++) {
+    // an object can be thrown out more than once in a frame
+    if (!objects.Contains(trashcan[i])) {
+      continue;
+    }
     GameObject* to_delete = objects[trashcan[i]];
     // std::cout << *to_delete << std::endl;
-    objects.erase(trashcan[i]);
-    std::vector<int>::iterator it;
-    for (auto & rbs : rigidbodies) {
-      it = std::find(rbs.second.begin(), rbs.second.end(), trashcan[i]);
-      if (it != rbs.second.end()) rbs.second.erase(it);
+    RemoveFromSceneList(to_delete);
+    for (auto & hash : broadphase) {
+      hash.second.Remove(trashcan[i]);
     }
-    for (auto & cms : cameras) {
-      it = std::find(cms.second.begin(), cms.second.end(), trashcan[i]);
-      if (it != cms.second.end()) cms.second.erase(it);
+    for (auto & tree : bounding_volumes) {
+      tree.second.Remove(trashcan[i]);
     }
-    for (auto & uil : uis) {
-      it = std::find(uil.second.begin(), uil.second.end(), trashcan[i]);
-      if (it != uil.second.end()) uil.second.erase(it);
-    }
-    delete to_delete;
+    objects.Remove(trashcan[i]);
+    garbage.push_back(to_delete);
   }
   trashcan.clear();
+  // Then free them all in one pass
+  for (int i = 0; i < garbage.size(); i++) {
+    delete garbage[i];
+  }
+  if (garbage.size() > 0) {
+    assets.Prune();
+  }
+  garbage.clear();
 }
 
 // obj is the point we are looking for
 // returns true is obj is in the render box
 bool Project::WithInRender(glm::vec3 obj) {
-  PointInBox(obj, center, render_distance);
+  return PointInBox(obj, center, render_distance);
 }
 
 // Default Constructor
 Project::Project() {
   deadzone = ENGINE_DEAD_ZONE;
   mouse_sensitivity = ENGINE_MOUSE_SENSITIVITY;
-  current_id = 0;
+  collision_radius = ENGINE_COLLISION_RADIUS;
+  render_distance = ENGINE_RENDER_DISTANCE;
+  center = glm::vec3(0, 0, 0);
+  print_frame_stats = false;
+  jobs = nullptr;
+  tick_rate = ENGINE_TICK_RATE;
+  max_catch_up_steps = ENGINE_MAX_CATCH_UP_STEPS;
+  delta = 1.0f/tick_rate;
+  interpolation = 0;
+  step_count = 0;
+  window = nullptr;
+  headless = false;
+  quit = false;
+  memset(&input_state, 0, sizeof(input_state));
+  std::fill(phase_times, phase_times + NUM_FRAME_PHASES, 0);
+  render_stats.drawn = 0;
+  render_stats.culled = 0;
   current_scene = "gameengine::default";
+  floor_tag = MakeTagMask({"floor"});
+  std::fill(layer_ignores, layer_ignores + TAG_MAX, 0);
 }
 
 // Constructor
@@ -67,12 +154,40 @@ Project::Project(std::string pname) {
   name = pname;
   deadzone = ENGINE_DEAD_ZONE;
   mouse_sensitivity = ENGINE_MOUSE_SENSITIVITY;
-  current_id = 0;
+  collision_radius = ENGINE_COLLISION_RADIUS;
+  render_distance = ENGINE_RENDER_DISTANCE;
+  center = glm::vec3(0, 0, 0);
+  print_frame_stats = false;
+  jobs = nullptr;
+  tick_rate = ENGINE_TICK_RATE;
+  max_catch_up_steps = ENGINE_MAX_CATCH_UP_STEPS;
+  delta = 1.0f/tick_rate;
+  interpolation = 0;
+  step_count = 0;
+  window = nullptr;
+  headless = false;
+  quit = false;
+  memset(&input_state, 0, sizeof(input_state));
+  std::fill(phase_times, phase_times + NUM_FRAME_PHASES, 0);
+  render_stats.drawn = 0;
+  render_stats.culled = 0;
   current_scene = "gameengine::default";
+  floor_tag = MakeTagMask({"floor"});
+  std::fill(layer_ignores, layer_ignores + TAG_MAX, 0);
 }
 
-// initializes glwf and openGL for drawing
-int Project::Initialize() {
+// headless is whether to run without a window or OpenGL, by default this
+// is false
+// initializes glwf and openGL for drawing, or when headless makes every
+// model, material, texture, and light skip OpenGL so the simulation can
+// run on a machine without a display, returns 0 if it worked and -1 if it
+// didn't
+int Project::Initialize(bool headless) {
+  this->headless = headless;
+  SetHeadless(headless);
+  if (headless) {
+    return 0;
+  }
   // Initialize the library
   if (!glfwInit()) {
     return -1;
@@ -98,137 +213,464 @@ int Project::Initialize() {
   glfwGetCursorPos(window, &xpos, &ypos);
   previos_cursor_position = glm::vec2(xpos, ypos);
 
-  // start the ticker
-  ticks = 0;
-  delta = 1.0f/60.0f;
-
   return 0;
 }
 
-// runs the update and draw functions for all game objects
+// runs the update and draw functions for all game objects until the
+// window is closed or Quit is called, headless it runs steps back to back
+// without waiting for the clock
 void Project::GameLoop() {
+  if (headless) {
+    HeadlessLoop();
+    return;
+  }
+  // accumulator is how much time has passed that steps haven't covered yet
+  double accumulator = 0;
+  std::chrono::steady_clock::time_point previous_time =
+    std::chrono::steady_clock::now();
   // Loop until the user closes the window
-  while (!glfwWindowShouldClose(window)) {
-    time_t start_time = time(NULL);
-    // Set the rendering viewport location and dimensions
+  while (!quit && !glfwWindowShouldClose(window)) {
+    std::chrono::steady_clock::time_point frame_start =
+      std::chrono::steady_clock::now();
+    accumulator +=
+      std::chrono::duration<double>(frame_start - previous_time).count();
+    previous_time = frame_start;
+    delta = 1.0f/tick_rate;
+    accumulator = std::min(accumulator,
+                           static_cast<double>(delta) * max_catch_up_steps);
     int width, height;
     glfwGetFramebufferSize(window, &width, &height);
-    glViewport(0, 0, width, height);
-
-    // Create The Camera Frustum
-    // Enable Depth
-    glEnable(GL_DEPTH_TEST);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    for (int i = 0; i < cameras[current_scene].size(); i++) {
-      Camera* cam = dynamic_cast<Camera*>(objects[cameras[current_scene][i]]);
-      if (cam) {
-        if (cam->enabled) {
-          cam->MultProjectionMatrix(width, height);
-          center = cam->GetPosition();
-        }
-      }
+    std::fill(phase_times, phase_times + NUM_FRAME_PHASES, 0);
+
+    // Each phase finishes for every object before the next one starts
+    std::chrono::steady_clock::time_point phase_start = frame_start;
+    PollInput();
+    EndPhase(PHASE_INPUT, phase_start);
+    while (accumulator >= delta) {
+      Step(delta);
+      accumulator -= delta;
     }
 
-    // Clear the color buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Draw everything where it was part way through the last step
+    interpolation = accumulator / delta;
+    TransformStore &transforms = Transforms();
+    transforms.BeginInterpolation(interpolation);
+    phase_start = std::chrono::steady_clock::now();
+    CullObjects(width/static_cast<float>(height));
+    phase_start = EndPhase(PHASE_CULL, phase_start);
+    Render(width, height);
+    EndPhase(PHASE_RENDER, phase_start);
+    transforms.EndInterpolation();
+    if (print_frame_stats) {
+      PrintFrameStats();
+    }
+  }
+}
 
-    // Draw the rigid bodies
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-      // Transform The Camera
-      for (int i = 0; i < cameras[current_scene].size(); i++) {
-        Camera* cam = dynamic_cast<Camera*>(objects[cameras[current_scene][i]]);
-        if (cam) {
-          cam->Update(delta);
-          if (cam->enabled) {
-            cam->MultViewMatrix();
-          }
-        }
+// runs steps back to back, as fast as they can go, without drawing until
+// Quit is called
+void Project::HeadlessLoop() {
+  delta = 1.0f/tick_rate;
+  interpolation = 0;
+  while (!quit) {
+    std::fill(phase_times, phase_times + NUM_FRAME_PHASES, 0);
+    std::chrono::steady_clock::time_point phase_start =
+      std::chrono::steady_clock::now();
+    PollInput();
+    EndPhase(PHASE_INPUT, phase_start);
+    Step(delta);
+    if (print_frame_stats) {
+      PrintFrameStats();
+    }
+  }
+}
+
+// reads the window's keys, mouse buttons, gamepad, and cursor into the input
+// snapshot, without a window every input reads as released, and then runs
+// the input script
+void Project::PollInput() {
+  // cursor movement adds up until a step uses it
+  glm::vec2 cursor_offset = input_state.cursor_offset;
+  memset(&input_state, 0, sizeof(input_state));
+  if (window) {
+    ReadDevices(cursor_offset);
+  }
+  if (input_script) {
+    input_script(step_count, &input_state);
+  }
+}
+
+// cursor_offset is how far the cursor moved before the last poll that no
+// step has used yet
+// reads the window's keys, mouse buttons, gamepad, and cursor into
+// input_state
+void Project::ReadDevices(glm::vec2 cursor_offset) {
+  // Poll for and process events
+  glfwPollEvents();
+  for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; key++) {
+    input_state.keys[key] = glfwGetKey(window, key) == GLFW_PRESS;
+  }
+  for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++) {
+    input_state.mouse_buttons[button] =
+      glfwGetMouseButton(window, button) == GLFW_PRESS;
+  }
+  GLFWgamepadstate gp_state;
+  if (glfwGetGamepadState(GLFW_JOYSTICK_1, &gp_state)) {
+    for (int button = 0; button <= GLFW_GAMEPAD_BUTTON_LAST; button++) {
+      input_state.gamepad_buttons[button] =
+        gp_state.buttons[button] == GLFW_PRESS;
+    }
+    for (int axis = 0; axis <= GLFW_GAMEPAD_AXIS_LAST; axis++) {
+      input_state.gamepad_axes[axis] = gp_state.axes[axis];
+    }
+  }
+  double xpos, ypos;
+  glfwGetCursorPos(window, &xpos, &ypos);
+  glm::vec2 cursor_position(xpos, ypos);
+  input_state.cursor_offset =
+    cursor_offset + cursor_position - previos_cursor_position;
+  previos_cursor_position = cursor_position;
+}
+
+// delta is the length of the step in seconds
+// saves every transform's pose for interpolation and runs the update,
+// physics, late update, and destroy phases once, recording or replaying
+// its input and writing the world's hash if those were asked for
+void Project::Step(float delta) {
+  // a replayed step gets its input and length from the log
+  if (input_log.IsReplaying() && !input_log.Read(&input_state, &delta)) {
+    quit = true;
+    return;
+  }
+  if (input_log.IsRecording()) {
+    input_log.Write(input_state, delta);
+  }
+  Transforms().SavePreviousPoses();
+  std::chrono::steady_clock::time_point phase_start =
+    std::chrono::steady_clock::now();
+  UpdateObjects(delta);
+  phase_start = EndPhase(PHASE_UPDATE, phase_start);
+  UpdatePhysics(delta);
+  phase_start = EndPhase(PHASE_PHYSICS, phase_start);
+  LateUpdateObjects(delta);
+  phase_start = EndPhase(PHASE_LATE_UPDATE, phase_start);
+  TrashCollector();
+  EndPhase(PHASE_DESTROY, phase_start);
+  // the cursor only moves the first step after it was read
+  input_state.cursor_offset = glm::vec2(0, 0);
+  if (hash_log.is_open()) {
+    hash_log << step_count << " " << std::hex << HashWorld() << std::dec <<
+    "\n";
+  }
+  step_count++;
+}
+
+// filename is the file to write to
+// writes the step number and world hash after every step from now on, one
+// line each, so two runs can be diffed, throws if it can't be opened
+void Project::WriteHashes(const std::string &filename) {
+  if (hash_log.is_open()) {
+    hash_log.close();
+  }
+  hash_log.open(filename, std::ios::out | std::ios::trunc);
+  if (!hash_log.is_open()) {
+    throw std::string("could not open hash log ") + filename;
+  }
+}
+
+// returns a hash of every rigidbody in every scene and every projectile,
+// runs that played out the same have the same hash
+uint64_t Project::HashWorld() const {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (auto scene = rigidbodies.begin(); scene != rigidbodies.end();
+       scene++) {
+    const SceneList<RigidBody> &scene_rigidbodies = scene->second;
+    for (int i = 0; i < scene_rigidbodies.size(); i++) {
+      hash = scene_rigidbodies[i]->Hash(hash);
+    }
+  }
+  for (auto shots = projectiles.begin(); shots != projectiles.end();
+       shots++) {
+    hash = shots->second.Hash(hash);
+  }
+  return hash;
+}
+
+// delta is the fraction of a second a frame takes
+// runs Update on every rigidbody in the current scene, parents before their
+// children, in groups of jobs that run at once when there are worker
+// threads. Each update reads the others as they were at the start of the
+// step, so the result is the same on any number of threads. Rigidbodies
+// added during the phase are first updated next step. If an update
+// throws, the other jobs finish, what the wave asked for is thrown away,
+// and the exception is rethrown.
+void Project::UpdateObjects(float delta) {
+  SceneList<RigidBody> &scene_rigidbodies = rigidbodies[current_scene];
+  // the jobs only read the broadphase so it is resized first
+  SceneBroadphase();
+  int count = scene_rigidbodies.size();
+  for (int i = 0; i < update_waves.size(); i++) {
+    update_waves[i].clear();
+  }
+  for (int i = 0; i < count; i++) {
+    RigidBody* rb = scene_rigidbodies[i];
+    int depth = 0;
+    for (GameObject* up = rb->GetParent(); up; up = up->GetParent()) {
+      depth++;
+    }
+    if (depth >= update_waves.size()) {
+      update_waves.resize(depth + 1);
+    }
+    update_waves[depth].push_back(rb);
+  }
+  for (int wave = 0; wave < update_waves.size(); wave++) {
+    std::vector<RigidBody*> &bodies = update_waves[wave];
+    // jobs always cover the same rigidbodies however many threads there
+    // are, so their commands run in the same order
+    int num_jobs = (bodies.size() + UPDATE_JOB_SIZE - 1) / UPDATE_JOB_SIZE;
+    if (update_commands.size() < num_jobs) {
+      update_commands.resize(num_jobs);
+    }
+    auto update_job = [&](int begin, int end) {
+      UpdateScope scope(&update_commands[begin / UPDATE_JOB_SIZE]);
+      for (int i = begin; i < end; i++) {
+        SetUpdatingTransform(bodies[i]->GetTransform());
+        bodies[i]->Update(delta);
       }
-      glPushMatrix();
-        // std::cout << *objects[rigidbodies[257]] << std::endl;
-        // Draw/Update Rigid Bodies
-        for (int i = 0; i < rigidbodies[current_scene].size(); i++) {
-          // if (WithInRender(rigidbodies[i]->GetPosition())) {
-            RigidBody* rb =
-            dynamic_cast<RigidBody*>(objects[rigidbodies[current_scene][i]]);
-            if (rb) {
-              rb->Update(delta);
-              // std::cout << i+1 << "/" << rigidbodies.size() << std::endl;
-              rb->Draw();
-            }
-          // }
+    };
+    try {
+      if (jobs) {
+        jobs->ParallelFor(bodies.size(), UPDATE_JOB_SIZE, update_job);
+      } else {
+        for (int begin = 0; begin < bodies.size(); begin += UPDATE_JOB_SIZE) {
+          update_job(begin, std::min(begin + UPDATE_JOB_SIZE,
+                                     static_cast<int>(bodies.size())));
         }
-      glPopMatrix();
-    glPopMatrix();
+      }
+    } catch (...) {
+      // half a wave's commands would run with the next step's
+      for (int i = 0; i < num_jobs; i++) {
+        update_commands[i].Clear();
+      }
+      throw;
+    }
+    for (int i = 0; i < num_jobs; i++) {
+      update_commands[i].Execute();
+    }
+    // children start from where their parents ended up
+    PropagateTransforms();
+  }
+  // rigidbodies the jobs' commands added aren't in a wave, they get their
+  // first update next step, once they are in the start of step snapshot
+}
+
+// delta is the fraction of a second a frame takes
+// moves attached objects after their parents and then moves and collides the
+// current scene's projectiles
+void Project::UpdatePhysics(float delta) {
+  PropagateTransforms();
+  auto shots = projectiles.find(current_scene);
+  if (shots != projectiles.end()) {
+    shots->second.Update(this, delta);
+  }
+}
+
+// delta is the fraction of a second a frame takes
+// runs Update on the current scene's cameras and uis, which follow what the
+// rigidbodies did, and centers the render box on the active camera
+void Project::LateUpdateObjects(float delta) {
+  SceneList<Camera> &scene_cameras = cameras[current_scene];
+  for (int i = 0; i < scene_cameras.size(); i++) {
+    scene_cameras[i]->Update(delta);
+  }
+  SceneList<UI> &scene_uis = uis[current_scene];
+  for (int i = 0; i < scene_uis.size(); i++) {
+    scene_uis[i]->Update(delta);
+  }
+  Camera* cam = GetActiveCamera();
+  if (cam) {
+    center = cam->GetPosition();
+  }
+}
 
-    // glDisable(GL_DEPTH_TEST);
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    float ratio = width/static_cast<float>(height);
-    glOrtho(-ratio, ratio, -1, 1, 0, render_distance);
-    glClear(GL_DEPTH_BUFFER_BIT);
+// ratio is the window's width over its height
+// works out the active camera's frustum and which rigidbodies in the current
+// scene are in it, and counts the drawn and culled ones in render_stats
+void Project::CullObjects(float ratio) {
+  // with no camera enabled the view is the clip box
+  Camera* cam = GetActiveCamera();
+  view_frustum = cam ? cam->GetFrustum(ratio) : MakeFrustum(glm::mat4(1.0f));
+  SceneList<RigidBody> &scene_rigidbodies = rigidbodies[current_scene];
+  int count = scene_rigidbodies.size();
+  for (int axis = 0; axis < 3; axis++) {
+    cull_min[axis].resize(count);
+    cull_max[axis].resize(count);
+  }
+  cull_visible.resize(count);
+  for (int i = 0; i < count; i++) {
+    AABB bounds = scene_rigidbodies[i]->GetWorldBounds();
+    for (int axis = 0; axis < 3; axis++) {
+      cull_min[axis][i] = bounds.min[axis];
+      cull_max[axis][i] = bounds.max[axis];
+    }
+  }
+  // the margin keeps things that animate past their bounding box, like
+  // bobbing collectables, from popping at the edges of the screen
+  const float* minimum[3] = {cull_min[0].data(), cull_min[1].data(),
+                             cull_min[2].data()};
+  const float* maximum[3] = {cull_max[0].data(), cull_max[1].data(),
+                             cull_max[2].data()};
+  CullBoxes(view_frustum, minimum, maximum, count, FRUSTUM_CULL_MARGIN,
+            cull_visible.data());
+  render_stats.drawn = 0;
+  for (int i = 0; i < count; i++) {
+    render_stats.drawn += cull_visible[i];
+  }
+  render_stats.culled = count - render_stats.drawn;
+}
+
+// width and height are the size of the window's framebuffer
+// draws the rigidbodies CullObjects left visible, the projectiles, tiles,
+// and uis of the current scene and swaps the window's buffers
+void Project::Render(int width, int height) {
+  // Set the rendering viewport location and dimensions
+  glViewport(0, 0, width, height);
+  float ratio = width/static_cast<float>(height);
+
+  // Create The Camera Frustum
+  // Enable Depth
+  glEnable(GL_DEPTH_TEST);
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  Camera* cam = GetActiveCamera();
+  if (cam) {
+    cam->MultProjectionMatrix(width, height);
+  }
 
-    glMatrixMode(GL_MODELVIEW);
+  // Clear the color buffer
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  // Draw the rigid bodies
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+    // Transform The Camera
+    if (cam) {
+      cam->MultViewMatrix();
+    }
     glPushMatrix();
-      // Draw UI
-      for (int i = 0; i < uis[current_scene].size(); i++) {
-        UI* ui = dynamic_cast<UI*>(objects[uis[current_scene][i]]);
-        if (ui) {
-          ui->SetScreenRatio(ratio);
-          ui->Update(delta);
-          ui->Draw();
+      // Draw the Rigid Bodies the camera can see
+      SceneList<RigidBody> &scene_rigidbodies = rigidbodies[current_scene];
+      for (int i = 0; i < scene_rigidbodies.size(); i++) {
+        if (cull_visible[i]) {
+          scene_rigidbodies[i]->Draw();
         }
       }
+      // Draw Projectiles
+      auto shots = projectiles.find(current_scene);
+      if (shots != projectiles.end()) {
+        shots->second.Draw((1 - interpolation) * delta);
+      }
+      // Draw Tiles
+      auto tiles = tile_grids.find(current_scene);
+      if (tiles != tile_grids.end()) {
+        tiles->second.Draw(center, render_distance);
+      }
     glPopMatrix();
+  glPopMatrix();
 
-    TrashCollector();
+  // glDisable(GL_DEPTH_TEST);
+  glMatrixMode(GL_PROJECTION);
+  glLoadIdentity();
+  glOrtho(-ratio, ratio, -1, 1, 0, render_distance);
+  glClear(GL_DEPTH_BUFFER_BIT);
 
-    double xpos, ypos;
-    glfwGetCursorPos(window, &xpos, &ypos);
-    glm::vec2 cursor_position(xpos, ypos);
-    previos_cursor_position = cursor_position;
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+    // Draw UI
+    SceneList<UI> &scene_uis = uis[current_scene];
+    for (int i = 0; i < scene_uis.size(); i++) {
+      UI* ui = scene_uis[i];
+      ui->SetScreenRatio(ratio);
+      ui->Draw();
+    }
+  glPopMatrix();
 
-    // Swap front and back buffers
-    glfwSwapBuffers(window);
+  // Swap front and back buffers
+  glfwSwapBuffers(window);
+}
 
-    // Poll for and process events
-    glfwPollEvents();
+// prints the last frame's drawn and culled counts and how long each phase
+// took
+void Project::PrintFrameStats() {
+  const char* names[NUM_FRAME_PHASES] = {"input", "update", "physics",
+                                         "late update", "cull", "render",
+                                         "destroy"};
+  std::cout << "drawn: " << render_stats.drawn << " culled: " <<
+  render_stats.culled;
+  for (int i = 0; i < NUM_FRAME_PHASES; i++) {
+    std::cout << " " << names[i] << ": " << phase_times[i] << "ms";
+  }
+  std::cout << std::endl;
+}
 
-    // Make the game run a 60FPS
-    ticks++;
-    time_t end_time = time(NULL);
-    if (end_time != start_time) {
-      delta = 1.0f/ticks;
-      ticks = 0;
-    }
+// count is how many threads to run the update phase on, counting the one
+// calling GameLoop
+// starts or stops worker threads, with more than one thread Update runs on
+// many rigidbodies at once. With any number Update may only change its own
+// object and its children and sees the others as they were at the start of
+// the step, anything else, like adding, removing, or hurting objects, has
+// to go through Defer. Spawning projectiles and removing objects do this
+// themselves. Tags can be named from any thread, interning takes a lock,
+// so updates should make their TagMasks once, like in their constructor,
+// instead of passing tag names every step.
+void Project::SetWorkerThreads(int count) {
+  delete jobs;
+  jobs = nullptr;
+  if (count > 1) {
+    jobs = new JobSystem(count);
+  }
+}
+
+// command is a change to shared state
+// runs command now, or from an update once its group of rigidbodies is
+// done in the order the rigidbodies are in, rigidbodies a command adds
+// are first updated next step
+void Project::Defer(std::function<void()> command) {
+  CommandBuffer* commands = RecordingCommands();
+  if (commands) {
+    commands->Push(std::move(command));
+  } else {
+    command();
   }
 }
 
 // camera is a pointer to a Camera object
 // adds camera to cameras and returns its index
 int Project::AddCamera(Camera* camera) {
+  if (RecordingCommands()) {
+    throw std::string("game objects can only be added from an update through "
+                      "Defer");
+  }
   if (!SceneExists(current_scene)) {
     AddScene(current_scene);
   }
-  cameras[current_scene].push_back(current_id);
-  objects[current_id] = camera;
+  camera->id = objects.Insert(camera);
+  cameras[current_scene].Add(camera);
   camera->project = this;
-  camera->id = current_id;
-  current_id++;
   return camera->id;
 }
 
 // id is an id in objects
 // if id is a camera is activates it
 void Project::ActivateCamera(int id) {
-  Camera* new_cam = dynamic_cast<Camera*>(objects[id]);
-  if (new_cam) {
+  GameObject* obj = GetObject(id);
+  SceneList<Camera> &scene_cameras = cameras[current_scene];
+  // only the current scene's cameras are in its camera list
+  if (obj && obj->scene_list == &scene_cameras) {
+    Camera* new_cam = scene_cameras[obj->scene_index];
     // disable all cameras
-    for (int i = 0; i < cameras.size(); i++) {
-      Camera* cam = dynamic_cast<Camera*>(objects[cameras[current_scene][i]]);
-      cam->enabled = false;
+    for (int i = 0; i < scene_cameras.size(); i++) {
+      scene_cameras[i]->enabled = false;
     }
     // enable the new camera
     new_cam->enabled = true;
@@ -239,28 +681,35 @@ void Project::ActivateCamera(int id) {
 // create a new rigidbody to rigidbodies with model as its model
 // and return its index
 int Project::AddRigidBody(RigidBody* rigidbody) {
+  if (RecordingCommands()) {
+    throw std::string("game objects can only be added from an update through "
+                      "Defer");
+  }
   if (!SceneExists(current_scene)) {
     AddScene(current_scene);
   }
-  rigidbodies[current_scene].push_back(current_id);
-  objects[current_id] = rigidbody;
+  rigidbody->id = objects.Insert(rigidbody);
+  rigidbodies[current_scene].Add(rigidbody);
   rigidbody->project = this;
-  rigidbody->id = current_id;
-  current_id++;
+  broadphase[current_scene].Insert(rigidbody->id, rigidbody->GetPosition());
+  bounding_volumes[current_scene].Insert(rigidbody->id,
+                                         rigidbody->GetWorldBounds());
   return rigidbody->id;
 }
 
 // ui is a pointer to a UI
 // adds ui to objects and puts its id in uis
-int Project::AddUI(GameObject* ui) {
+int Project::AddUI(UI* ui) {
+  if (RecordingCommands()) {
+    throw std::string("game objects can only be added from an update through "
+                      "Defer");
+  }
   if (!SceneExists(current_scene)) {
     AddScene(current_scene);
   }
-  uis[current_scene].push_back(current_id);
-  objects[current_id] = ui;
+  ui->id = objects.Insert(ui);
+  uis[current_scene].Add(ui);
   ui->project = this;
-  ui->id = current_id;
-  current_id++;
   return ui->id;
 }
 
@@ -279,6 +728,8 @@ bool Project::AddScene(std::string scene) {
     cameras.insert({scene, {}});
     rigidbodies.insert({scene, {}});
     uis.insert({scene, {}});
+    broadphase.insert({scene, SpatialHash(collision_radius)});
+    bounding_volumes.insert({scene, AABBTree()});
     rv = true;
   }
   return rv;
@@ -293,55 +744,71 @@ void Project::SetCurrentScene(std::string scene) {
 }
 
 // index is a position in rigidbodies
-// returns a pointer to the rigidbody at index in rigidbodies
+// returns a pointer to the rigidbody at index in rigidbodies or nullptr if
+// there isn't one, like for TILE_GRID_ID
 GameObject * Project::GetObject(int index) {
-  return objects[index];
+  GameObject** found = objects.Find(index);
+  return found ? *found : nullptr;
+}
+
+// origin is where tile (0, 0) sits, width and depth are how many cells the
+// grid has along x and z, and model is drawn for every tile
+// replaces the current scene's tile grid with an empty one and returns it
+// so tiles can be added
+TileGrid* Project::AddTileGrid(glm::vec3 origin, int width, int depth,
+                               ModelHandle model) {
+  if (!SceneExists(current_scene)) {
+    AddScene(current_scene);
+  }
+  TileGrid &grid = tile_grids[current_scene];
+  grid.Initialize(origin, width, depth, model);
+  return &grid;
+}
+
+// returns the current scene's tile grid or nullptr if it doesn't have one
+TileGrid* Project::GetTileGrid() {
+  auto found = tile_grids.find(current_scene);
+  if (found == tile_grids.end()) {
+    return nullptr;
+  }
+  return &found->second;
+}
+
+// returns the current scene's projectile system, it is made the first time
+// it is asked for
+ProjectileSystem* Project::GetProjectiles() {
+  return &projectiles[current_scene];
 }
 
 // input is the name of the input in vector_inputs
 // returns a vec2 with a maximum magnitude of 1
 glm::vec2 Project::GetVectorInput(std::string input) {
   glm::vec2 rv(0, 0);
-  GLFWgamepadstate gp_state;
-  glfwGetGamepadState(GLFW_JOYSTICK_1, &gp_state);
   for (auto const& in : vector_inputs[input]) {
     switch (in.first) {
       case ENGINE_GAMEPAD:
-        rv.x += static_cast<int>(gp_state.buttons[in.second[1]] == GLFW_PRESS) -
-                static_cast<int>(gp_state.buttons[in.second[0]] == GLFW_PRESS);
-        rv.y += static_cast<int>(gp_state.buttons[in.second[3]] == GLFW_PRESS) -
-                static_cast<int>(gp_state.buttons[in.second[2]] == GLFW_PRESS);
+        rv.x += input_state.gamepad_buttons[in.second[1]] -
+                input_state.gamepad_buttons[in.second[0]];
+        rv.y += input_state.gamepad_buttons[in.second[3]] -
+                input_state.gamepad_buttons[in.second[2]];
         break;
       case ENGINE_KEYBOARD:
-        rv.x +=
-        static_cast<int>(glfwGetKey(window, in.second[1]) == GLFW_PRESS) -
-        static_cast<int>(glfwGetKey(window, in.second[0]) == GLFW_PRESS);
-        rv.y +=
-        static_cast<int>(glfwGetKey(window, in.second[3]) == GLFW_PRESS) -
-        static_cast<int>(glfwGetKey(window, in.second[2]) == GLFW_PRESS);
+        rv.x += input_state.keys[in.second[1]] - input_state.keys[in.second[0]];
+        rv.y += input_state.keys[in.second[3]] - input_state.keys[in.second[2]];
         break;
       case ENGINE_MOUSE:
-        rv.x +=
-        static_cast<int>
-        (glfwGetMouseButton(window, in.second[1]) == GLFW_PRESS) -
-        static_cast<int>
-        (glfwGetMouseButton(window, in.second[0]) == GLFW_PRESS);
-        rv.y +=
-        static_cast<int>
-        (glfwGetMouseButton(window, in.second[3]) == GLFW_PRESS) -
-        static_cast<int>
-        (glfwGetMouseButton(window, in.second[2]) == GLFW_PRESS);
+        rv.x += input_state.mouse_buttons[in.second[1]] -
+                input_state.mouse_buttons[in.second[0]];
+        rv.y += input_state.mouse_buttons[in.second[3]] -
+                input_state.mouse_buttons[in.second[2]];
         break;
       case ENGINE_AXIS:
-        rv.x += gp_state.axes[in.second[0]];
-        rv.y -= gp_state.axes[in.second[1]];
+        rv.x += input_state.gamepad_axes[in.second[0]];
+        rv.y -= input_state.gamepad_axes[in.second[1]];
         break;
       case ENGINE_CURSOR:
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        glm::vec2 cursor_position(xpos, ypos);
-        glm::vec2 cursor_offset = cursor_position - previos_cursor_position;
-        cursor_offset = cursor_offset * (1.0f/mouse_sensitivity);
+        glm::vec2 cursor_offset =
+          input_state.cursor_offset * (1.0f/mouse_sensitivity);
         rv.x += cursor_offset[in.second[0]];
         rv.y += cursor_offset[in.second[1]];
         break;
@@ -359,21 +826,19 @@ glm::vec2 Project::GetVectorInput(std::string input) {
 // returns a bool whether that button is being pressed
 bool Project::GetButtonInput(std::string input) {
   bool rv = false;
-  GLFWgamepadstate gp_state;
-  glfwGetGamepadState(GLFW_JOYSTICK_1, &gp_state);
   for (auto const& in : button_inputs[input]) {
     switch (in.first) {
       case ENGINE_AXIS:
-        rv = (rv || (gp_state.axes[in.second] > 0));
+        rv = (rv || (input_state.gamepad_axes[in.second] > 0));
         break;
       case ENGINE_MOUSE:
-        rv = (rv || (glfwGetMouseButton(window, in.second) == GLFW_PRESS));
+        rv = (rv || input_state.mouse_buttons[in.second]);
         break;
       case ENGINE_GAMEPAD:
-        rv = (rv || (gp_state.buttons[in.second] == GLFW_PRESS));
+        rv = (rv || input_state.gamepad_buttons[in.second]);
         break;
       case ENGINE_KEYBOARD:
-        rv = (rv || (glfwGetKey(window, in.second) == GLFW_PRESS));
+        rv = (rv || input_state.keys[in.second]);
         break;
     }
   }
@@ -383,66 +848,213 @@ bool Project::GetButtonInput(std::string input) {
 // start and end are positions in 3d space and ignore is a rigidbody id
 // to ignore
 // returns the position of the first intersection along the line from start to
-// end of all rigidbodies and -1 if there are no intersections
+// end of all rigidbodies and tiles and -1 if there are no intersections
 float Project::RayCast(glm::vec3 start, glm::vec3 end,
 std::vector<std::string> ignore) {
-  float rv = -1;
-  if (rigidbodies[current_scene].size() > 0) {
-    for (int i = 0; i < rigidbodies[current_scene].size(); i++) {
-      if (!ShouldIgnore(objects[rigidbodies[current_scene][i]], ignore)) {
-        RigidBody* rb =
-        dynamic_cast<RigidBody*>(objects[rigidbodies[current_scene][i]]);
-        if (rb) {
-          float temp = rb->RayCast(start, end);
-          if (temp != -1) {
-            if (rv == -1 || temp < rv) {
-              rv = temp;
-            }
-          }
-        }
-      }
+  return RayCast(start, end, MakeTagMask(ignore));
+}
+
+// start and end are positions in 3d space and ignore is the tags to ignore
+// returns the position of the first intersection along the line from start to
+// end of all rigidbodies and tiles and -1 if there are no intersections
+float Project::RayCast(glm::vec3 start, glm::vec3 end, TagMask ignore) {
+  // the tree only visits boxes the segment passes through, nearest first
+  float rv = bounding_volumes[current_scene].RayCast(start, end, [&](int id) {
+    float distance = -1;
+    // only rigidbodies are in the tree
+    if (!ShouldIgnore(objects[id], ignore)) {
+      distance = objects[id]->RayCast(start, end);
+    }
+    return distance;
+  });
+  const TileGrid* tiles = CollidableTiles(ignore);
+  if (tiles) {
+    float tile_hit = tiles->RayCast(start, end);
+    if (tile_hit != -1 && (rv == -1 || tile_hit < rv)) {
+      rv = tile_hit;
     }
   }
   return rv;
 }
 
-// id is an index in rigidbodies, and ignore is a list of indices to ignore
-// returns if the rigidbody is colliding with another
+// start and end are positions in 3d space and ignore is a list of tags to
+// ignore
+// returns true if no rigidbody or tile is in the way between start and end
+bool Project::LineOfSight(glm::vec3 start, glm::vec3 end,
+std::vector<std::string> ignore) {
+  return LineOfSight(start, end, MakeTagMask(ignore));
+}
+
+// start and end are positions in 3d space and ignore is the tags to ignore
+// returns true if no rigidbody or tile is in the way between start and end
+bool Project::LineOfSight(glm::vec3 start, glm::vec3 end, TagMask ignore) {
+  // tiles are cheapest to walk so they go first
+  const TileGrid* tiles = CollidableTiles(ignore);
+  if (tiles && tiles->RayCast(start, end) != -1) {
+    return false;
+  }
+  // any hit will do, so the boxes along the segment are tested a few at a
+  // time without sorting them
+  return !bounding_volumes[current_scene].RayAny(start, end,
+  [&](const int* ids, int count) {
+    OBB boxes[RAYCAST_BATCH_SIZE];
+    int num_boxes = 0;
+    for (int i = 0; i < count; i++) {
+      if (!ShouldIgnore(objects[ids[i]], ignore)) {
+        boxes[num_boxes++] = objects[ids[i]]->GetOBB();
+      }
+    }
+    float hits[RAYCAST_BATCH_SIZE];
+    RayCastOBBBatch(start, end, boxes, num_boxes, hits);
+    for (int i = 0; i < num_boxes; i++) {
+      if (hits[i] != -1) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+// id is an index in objects, and ignore is a list of indices to ignore
+// returns the id of a rigidbody colliding with it, TILE_GRID_ID if it only
+// collides with a tile, or -1
 int Project::Collides(int id, std::vector<std::string> ignore) {
-  int rv = -1;
-  // std::cout << rv << std::endl;
+  return Collides(id, MakeTagMask(ignore));
+}
+
+// id is an index in objects, and ignore is the tags to ignore
+// returns the id of a rigidbody colliding with it, TILE_GRID_ID if it only
+// collides with a tile, or -1, the layer matrix is applied to its tags
+int Project::Collides(int id, TagMask ignore) {
   GameObject* me = objects[id];
-  for (int i = 0; i < rigidbodies[current_scene].size() && rv == -1; i++) {
-    if (!ShouldIgnore(objects[rigidbodies[current_scene][i]], ignore)
-    && rigidbodies[current_scene][i] != id &&
-    PointInBox(objects[rigidbodies[current_scene][i]]->GetPosition(),
-    me->GetPosition(), collision_radius)) {
-      GameObject* other = objects[rigidbodies[current_scene][i]];
-      if (me->Intersects(*other)) {
-        rv = other->id;
-        // std::cout << *me << " Collided with " << *other << std::endl;
-      }
+  ignore |= GetLayerIgnores(me->tags.GetMask());
+  return Collides(me->GetPosition(), me->GetOBB(), me->GetWorldBounds(), id,
+                  ignore);
+}
+
+// position is where the box is, box and bounds are the box in world space
+// and the axis aligned box around it, self is an id to skip or -1, and
+// ignore is the tags to ignore
+// returns the id of a rigidbody colliding with box, TILE_GRID_ID if it only
+// collides with a tile, or -1
+int Project::Collides(glm::vec3 position, const OBB &box, const AABB &bounds,
+int self, TagMask ignore) {
+  int rv = -1;
+  // only rigidbodies in the cells around me can be within collision_radius
+  SpatialHash &hash = SceneBroadphase();
+  // each thread has its own candidates so parallel updates can check at
+  // once
+  static thread_local std::vector<int> candidates;
+  static thread_local std::vector<OBB> candidate_boxes;
+  static thread_local std::vector<uint8_t> candidate_hits;
+  hash.Query(position, collision_radius, &candidates);
+
+  // keep the candidates that are not ignored and close enough, then test
+  // all of their boxes against mine at once
+  int count = 0;
+  candidate_boxes.resize(candidates.size());
+  for (int i = 0; i < candidates.size(); i++) {
+    GameObject* other = objects[candidates[i]];
+    if (candidates[i] != self && !ShouldIgnore(other, ignore) &&
+    PointInBox(other->GetPosition(), position, collision_radius)) {
+      candidates[count] = candidates[i];
+      candidate_boxes[count] = other->GetOBB();
+      count++;
     }
   }
+  candidate_hits.resize(count);
+  OverlapOBBBatch(box, candidate_boxes.data(), count, candidate_hits.data());
+  for (int i = 0; i < count && rv == -1; i++) {
+    if (candidate_hits[i]) {
+      rv = candidates[i];
+    }
+  }
+  // then the tiles under me, which have no object to return
+  const TileGrid* tiles = CollidableTiles(ignore);
+  if (rv == -1 && tiles &&
+      tiles->Overlaps(box, bounds, position, collision_radius)) {
+    rv = TILE_GRID_ID;
+  }
   return rv;
 }
 
 // id is an index in rigidbodies
 // removes that rigidbody from existance
 void Project::RemoveRigidBody(int id) {
-  trashcan.push_back(id);
+  Defer([this, id] {trashcan.push_back(id);});
+}
+
+// a and b are tags and ignore is whether they should pass through each
+// other, by default this is true
+// sets whether objects tagged a collide with objects tagged b in Collides
+void Project::IgnoreLayerCollision(const std::string &a, const std::string &b,
+bool ignore) {
+  int bit_a = InternTag(a);
+  int bit_b = InternTag(b);
+  if (ignore) {
+    layer_ignores[bit_a] |= TagMask(1) << bit_b;
+    layer_ignores[bit_b] |= TagMask(1) << bit_a;
+  } else {
+    layer_ignores[bit_a] &= ~(TagMask(1) << bit_b);
+    layer_ignores[bit_b] &= ~(TagMask(1) << bit_a);
+  }
+}
+
+// tags is the tags of something colliding
+// returns every tag the layer matrix says tags pass through
+TagMask Project::GetLayerIgnores(TagMask tags) const {
+  TagMask rv = 0;
+  for (int bit = 0; tags != 0; bit++, tags >>= 1) {
+    if (tags & 1) {
+      rv |= layer_ignores[bit];
+    }
+  }
+  return rv;
+}
+
+// object is a game object whose position, orientation, or bounding box
+// changed
+// keeps the broadphase and bounding volumes up to date with the object
+void Project::UpdateBroadphase(GameObject* object) {
+  CommandBuffer* commands = RecordingCommands();
+  if (commands) {
+    commands->Push([this, object] {UpdateBroadphase(object);});
+    return;
+  }
+  for (auto & hash : broadphase) {
+    if (hash.second.Update(object->id, object->GetPosition())) {
+      bounding_volumes[hash.first].Update(object->id,
+                                          object->GetWorldBounds());
+      break;
+    }
+  }
+}
+
+// minimum and maximum define a box in world space and ids is where to put
+// the results
+// fills ids with every rigidbody in the current scene whose bounds overlap
+// the box, from lowest to highest id
+void Project::QueryBox(glm::vec3 minimum, glm::vec3 maximum,
+                       std::vector<int>* ids) {
+  AABB box(minimum, maximum);
+  bounding_volumes[current_scene].Query(box, ids);
+  // the tree's boxes are padded so check the real bounds
+  ids->erase(std::remove_if(ids->begin(), ids->end(), [&](int id) {
+    return !objects[id]->GetWorldBounds().Overlaps(box);
+  }), ids->end());
+  std::sort(ids->begin(), ids->end());
 }
 
 // id is an index in rigidbodies
 // removes that rigidbody from existance
 void Project::RemoveCamera(int id) {
-  trashcan.push_back(id);
+  Defer([this, id] {trashcan.push_back(id);});
 }
 
 // Prints a readable list of all game objects
 void Project::PrintGameObjects() {
-  for (auto const& object : objects) {
-    std::cout << *object.second << std::endl;
+  for (GameObject* object : objects) {
+    std::cout << *object << std::endl;
   }
 }
 
@@ -450,13 +1062,15 @@ void Project::PrintGameObjects() {
 // Cleans up glfw/openGL
 Project::~Project() {
   // Delete all objects
-  for (auto const& obj : objects) {
-    trashcan.push_back(obj.first);
-  }
+  trashcan = objects.GetHandles();
   TrashCollector();
   // Clean up
-  glfwDestroyWindow(window);
-  glfwTerminate();
+  delete jobs;
+  // headless glfw was never started
+  if (window) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+  }
 }
 
 }  // namespace engine
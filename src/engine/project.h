@@ -7,7 +7,10 @@
 
 // C++/C Standard Libraby
 #include <GLFW/glfw3.h>
-#include <ctime>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -23,33 +26,168 @@
 #include "engine/constants.h"
 #include "engine/helper.h"
 #include "engine/ui.h"
+#include "engine/asset_registry.h"
+#include "engine/spatial_hash.h"
+#include "engine/aabb_tree.h"
+#include "engine/tile_grid.h"
+#include "engine/slot_map.h"
+#include "engine/scene_list.h"
+#include "engine/projectile_system.h"
+#include "engine/tags.h"
+#include "engine/frustum.h"
+#include "engine/input_state.h"
+#include "engine/input_log.h"
+#include "engine/job_system.h"
+#include "engine/command_buffer.h"
+#include "engine/headless.h"
 
 namespace engine {
 
+// RenderStats counts what the render pass did in the last frame
+struct RenderStats {
+  int drawn;
+  int culled;
+};
+
 class Project {
  private:
   std::string name;
-  int current_id;
-  std::map<std::string, std::vector<int>> cameras;
-  std::map<std::string, std::vector<int>> rigidbodies;
-  std::map<std::string, std::vector<int>> uis;
+  // each scene's game objects by kind, so the game loop never has to cast
+  std::map<std::string, SceneList<Camera>> cameras;
+  std::map<std::string, SceneList<RigidBody>> rigidbodies;
+  std::map<std::string, SceneList<UI>> uis;
   std::vector<std::string> scenes;
   std::string current_scene;
-  std::map<int, GameObject*> objects;
+  // objects owns every game object, ids are handles into it
+  SlotMap<GameObject*> objects;
   std::vector<int> trashcan;
+  // garbage holds the objects the trash collector unlinked until they are
+  // all deleted together
+  std::vector<GameObject*> garbage;
+  // moved_transforms is reused by PropagateTransforms
+  std::vector<int> moved_transforms;
+
+  // broadphase buckets each scene's rigidbodies by position so collision
+  // checks only look at nearby ones
+  std::map<std::string, SpatialHash> broadphase;
+
+  // bounding_volumes keeps each scene's rigidbodies in a tree of boxes for
+  // ray casts and box queries
+  std::map<std::string, AABBTree> bounding_volumes;
+
+  // tile_grids holds each scene's static tiles, like walls, which aren't
+  // game objects
+  std::map<std::string, TileGrid> tile_grids;
+
+  // jobs runs the update phase across threads when there is more than one,
+  // update_waves is the rigidbodies grouped by how many parents they have
+  // and update_commands is one command buffer per job
+  JobSystem* jobs;
+  std::vector<std::vector<RigidBody*>> update_waves;
+  std::vector<CommandBuffer> update_commands;
+
+  // UpdateScope makes the calling thread record into a job's command buffer
+  // while it lives and clears the recording buffer and updating transform
+  // when it goes, even if an update throws
+  struct UpdateScope {
+    explicit UpdateScope(CommandBuffer* commands) {
+      SetRecordingCommands(commands);
+    }
+    ~UpdateScope() {
+      SetUpdatingTransform(TRANSFORM_STORE_NULL);
+      SetRecordingCommands(nullptr);
+    }
+  };
+
+  // projectiles holds each scene's pool of bullets and other projectiles
+  std::map<std::string, ProjectileSystem> projectiles;
+  // center is the middle of the render box, the active camera's position
+  // after each step or the origin until there is one
   glm::vec3 center;
 
+  // view_frustum is the enabled camera's frustum for this frame, the cull
+  // phase gathers the world bounds of the scene's rigidbodies into the cull
+  // arrays one axis per array and the render phase only draws the ones left
+  // visible
+  Frustum view_frustum;
+  std::vector<float> cull_min[3];
+  std::vector<float> cull_max[3];
+  std::vector<uint8_t> cull_visible;
+  RenderStats render_stats;
+  // phase_times is how many milliseconds each frame phase took last frame,
+  // added up over every step that ran in it
+  double phase_times[NUM_FRAME_PHASES];
+
   GLFWwindow* window;
+  // headless is whether this runs without a window or OpenGL and quit is
+  // whether GameLoop should return after the current frame
+  bool headless;
+  bool quit;
+  // delta is the length of a simulation step in seconds and interpolation is
+  // how far the frame being drawn is between the last two steps
   float delta;
-  int ticks;
+  float interpolation;
+  // step_count is how many simulation steps have run
+  int step_count;
   glm::vec2 previos_cursor_position;
+  // input_state is the input snapshot the inputs are read from and
+  // input_script fills it in after the devices are read
+  InputState input_state;
+  std::function<void(int, InputState*)> input_script;
+  // input_log records or replays the input and length of every step and
+  // hash_log gets the world's hash after every step
+  InputLog input_log;
+  std::ofstream hash_log;
 
-  // type is a type_index and types is a list of type_indexs
-  // returns if type is in types
-  bool ShouldIgnore(GameObject* obj, std::vector<std::string> tags);
+  // floor_tag is the bit of the "floor" tag, which is never culled
+  TagMask floor_tag;
+  // layer_ignores[i] is the tags that things tagged with bit i pass through
+  TagMask layer_ignores[TAG_MAX];
 
-  // Run the trash collector
-  void TrashCollector();
+  // obj is a game object and ignore is the tags to ignore
+  // returns whether obj is outside the render box, unless it is the floor, or
+  // has a tag in ignore
+  bool ShouldIgnore(GameObject* obj, TagMask ignore);
+
+  // ignore is the tags to ignore
+  // returns the current scene's tile grid or nullptr if it has no tiles or
+  // they have a tag in ignore
+  const TileGrid* CollidableTiles(TagMask ignore);
+
+  // object is a game object
+  // takes object out of its scene list by moving the last item into its place
+  void RemoveFromSceneList(GameObject* object);
+
+  // returns the current scene's broadphase after resizing its cells to
+  // collision_radius if it changed
+  SpatialHash& SceneBroadphase();
+
+  // works out where every attached object ended up after its parents moved
+  // and updates the broadphase for the ones in this
+  void PropagateTransforms();
+
+  // returns the last enabled camera in the current scene or nullptr if there
+  // isn't one
+  Camera* GetActiveCamera();
+
+  // phase is a frame phase and start is when it started
+  // adds how long phase took to phase_times and returns the time it ended
+  std::chrono::steady_clock::time_point EndPhase(int phase,
+      std::chrono::steady_clock::time_point start);
+
+  // cursor_offset is how far the cursor moved before the last poll that no
+  // step has used yet
+  // reads the window's keys, mouse buttons, gamepad, and cursor into
+  // input_state
+  void ReadDevices(glm::vec2 cursor_offset);
+
+  // runs steps back to back, as fast as they can go, without drawing until
+  // Quit is called
+  void HeadlessLoop();
+
+  // prints the last frame's drawn and culled counts and how long each phase
+  // took
+  void PrintFrameStats();
 
  public:
   // Inputs
@@ -59,6 +197,17 @@ class Project {
   float mouse_sensitivity;
   float render_distance;
   float collision_radius;
+  // tick_rate is how many simulation steps run per second and
+  // max_catch_up_steps is the most that run in one frame, time past that is
+  // dropped so a long stall doesn't make the game spend frames catching up
+  float tick_rate;
+  int max_catch_up_steps;
+  // print_frame_stats is whether to print the drawn and culled counts and
+  // phase times every frame
+  bool print_frame_stats;
+
+  // assets shares models, materials, and textures between game objects
+  AssetRegistry assets;
 
   // Default Constructor
   Project();
@@ -68,12 +217,126 @@ class Project {
   // name member data is assigned pname
   explicit Project(std::string pname);
 
-  // initializes glwf and openGL for drawing
-  int Initialize();
+  // headless is whether to run without a window or OpenGL, by default this
+  // is false
+  // initializes glwf and openGL for drawing, or when headless makes every
+  // model, material, texture, and light skip OpenGL so the simulation can
+  // run on a machine without a display, returns 0 if it worked and -1 if it
+  // didn't
+  int Initialize(bool headless = false);
 
-  // runs the update and draw functions for all game objects
+  // returns whether this runs without a window or OpenGL
+  bool IsHeadless() const {return headless;}
+
+  // runs the update and draw functions for all game objects until the
+  // window is closed or Quit is called, headless it runs steps back to back
+  // without waiting for the clock
   void GameLoop();
 
+  // makes GameLoop return after the current frame
+  void Quit() {quit = true;}
+
+  // script is called with the number of steps run so far and the input
+  // snapshot, or is empty
+  // sets what fills in the input snapshot every time input is polled, after
+  // the devices are read, so input can be scripted without anyone playing
+  void SetInputScript(std::function<void(int, InputState*)> script) {
+    input_script = script;
+  }
+
+  // returns how many simulation steps have run
+  int GetStepCount() const {return step_count;}
+
+  // filename is the file to record to
+  // writes the input snapshot and length of every step from now on to
+  // filename so the session can be replayed, throws if it can't be opened
+  void RecordInput(const std::string &filename) {input_log.Record(filename);}
+
+  // filename is a log made by RecordInput
+  // steps use the input and length from filename instead of the devices
+  // and GameLoop returns once it runs out, throws if it can't be read
+  void ReplayInput(const std::string &filename) {input_log.Replay(filename);}
+
+  // filename is the file to write to
+  // writes the step number and world hash after every step from now on, one
+  // line each, so two runs can be diffed, throws if it can't be opened
+  void WriteHashes(const std::string &filename);
+
+  // returns a hash of every rigidbody in every scene and every projectile,
+  // runs that played out the same have the same hash
+  uint64_t HashWorld() const;
+
+  // Frame phases, GameLoop runs them in this order. The update, physics, late
+  // update, and destroy phases make up a simulation step, which runs
+  // tick_rate times a second no matter how fast frames are drawn. Only
+  // PollInput and Render use the window, the rest can run without one.
+
+  // reads the window's keys, mouse buttons, gamepad, and cursor into the input
+  // snapshot, without a window every input reads as released, and then runs
+  // the input script
+  void PollInput();
+
+  // delta is the length of the step in seconds
+  // saves every transform's pose for interpolation and runs the update,
+  // physics, late update, and destroy phases once, recording or replaying
+  // its input and writing the world's hash if those were asked for
+  void Step(float delta);
+
+  // delta is the fraction of a second a frame takes
+  // runs Update on every rigidbody in the current scene, parents before their
+  // children, in groups of jobs that run at once when there are worker
+  // threads. Each update reads the others as they were at the start of the
+  // step, so the result is the same on any number of threads. Rigidbodies
+  // added during the phase are first updated next step. If an update
+  // throws, the other jobs finish, what the wave asked for is thrown away,
+  // and the exception is rethrown.
+  void UpdateObjects(float delta);
+
+  // delta is the fraction of a second a frame takes
+  // moves attached objects after their parents and then moves and collides the
+  // current scene's projectiles
+  void UpdatePhysics(float delta);
+
+  // delta is the fraction of a second a frame takes
+  // runs Update on the current scene's cameras and uis, which follow what the
+  // rigidbodies did, and centers the render box on the active camera
+  void LateUpdateObjects(float delta);
+
+  // ratio is the window's width over its height
+  // works out the active camera's frustum and which rigidbodies in the current
+  // scene are in it, and counts the drawn and culled ones in render_stats
+  void CullObjects(float ratio);
+
+  // width and height are the size of the window's framebuffer
+  // draws the rigidbodies CullObjects left visible, the projectiles, tiles,
+  // and uis of the current scene and swaps the window's buffers, projectiles
+  // are drawn interpolation of the way through the last step
+  void Render(int width, int height);
+
+  // Run the trash collector
+  void TrashCollector();
+
+  // count is how many threads to run the update phase on, counting the one
+  // calling GameLoop
+  // starts or stops worker threads, with more than one thread Update runs on
+  // many rigidbodies at once. With any number Update may only change its own
+  // object and its children and sees the others as they were at the start of
+  // the step, anything else, like adding, removing, or hurting objects, has
+  // to go through Defer. Spawning projectiles and removing objects do this
+  // themselves. Tags can be named from any thread, interning takes a lock,
+  // so updates should make their TagMasks once, like in their constructor,
+  // instead of passing tag names every step.
+  void SetWorkerThreads(int count);
+
+  // returns how many threads the update phase runs on
+  int GetWorkerThreads() const {return jobs ? jobs->GetNumThreads() : 1;}
+
+  // command is a change to shared state
+  // runs command now, or from an update once its group of rigidbodies is
+  // done in the order the rigidbodies are in, rigidbodies a command adds
+  // are first updated next step
+  void Defer(std::function<void()> command);
+
   // Cameras
   // fov is in degrees and render_distance is a positve number > 0.1
   // creates a new camera in cameras and returns its index
@@ -90,7 +353,7 @@ class Project {
 
   // ui is a pointer to a UI
   // adds ui to objects and puts its id in uis
-  int AddUI(GameObject* ui);
+  int AddUI(UI* ui);
 
   // scene is a name of a scene
   // returns whether scene is in scenes
@@ -105,9 +368,24 @@ class Project {
   void SetCurrentScene(std::string scene);
 
   // index is a position in rigidbodies
-  // returns a pointer to the rigidbody at index in rigidbodies
+  // returns a pointer to the rigidbody at index in rigidbodies or nullptr if
+  // there isn't one, like for TILE_GRID_ID
   GameObject * GetObject(int index);
 
+  // origin is where tile (0, 0) sits, width and depth are how many cells the
+  // grid has along x and z, and model is drawn for every tile
+  // replaces the current scene's tile grid with an empty one and returns it
+  // so tiles can be added
+  TileGrid* AddTileGrid(glm::vec3 origin, int width, int depth,
+                        ModelHandle model);
+
+  // returns the current scene's tile grid or nullptr if it doesn't have one
+  TileGrid* GetTileGrid();
+
+  // returns the current scene's projectile system, it is made the first time
+  // it is asked for
+  ProjectileSystem* GetProjectiles();
+
   // input is the name of the input in vector_inputs
   // returns a vec2 with a maximum magnitude of 1
   glm::vec2 GetVectorInput(std::string input);
@@ -119,18 +397,68 @@ class Project {
   // start and end are positions in 3d space and ignore is a rigidbody id
   // to ignore
   // returns the position of the first intersection along the line from start to
-  // end of a rigidbosy
+  // end of a rigidbosy or tile
   float RayCast(glm::vec3 start, glm::vec3 end,
   std::vector<std::string> ignore);
 
+  // start and end are positions in 3d space and ignore is the tags to ignore
+  // returns the position of the first intersection along the line from start to
+  // end of all rigidbodies and tiles and -1 if there are no intersections
+  float RayCast(glm::vec3 start, glm::vec3 end, TagMask ignore);
+
+  // start and end are positions in 3d space and ignore is a list of tags to
+  // ignore
+  // returns true if no rigidbody or tile is in the way between start and end
+  bool LineOfSight(glm::vec3 start, glm::vec3 end,
+  std::vector<std::string> ignore);
+
+  // start and end are positions in 3d space and ignore is the tags to ignore
+  // returns true if no rigidbody or tile is in the way between start and end
+  bool LineOfSight(glm::vec3 start, glm::vec3 end, TagMask ignore);
+
   // id is an index in objects, and ignore is a list of indices to ignore
-  // returns if the rigidbody is colliding with another
+  // returns the id of a rigidbody colliding with it, TILE_GRID_ID if it only
+  // collides with a tile, or -1
   int Collides(int id, std::vector<std::string> ignore);
 
+  // id is an index in objects, and ignore is the tags to ignore
+  // returns the id of a rigidbody colliding with it, TILE_GRID_ID if it only
+  // collides with a tile, or -1, the layer matrix is applied to its tags
+  int Collides(int id, TagMask ignore);
+
+  // position is where the box is, box and bounds are the box in world space
+  // and the axis aligned box around it, self is an id to skip or -1, and
+  // ignore is the tags to ignore
+  // returns the id of a rigidbody colliding with box, TILE_GRID_ID if it only
+  // collides with a tile, or -1
+  int Collides(glm::vec3 position, const OBB &box, const AABB &bounds,
+               int self, TagMask ignore);
+
+  // a and b are tags and ignore is whether they should pass through each
+  // other, by default this is true
+  // sets whether objects tagged a collide with objects tagged b in Collides
+  void IgnoreLayerCollision(const std::string &a, const std::string &b,
+                            bool ignore = true);
+
+  // tags is the tags of something colliding
+  // returns every tag the layer matrix says tags pass through
+  TagMask GetLayerIgnores(TagMask tags) const;
+
   // id is an index in rigidbodies
   // removes that rigidbody from existance
   void RemoveRigidBody(int id);
 
+  // object is a game object whose position, orientation, or bounding box
+  // changed
+  // keeps the broadphase and bounding volumes up to date with the object
+  void UpdateBroadphase(GameObject* object);
+
+  // minimum and maximum define a box in world space and ids is where to put
+  // the results
+  // fills ids with every rigidbody in the current scene whose bounds overlap
+  // the box, from lowest to highest id
+  void QueryBox(glm::vec3 minimum, glm::vec3 maximum, std::vector<int>* ids);
+
   // id is an index in cameras
   // removes that camera from existance
   void RemoveCamera(int id);
@@ -142,6 +470,16 @@ class Project {
   // returns true is obj is in the render box
   bool WithInRender(glm::vec3 obj);
 
+  // returns how many rigidbodies were drawn and culled in the last frame
+  const RenderStats& GetRenderStats() const {return render_stats;}
+
+  // phase is a frame phase
+  // returns how many milliseconds phase took in the last frame
+  double GetPhaseTime(int phase) const {return phase_times[phase];}
+
+  // returns the input snapshot of the current frame
+  const InputState& GetInputState() const {return input_state;}
+
   // Deconstructor
   // Cleans up glfw/openGL
   ~Project();
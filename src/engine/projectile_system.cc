@@ -0,0 +1,268 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/projectile_system.h"
+#include "engine/project.h"
+
+namespace engine {
+
+// index is a live projectile
+// returns its bounding box in world space
+OBB ProjectileSystem::GetOBB(int index) const {
+  const ProjectileType &t = types[type[index]];
+  glm::mat3 rot = glm::toMat3(orientation[index]);
+  OBB box;
+  box.center = glm::vec3(position_x[index], position_y[index],
+                         position_z[index]) +
+               rot * ((t.bounding_box_min + t.bounding_box_max) * 0.5f);
+  box.half_extents = (t.bounding_box_max - t.bounding_box_min) * 0.5f;
+  for (int i = 0; i < 3; i++) {
+    box.axes[i] = rot[i];
+  }
+  return box;
+}
+
+// index is a live projectile
+// moves the last live projectile into index
+void ProjectileSystem::Despawn(int index) {
+  int last = count - 1;
+  position_x[index] = position_x[last];
+  position_y[index] = position_y[last];
+  position_z[index] = position_z[last];
+  velocity_x[index] = velocity_x[last];
+  velocity_y[index] = velocity_y[last];
+  velocity_z[index] = velocity_z[last];
+  age[index] = age[last];
+  type[index] = type[last];
+  dead[index] = dead[last];
+  orientation[index] = orientation[last];
+  count--;
+}
+
+// Default Constructor
+ProjectileSystem::ProjectileSystem() {
+  count = 0;
+  position_x.resize(PROJECTILE_POOL_SIZE);
+  position_y.resize(PROJECTILE_POOL_SIZE);
+  position_z.resize(PROJECTILE_POOL_SIZE);
+  velocity_x.resize(PROJECTILE_POOL_SIZE);
+  velocity_y.resize(PROJECTILE_POOL_SIZE);
+  velocity_z.resize(PROJECTILE_POOL_SIZE);
+  age.resize(PROJECTILE_POOL_SIZE);
+  type.resize(PROJECTILE_POOL_SIZE);
+  dead.resize(PROJECTILE_POOL_SIZE);
+  orientation.resize(PROJECTILE_POOL_SIZE);
+  transforms.resize(PROJECTILE_POOL_SIZE);
+  cells.reserve(PROJECTILE_POOL_SIZE);
+}
+
+// type is a kind of projectile
+// adds type and returns its index, if a type with the same name was
+// already added that index is returned instead and type is not used,
+// new types can't be added from an update
+int ProjectileSystem::AddType(const ProjectileType &type) {
+  int rv = GetType(type.name);
+  if (rv == -1) {
+    if (RecordingCommands()) {
+      throw "projectile type " + type.name +
+            " can't be added from an update";
+    }
+    rv = types.size();
+    types.push_back(type);
+    type_tags.push_back(MakeTagMask(type.tags));
+    type_ignores.push_back(MakeTagMask(type.ignore));
+    collides_with.push_back(~type_ignores.back());
+  }
+  return rv;
+}
+
+// name is the name of a type
+// returns the index of that type or -1 if it hasn't been added
+int ProjectileSystem::GetType(const std::string &name) const {
+  for (int i = 0; i < types.size(); i++) {
+    if (types[i].name == name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// type is a type index, position and orientation place the projectile in
+// the world, and velocity is in units per second
+// adds a projectile and returns whether there was room for it, from an
+// update it is added afterwards and this returns true
+bool ProjectileSystem::Spawn(int type, glm::vec3 position,
+                             glm::quat orientation, glm::vec3 velocity) {
+  CommandBuffer* commands = RecordingCommands();
+  if (commands) {
+    commands->PushSpawn({this, type, position, orientation, velocity});
+    return true;
+  }
+  if (count >= PROJECTILE_POOL_SIZE || type < 0 || type >= types.size()) {
+    return false;
+  }
+  position_x[count] = position.x;
+  position_y[count] = position.y;
+  position_z[count] = position.z;
+  velocity_x[count] = velocity.x;
+  velocity_y[count] = velocity.y;
+  velocity_z[count] = velocity.z;
+  age[count] = 0;
+  this->type[count] = type;
+  dead[count] = 0;
+  this->orientation[count] = orientation;
+  count++;
+  return true;
+}
+
+// project is the project the projectiles are in and delta is the fraction
+// of a second a frame takes
+// moves every projectile, then despawns the ones that are too old, left the
+// render box, hit a rigidbody or tile, or hit another projectile
+void ProjectileSystem::Update(Project* project, float delta) {
+  // Move, each loop walks straight through one or two arrays so the
+  // compiler can vectorize it
+  float* px = position_x.data();
+  float* py = position_y.data();
+  float* pz = position_z.data();
+  const float* vx = velocity_x.data();
+  const float* vy = velocity_y.data();
+  const float* vz = velocity_z.data();
+  float* ages = age.data();
+  for (int i = 0; i < count; i++) {
+    px[i] += vx[i] * delta;
+  }
+  for (int i = 0; i < count; i++) {
+    py[i] += vy[i] * delta;
+  }
+  for (int i = 0; i < count; i++) {
+    pz[i] += vz[i] * delta;
+  }
+  for (int i = 0; i < count; i++) {
+    ages[i] += delta;
+  }
+
+  // Collide with the world
+  for (int t = 0; t < types.size(); t++) {
+    collides_with[t] = ~(type_ignores[t] |
+                         project->GetLayerIgnores(type_tags[t]));
+  }
+  int num_live = count;
+  for (int i = 0; i < num_live; i++) {
+    const ProjectileType &t = types[type[i]];
+    glm::vec3 position(px[i], py[i], pz[i]);
+    dead[i] = ages[i] >= t.lifespan || !project->WithInRender(position);
+    if (!dead[i]) {
+      OBB box = GetOBB(i);
+      glm::vec3 extent(0, 0, 0);
+      for (int axis = 0; axis < 3; axis++) {
+        extent += glm::abs(box.axes[axis]) * box.half_extents[axis];
+      }
+      AABB bounds(box.center - extent, box.center + extent);
+      int hit = project->Collides(position, box, bounds, -1,
+                                  ~collides_with[type[i]]);
+      if (hit != -1) {
+        dead[i] = 1;
+        GameObject* other = project->GetObject(hit);
+        if (other) {
+          other->OnProjectileHit(type[i]);
+        }
+        if (t.on_hit) {
+          t.on_hit(hit);
+        }
+      }
+    }
+  }
+
+  // Collide with each other, only pairs close enough to touch get a box test.
+  // With cells as wide as that, a projectile can only touch ones in its own
+  // column or the next, no more than a row away, which are two runs of the
+  // sorted cells. Each pair is looked at once, from the one sorted first.
+  float radius = project->collision_radius;
+  float cell_size = std::max(radius, OBB_EPSILON);
+  cells.resize(num_live);
+  for (int i = 0; i < num_live; i++) {
+    cells[i].x = static_cast<int64_t>(std::floor(px[i] / cell_size));
+    cells[i].z = static_cast<int64_t>(std::floor(pz[i] / cell_size));
+    cells[i].index = i;
+  }
+  std::sort(cells.begin(), cells.end());
+  for (int a = 0; a < num_live; a++) {
+    const ProjectileCell &cell = cells[a];
+    int i = cell.index;
+    for (int column = 0; column < 2; column++) {
+      ProjectileCell first = {cell.x + column, cell.z - 1, -1};
+      ProjectileCell last = {cell.x + column, cell.z + 1, num_live};
+      int begin = column == 0 ? a + 1 :
+        std::lower_bound(cells.begin(), cells.end(), first) - cells.begin();
+      int end =
+        std::upper_bound(cells.begin(), cells.end(), last) - cells.begin();
+      for (int b = begin; b < end; b++) {
+        int j = cells[b].index;
+        if (std::abs(px[i] - px[j]) <= radius &&
+            std::abs(pz[i] - pz[j]) <= radius) {
+          CollidePair(i, j);
+        }
+      }
+    }
+  }
+
+  // Despawn from the back so every projectile moved into a hole has already
+  // been checked
+  for (int i = num_live - 1; i >= 0; i--) {
+    if (dead[i]) {
+      Despawn(i);
+    }
+  }
+}
+
+// i and j are live projectiles
+// despawns whichever of them the other stops if their boxes overlap
+void ProjectileSystem::CollidePair(int i, int j) {
+  bool i_stops = (collides_with[type[i]] & type_tags[type[j]]) != 0;
+  bool j_stops = (collides_with[type[j]] & type_tags[type[i]]) != 0;
+  if ((i_stops || j_stops) && OverlapOBB(GetOBB(i), GetOBB(j))) {
+    dead[i] |= i_stops;
+    dead[j] |= j_stops;
+  }
+}
+
+// hash is the hash to continue from
+// returns hash with the type, position, velocity, and age of every live
+// projectile mixed in
+uint64_t ProjectileSystem::Hash(uint64_t hash) const {
+  hash = HashBytes(&count, sizeof(count), hash);
+  size_t floats = count * sizeof(float);
+  hash = HashBytes(type.data(), count * sizeof(int), hash);
+  hash = HashBytes(position_x.data(), floats, hash);
+  hash = HashBytes(position_y.data(), floats, hash);
+  hash = HashBytes(position_z.data(), floats, hash);
+  hash = HashBytes(velocity_x.data(), floats, hash);
+  hash = HashBytes(velocity_y.data(), floats, hash);
+  hash = HashBytes(velocity_z.data(), floats, hash);
+  return HashBytes(age.data(), floats, hash);
+}
+
+// rewind is how many seconds back along their paths to draw them
+// draws every live projectile, one batch per type
+// make sure the matrix mode is GL_MODELVIEW
+void ProjectileSystem::Draw(float rewind) {
+  for (int t = 0; t < types.size(); t++) {
+    int num_transforms = 0;
+    for (int i = 0; i < count; i++) {
+      if (type[i] == t) {
+        glm::mat4 transform = glm::toMat4(orientation[i]);
+        transform[3] = glm::vec4(position_x[i] - velocity_x[i] * rewind,
+                                 position_y[i] - velocity_y[i] * rewind,
+                                 position_z[i] - velocity_z[i] * rewind, 1);
+        transforms[num_transforms++] = transform;
+      }
+    }
+    if (types[t].model) {
+      types[t].model->DrawBatch(transforms.data(), num_transforms);
+    }
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,158 @@
+#ifndef SRC_ENGINE_PROJECTILE_SYSTEM_H_
+#define SRC_ENGINE_PROJECTILE_SYSTEM_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// lib
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtx/quaternion.hpp"
+
+// src
+#include "engine/model.h"
+#include "engine/aabb_tree.h"
+#include "engine/obb.h"
+#include "engine/tags.h"
+#include "engine/constants.h"
+#include "engine/command_buffer.h"
+#include "engine/helper.h"
+
+namespace engine {
+
+// Forward declare Project
+class Project;
+
+// ProjectileType is everything the projectiles of one kind share
+struct ProjectileType {
+  std::string name;
+  ModelHandle model;
+  glm::vec3 bounding_box_min;
+  glm::vec3 bounding_box_max;
+  float lifespan;  // seconds
+  // tags are what other projectiles compare against their ignore lists and
+  // ignore is the tags this kind passes through
+  std::vector<std::string> tags;
+  std::vector<std::string> ignore;
+  // on_hit is called with the id Project::Collides returned when one of
+  // these hits a rigidbody or tile, after the rigidbody's OnProjectileHit,
+  // it may be empty
+  std::function<void(int)> on_hit;
+};
+
+// ProjectileSystem moves, collides, and draws short lived projectiles like
+// bullets without making a game object for each one. The pool is allocated
+// once with room for PROJECTILE_POOL_SIZE projectiles and the live ones are
+// kept packed at the front of each array, so spawning and despawning only
+// copy a few floats and never touch the heap.
+class ProjectileSystem {
+ private:
+  std::vector<ProjectileType> types;
+  // type_tags and type_ignores are each type's tags and ignore list as masks,
+  // collides_with is what each type hits this frame after the layer matrix
+  std::vector<TagMask> type_tags;
+  std::vector<TagMask> type_ignores;
+  std::vector<TagMask> collides_with;
+
+  // Hot data, one array per component
+  int count;
+  std::vector<float> position_x, position_y, position_z;
+  std::vector<float> velocity_x, velocity_y, velocity_z;
+  std::vector<float> age;
+  std::vector<int> type;
+  std::vector<uint8_t> dead;
+  // Cold data, only needed for collisions and drawing
+  std::vector<glm::quat> orientation;
+
+  // transforms is reused every frame to draw each type in one batch
+  std::vector<glm::mat4> transforms;
+
+  // ProjectileCell is the collision_radius wide cell on the xz plane a
+  // projectile is in, cells is every live one's sorted by cell so the ones
+  // that can touch each other are close together
+  struct ProjectileCell {
+    int64_t x, z;
+    int index;
+
+    // other is another projectile's cell
+    // returns whether this comes before other, by column, row, then index
+    bool operator<(const ProjectileCell &other) const {
+      if (x != other.x) {
+        return x < other.x;
+      }
+      if (z != other.z) {
+        return z < other.z;
+      }
+      return index < other.index;
+    }
+  };
+  std::vector<ProjectileCell> cells;
+
+  // i and j are live projectiles
+  // despawns whichever of them the other stops if their boxes overlap
+  void CollidePair(int i, int j);
+
+  // index is a live projectile
+  // returns its bounding box in world space
+  OBB GetOBB(int index) const;
+
+  // index is a live projectile
+  // moves the last live projectile into index
+  void Despawn(int index);
+
+ public:
+  // Default Constructor
+  ProjectileSystem();
+
+  // type is a kind of projectile
+  // adds type and returns its index, if a type with the same name was
+  // already added that index is returned instead and type is not used,
+  // new types can't be added from an update
+  int AddType(const ProjectileType &type);
+
+  // name is the name of a type
+  // returns the index of that type or -1 if it hasn't been added
+  int GetType(const std::string &name) const;
+
+  // type is a type index, position and orientation place the projectile in
+  // the world, and velocity is in units per second
+  // adds a projectile and returns whether there was room for it, from an
+  // update it is added afterwards and this returns true
+  bool Spawn(int type, glm::vec3 position, glm::quat orientation,
+             glm::vec3 velocity);
+
+  // returns how many projectiles are alive
+  int GetCount() const {return count;}
+
+  // project is the project the projectiles are in and delta is the fraction
+  // of a second a frame takes
+  // moves every projectile, then despawns the ones that are too old, left the
+  // render box, hit a rigidbody or tile, or hit another projectile
+  void Update(Project* project, float delta);
+
+  // rewind is how many seconds back along their paths to draw them
+  // draws every live projectile, one batch per type
+  // make sure the matrix mode is GL_MODELVIEW
+  void Draw(float rewind = 0);
+
+  // despawns every projectile
+  void Clear() {count = 0;}
+
+  // hash is the hash to continue from
+  // returns hash with the type, position, velocity, and age of every live
+  // projectile mixed in
+  uint64_t Hash(uint64_t hash) const;
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_PROJECTILE_SYSTEM_H_
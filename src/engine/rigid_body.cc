@@ -13,23 +13,17 @@ RigidBody::RigidBody(const Model *model) {
   tags.push_back("rigidbody");
 }
 
+// model is a handle to a shared model
+RigidBody::RigidBody(ModelHandle model) : RigidBody(model.get()) {
+  model_handle = model;
+}
+
 // draws the rigid body’s model with it’s current position and orientation.
 // make sure the matrix mode is GL_MODELVIEW
 void RigidBody::Draw() const {
-  // Covert the quaternion into something readable for glfw
-  glm::mat4 rot_mat = glm::toMat4(orientation);
-  glm::mat4 anim_rot_mat = glm::toMat4(animation_controller.GetOrientation());
-  glm::vec3 anim_pos = animation_controller.GetPosition();
-  glm::vec3 anim_scale = animation_controller.GetScale();
-
   glPushMatrix();
     // Apply Transformations
-    glTranslatef(position.x, position.y, position.z);
-    glTranslatef(anim_pos.x, anim_pos.y, anim_pos.z);
-    glMultMatrixf(glm::value_ptr(rot_mat));
-    glMultMatrixf(glm::value_ptr(anim_rot_mat));
-    glScalef(scale.x, scale.y, scale.z);
-    glScalef(anim_scale.x, anim_scale.y, anim_scale.z);
+    glMultMatrixf(glm::value_ptr(GetWorldMatrix()));
 
     // Set the color matrix based on color of rigid_body
     // std::vector<GLfloat> colors;
@@ -60,10 +54,22 @@ void RigidBody::SetColor(float r, float g, float b, float a) {
   color = c;
 }
 
+// returns the world matrix with the current animation applied on top of
+// the position, orientation, and scale
+glm::mat4 RigidBody::ComputeWorldMatrix() const {
+  // the animation's translation is in world space and its scale is applied
+  // after both rotations
+  return ComposeMatrix(GetPosition() + animation_controller.GetPosition(),
+                       GetOrientation() * animation_controller.GetOrientation(),
+                       GetScale() * animation_controller.GetScale());
+}
+
 // delta is the fraction of a second a frame takes
-// draws the rigid_body
+// plays the animation and marks the world matrix dirty if it moved this
 void RigidBody::Update(float delta) {
-  animation_controller.Update(delta);
+  if (animation_controller.Update(delta)) {
+    SetWorldMatrixDirty();
+  }
 }
 
 }  // namespace engine
@@ -22,6 +22,9 @@ namespace engine {
 class RigidBody : public GameObject {
  protected:
   const Model *model;
+
+  // model_handle keeps a shared model alive while this uses it
+  ModelHandle model_handle;
   glm::vec4 color = {1, 1, 1, 1};
   AnimationController animation_controller;
 
@@ -32,9 +35,16 @@ class RigidBody : public GameObject {
   // model is a pointer to a model
   explicit RigidBody(const Model *model);
 
+  // model is a handle to a shared model
+  explicit RigidBody(ModelHandle model);
+
   // draws the rigid body’s model with it’s current position and orientation.
   void Draw() const;
 
+  // returns the world matrix with the current animation applied on top of
+  // the position, orientation, and scale
+  glm::mat4 ComputeWorldMatrix() const;
+
   // color is a vector of size 4 representing rgba
   // sets the color member data to color
   void SetColor(glm::vec4 color);
@@ -44,7 +54,7 @@ class RigidBody : public GameObject {
   void SetColor(float r, float g, float b, float a);
 
   // delta is the fraction of a second a frame takes
-  // draws the rigid_body
+  // plays the animation and marks the world matrix dirty if it moved this
   void Update(float delta);
 };
 
@@ -0,0 +1,67 @@
+#ifndef SRC_ENGINE_SCENE_LIST_H_
+#define SRC_ENGINE_SCENE_LIST_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <vector>
+
+namespace engine {
+
+// SceneListBase lets a game object remove itself from whichever SceneList it
+// is in without knowing the list's type
+class SceneListBase {
+ public:
+  // Deconstructor
+  virtual ~SceneListBase() {}
+
+  // index is a position in this
+  // removes the item at index by moving the last item into its place
+  virtual void RemoveAt(int index) = 0;
+};
+
+// SceneList is a dense array of one kind of game object in one scene, so the
+// frame loop can update and draw them without casting. Every item remembers
+// its list and position in scene_list and scene_index.
+template <typename T>
+class SceneList : public SceneListBase {
+ private:
+  std::vector<T*> items;
+
+ public:
+  typedef typename std::vector<T*>::const_iterator const_iterator;
+
+  // item is a game object that isn't in a list
+  // appends item to this and remembers where it is
+  void Add(T* item) {
+    item->scene_list = this;
+    item->scene_index = items.size();
+    items.push_back(item);
+  }
+
+  // index is a position in this
+  // removes the item at index by moving the last item into its place
+  void RemoveAt(int index) {
+    T* last = items.back();
+    items[index] = last;
+    last->scene_index = index;
+    items.pop_back();
+  }
+
+  // returns how many items are in this
+  int size() const {return items.size();}
+
+  // i is a position in this
+  // returns the item at i
+  T* operator[](int i) const {return items[i];}
+
+  // iterate over the items in update order
+  const_iterator begin() const {return items.begin();}
+  const_iterator end() const {return items.end();}
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_SCENE_LIST_H_
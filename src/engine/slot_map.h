@@ -0,0 +1,184 @@
+#ifndef SRC_ENGINE_SLOT_MAP_H_
+#define SRC_ENGINE_SLOT_MAP_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// src
+#include "engine/constants.h"
+
+namespace engine {
+
+// SlotMap stores values in one dense array and hands out int handles for
+// them. A handle packs the index of its slot with the slot's generation, which
+// changes every time the slot is freed, so lookups and removals are O(1) and a
+// handle to a removed value is never mistaken for whatever reuses its slot.
+// Handles are never negative so -1 can still mean no object.
+template <typename T>
+class SlotMap {
+ private:
+  // Slot is where a handle's value is in values, or the next free slot when
+  // it is unused
+  struct Slot {
+    int dense;
+    int next_free;
+    int generation;
+  };
+
+  std::vector<Slot> slots;
+  std::vector<T> values;
+  // handles[i] is the handle of values[i]
+  std::vector<int> handles;
+  int free_list;
+
+  // handle is a handle
+  // returns the slot handle points to or nullptr if it's stale or invalid
+  const Slot* FindSlot(int handle) const;
+
+ public:
+  typedef typename std::vector<T>::iterator iterator;
+  typedef typename std::vector<T>::const_iterator const_iterator;
+
+  // Default Constructor
+  SlotMap() : free_list(SLOT_MAP_NULL) {}
+
+  // value is what to store
+  // adds value and returns its handle, throws a string exception if every
+  // index is in use
+  int Insert(const T &value);
+
+  // handle is a handle
+  // returns whether handle points to a value in this
+  bool Contains(int handle) const {return FindSlot(handle) != nullptr;}
+
+  // handle is a handle
+  // returns a pointer to handle's value or nullptr if it isn't in this
+  T* Find(int handle);
+  const T* Find(int handle) const;
+
+  // handle is a handle in this
+  // returns handle's value
+  T& operator[](int handle) {return values[slots[handle &
+                                     SLOT_MAP_INDEX_MASK].dense];}
+  const T& operator[](int handle) const {return values[slots[handle &
+                                                 SLOT_MAP_INDEX_MASK].dense];}
+
+  // handle is a handle
+  // removes handle's value by moving the last value into its place and
+  // returns whether it was in this
+  bool Remove(int handle);
+
+  // removes every value, old handles stay stale
+  void Clear();
+
+  // returns how many values are in this
+  int Size() const {return values.size();}
+
+  // returns the handle of every value in the same order as the values
+  const std::vector<int>& GetHandles() const {return handles;}
+
+  // iterate over the values in their dense order
+  iterator begin() {return values.begin();}
+  iterator end() {return values.end();}
+  const_iterator begin() const {return values.begin();}
+  const_iterator end() const {return values.end();}
+};
+
+// handle is a handle
+// returns the slot handle points to or nullptr if it's stale or invalid
+template <typename T>
+const typename SlotMap<T>::Slot* SlotMap<T>::FindSlot(int handle) const {
+  if (handle < 0) {
+    return nullptr;
+  }
+  int index = handle & SLOT_MAP_INDEX_MASK;
+  int generation = handle >> SLOT_MAP_INDEX_BITS;
+  if (index >= slots.size() || slots[index].dense == SLOT_MAP_NULL ||
+      slots[index].generation != generation) {
+    return nullptr;
+  }
+  return &slots[index];
+}
+
+// value is what to store
+// adds value and returns its handle, throws a string exception if every
+// index is in use
+template <typename T>
+int SlotMap<T>::Insert(const T &value) {
+  int index = free_list;
+  if (index != SLOT_MAP_NULL) {
+    free_list = slots[index].next_free;
+  } else {
+    if (slots.size() > SLOT_MAP_INDEX_MASK) {
+      throw std::string("SlotMap is full");
+    }
+    index = slots.size();
+    slots.push_back({SLOT_MAP_NULL, SLOT_MAP_NULL, 0});
+  }
+  Slot &slot = slots[index];
+  slot.dense = values.size();
+  slot.next_free = SLOT_MAP_NULL;
+  int handle = (slot.generation << SLOT_MAP_INDEX_BITS) | index;
+  values.push_back(value);
+  handles.push_back(handle);
+  return handle;
+}
+
+// handle is a handle
+// returns a pointer to handle's value or nullptr if it isn't in this
+template <typename T>
+T* SlotMap<T>::Find(int handle) {
+  const Slot* slot = FindSlot(handle);
+  return slot ? &values[slot->dense] : nullptr;
+}
+
+// handle is a handle
+// returns a pointer to handle's value or nullptr if it isn't in this
+template <typename T>
+const T* SlotMap<T>::Find(int handle) const {
+  const Slot* slot = FindSlot(handle);
+  return slot ? &values[slot->dense] : nullptr;
+}
+
+// handle is a handle
+// removes handle's value by moving the last value into its place and
+// returns whether it was in this
+template <typename T>
+bool SlotMap<T>::Remove(int handle) {
+  if (!Contains(handle)) {
+    return false;
+  }
+  int index = handle & SLOT_MAP_INDEX_MASK;
+  Slot &slot = slots[index];
+  int last = values.size() - 1;
+  if (slot.dense != last) {
+    values[slot.dense] = values[last];
+    handles[slot.dense] = handles[last];
+    slots[handles[last] & SLOT_MAP_INDEX_MASK].dense = slot.dense;
+  }
+  values.pop_back();
+  handles.pop_back();
+  slot.dense = SLOT_MAP_NULL;
+  slot.generation = (slot.generation + 1) & SLOT_MAP_GENERATION_MASK;
+  slot.next_free = free_list;
+  free_list = index;
+  return true;
+}
+
+// removes every value, old handles stay stale
+template <typename T>
+void SlotMap<T>::Clear() {
+  while (!handles.empty()) {
+    Remove(handles.back());
+  }
+}
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_SLOT_MAP_H_
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/spatial_hash.h"
+
+namespace engine {
+
+// x and z are cell coordinates
+// returns the key of the cell
+uint64_t SpatialHash::CellKey(int64_t x, int64_t z) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+         static_cast<uint32_t>(z);
+}
+
+// value is a coordinate on one axis
+// returns the cell coordinate value falls in
+int64_t SpatialHash::CellCoordinate(float value) const {
+  return static_cast<int64_t>(std::floor(value / cell_size));
+}
+
+// id is an object id and cell is a cell key
+// removes id from the cell and frees the cell if it is empty
+void SpatialHash::RemoveFromCell(int id, uint64_t cell) {
+  auto found = cells.find(cell);
+  if (found != cells.end()) {
+    std::vector<int> &ids = found->second;
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end()) {
+      *it = ids.back();
+      ids.pop_back();
+    }
+    if (ids.empty()) {
+      cells.erase(found);
+    }
+  }
+}
+
+// Default Constructor
+SpatialHash::SpatialHash() {
+  cell_size = 1.0f;
+}
+
+// cell_size is the width of each cell
+SpatialHash::SpatialHash(float cell_size) {
+  this->cell_size = cell_size;
+}
+
+// cell_size is the width of each cell
+// changes the cell size and moves every object into its new cell
+void SpatialHash::SetCellSize(float cell_size) {
+  this->cell_size = cell_size;
+  cells.clear();
+  for (auto & entry : entries) {
+    glm::vec3 p = entry.second.position;
+    entry.second.cell = CellKey(CellCoordinate(p.x), CellCoordinate(p.z));
+    cells[entry.second.cell].push_back(entry.first);
+  }
+}
+
+// id is an object id and position is where it is
+// adds id to the cell containing position
+void SpatialHash::Insert(int id, glm::vec3 position) {
+  if (!Update(id, position)) {
+    Entry entry;
+    entry.cell = CellKey(CellCoordinate(position.x),
+                         CellCoordinate(position.z));
+    entry.position = position;
+    entries[id] = entry;
+    cells[entry.cell].push_back(id);
+  }
+}
+
+// id is an object id and position is where it moved to
+// moves id to the cell containing position and returns false if id isn't
+// in this
+bool SpatialHash::Update(int id, glm::vec3 position) {
+  auto found = entries.find(id);
+  if (found == entries.end()) {
+    return false;
+  }
+  Entry &entry = found->second;
+  entry.position = position;
+  uint64_t cell = CellKey(CellCoordinate(position.x),
+                          CellCoordinate(position.z));
+  if (cell != entry.cell) {
+    RemoveFromCell(id, entry.cell);
+    cells[cell].push_back(id);
+    entry.cell = cell;
+  }
+  return true;
+}
+
+// id is an object id
+// takes id out of this
+void SpatialHash::Remove(int id) {
+  auto found = entries.find(id);
+  if (found != entries.end()) {
+    RemoveFromCell(id, found->second.cell);
+    entries.erase(found);
+  }
+}
+
+// returns whether id is in this
+bool SpatialHash::Contains(int id) const {
+  return entries.find(id) != entries.end();
+}
+
+// center is a position, size is half the width of a square around it, and
+// ids is where to put the results
+// fills ids with every object in a cell the square touches, sorted from
+// lowest to highest handle so callers see them in the same order however
+// the cells are laid out, handles are reused so this isn't the order they
+// were added in
+void SpatialHash::Query(glm::vec3 center, float size,
+                        std::vector<int>* ids) const {
+  ids->clear();
+  int64_t min_x = CellCoordinate(center.x - size);
+  int64_t max_x = CellCoordinate(center.x + size);
+  int64_t min_z = CellCoordinate(center.z - size);
+  int64_t max_z = CellCoordinate(center.z + size);
+  for (int64_t x = min_x; x <= max_x; x++) {
+    for (int64_t z = min_z; z <= max_z; z++) {
+      auto found = cells.find(CellKey(x, z));
+      if (found != cells.end()) {
+        ids->insert(ids->end(), found->second.begin(), found->second.end());
+      }
+    }
+  }
+  std::sort(ids->begin(), ids->end());
+}
+
+// empties this
+void SpatialHash::Clear() {
+  cells.clear();
+  entries.clear();
+}
+
+}  // namespace engine
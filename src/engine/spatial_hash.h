@@ -0,0 +1,91 @@
+#ifndef SRC_ENGINE_SPATIAL_HASH_H_
+#define SRC_ENGINE_SPATIAL_HASH_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// lib
+#include "glm/vec3.hpp"
+
+namespace engine {
+
+// SpatialHash buckets object ids into a uniform grid of square cells on the
+// xz plane so objects near a point can be found without looking at every
+// object. Only the cells an object enters and leaves are touched when it moves.
+class SpatialHash {
+ private:
+  // Entry is where an object was last placed
+  struct Entry {
+    uint64_t cell;
+    glm::vec3 position;
+  };
+
+  float cell_size;
+  std::unordered_map<uint64_t, std::vector<int>> cells;
+  std::unordered_map<int, Entry> entries;
+
+  // x and z are cell coordinates
+  // returns the key of the cell
+  static uint64_t CellKey(int64_t x, int64_t z);
+
+  // value is a coordinate on one axis
+  // returns the cell coordinate value falls in
+  int64_t CellCoordinate(float value) const;
+
+  // id is an object id and cell is a cell key
+  // removes id from the cell and frees the cell if it is empty
+  void RemoveFromCell(int id, uint64_t cell);
+
+ public:
+  // Default Constructor
+  SpatialHash();
+
+  // cell_size is the width of each cell
+  explicit SpatialHash(float cell_size);
+
+  // returns the width of each cell
+  float GetCellSize() const {return cell_size;}
+
+  // cell_size is the width of each cell
+  // changes the cell size and moves every object into its new cell
+  void SetCellSize(float cell_size);
+
+  // id is an object id and position is where it is
+  // adds id to the cell containing position
+  void Insert(int id, glm::vec3 position);
+
+  // id is an object id and position is where it moved to
+  // moves id to the cell containing position and returns false if id isn't
+  // in this
+  bool Update(int id, glm::vec3 position);
+
+  // id is an object id
+  // takes id out of this
+  void Remove(int id);
+
+  // returns whether id is in this
+  bool Contains(int id) const;
+
+  // center is a position, size is half the width of a square around it, and
+  // ids is where to put the results
+  // fills ids with every object in a cell the square touches, sorted from
+  // lowest to highest handle so callers see them in the same order however
+  // the cells are laid out, handles are reused so this isn't the order they
+  // were added in
+  void Query(glm::vec3 center, float size, std::vector<int>* ids) const;
+
+  // empties this
+  void Clear();
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_SPATIAL_HASH_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/tags.h"
+
+namespace engine {
+
+// TagTable maps each interned tag to its bit index
+typedef std::unordered_map<std::string, int> TagTable;
+
+// returns every table published so far, a table is never changed once it is
+// published and is kept until exit so a reader still using it is safe, there
+// is one for each tag so there are at most TAG_MAX of them
+static std::vector<std::unique_ptr<const TagTable>>& TagTables() {
+  static std::vector<std::unique_ptr<const TagTable>> tables;
+  return tables;
+}
+
+// published is the newest table, lookups read it without locking
+static std::atomic<const TagTable*> published(nullptr);
+
+// updates on worker threads can intern new tags, so publishing a table is
+// only done while holding this
+static std::mutex interned_lock;
+
+// table is a published table or nullptr and tag is a name
+// returns the bit index of tag in table or -1 if it isn't there
+static int LookupTag(const TagTable* table, const std::string &tag) {
+  if (table == nullptr) {
+    return -1;
+  }
+  auto found = table->find(tag);
+  return (found == table->end()) ? -1 : found->second;
+}
+
+// tag is a name
+// returns the bit index of tag, giving it the next free one the first time
+// it is seen, and throws a string exception once TAG_MAX tags are in use,
+// safe to call from any thread, tags that are already interned are found
+// without locking
+int InternTag(const std::string &tag) {
+  int rv = LookupTag(published.load(std::memory_order_acquire), tag);
+  if (rv != -1) {
+    return rv;
+  }
+  // another thread may have added tag since the lookup, so check again
+  // before copying the table with tag added
+  std::lock_guard<std::mutex> guard(interned_lock);
+  const TagTable* current = published.load(std::memory_order_acquire);
+  rv = LookupTag(current, tag);
+  if (rv != -1) {
+    return rv;
+  }
+  std::unique_ptr<TagTable> next(current ? new TagTable(*current) :
+                                           new TagTable());
+  if (next->size() >= TAG_MAX) {
+    throw "can't add tag " + tag + ", only " + std::to_string(TAG_MAX) +
+          " tags can be used";
+  }
+  rv = next->size();
+  (*next)[tag] = rv;
+  published.store(next.get(), std::memory_order_release);
+  TagTables().push_back(std::move(next));
+  return rv;
+}
+
+// tag is a name
+// returns the bit for tag or 0 if it has never been interned, safe to call
+// from any thread and never waits on InternTag
+TagMask FindTagMask(const std::string &tag) {
+  int bit = LookupTag(published.load(std::memory_order_acquire), tag);
+  return (bit == -1) ? 0 : TagMask(1) << bit;
+}
+
+// tags is a list of names
+// returns a mask with the bit of every tag in tags set
+TagMask MakeTagMask(const std::vector<std::string> &tags) {
+  TagMask rv = 0;
+  for (int i = 0; i < tags.size(); i++) {
+    rv |= TagMask(1) << InternTag(tags[i]);
+  }
+  return rv;
+}
+
+// tag is a name
+// adds tag to this
+void TagList::push_back(const std::string &tag) {
+  names.push_back(tag);
+  mask |= TagMask(1) << InternTag(tag);
+}
+
+// tag is a name
+// returns whether tag is in this
+bool TagList::Has(const std::string &tag) const {
+  return (mask & FindTagMask(tag)) != 0;
+}
+
+}  // namespace engine
@@ -0,0 +1,80 @@
+#ifndef SRC_ENGINE_TAGS_H_
+#define SRC_ENGINE_TAGS_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// src
+#include "engine/constants.h"
+
+namespace engine {
+
+// TagMask has one bit for each interned tag, so checking an object against a
+// list of tags is a single AND
+typedef uint64_t TagMask;
+
+// tag is a name
+// returns the bit index of tag, giving it the next free one the first time
+// it is seen, and throws a string exception once TAG_MAX tags are in use,
+// safe to call from any thread, tags that are already interned are found
+// without locking
+int InternTag(const std::string &tag);
+
+// tag is a name
+// returns the bit for tag or 0 if it has never been interned, safe to call
+// from any thread and never waits on InternTag
+TagMask FindTagMask(const std::string &tag);
+
+// tags is a list of names
+// returns a mask with the bit of every tag in tags set
+TagMask MakeTagMask(const std::vector<std::string> &tags);
+
+// TagList is a list of tag names that keeps their bits in a mask as they are
+// added, so it can be used like the vector of strings it replaced
+class TagList {
+ private:
+  std::vector<std::string> names;
+  TagMask mask;
+
+ public:
+  typedef std::vector<std::string>::const_iterator const_iterator;
+
+  // Default Constructor
+  TagList() : mask(0) {}
+
+  // tag is a name
+  // adds tag to this
+  void push_back(const std::string &tag);
+
+  // tag is a name
+  // returns whether tag is in this
+  bool Has(const std::string &tag) const;
+
+  // returns the bits of every tag in this
+  TagMask GetMask() const {return mask;}
+
+  // returns how many tags are in this
+  int size() const {return names.size();}
+
+  // i is an index in this
+  // returns the name of the tag at i
+  const std::string& operator[](int i) const {return names[i];}
+
+  // iterate over the names in the order they were added
+  const_iterator begin() const {return names.begin();}
+  const_iterator end() const {return names.end();}
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_TAGS_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/texture.h"
+#include "engine/texture_cache.h"
+
+namespace engine {
+
+// Default Constructor
+Texture::Texture() {
+  tex_name[0] = -1;
+  width = height = 0;
+}
+
+// filename is the path to a .ppm or .pam file
+// loads the image into a texture
+Texture::Texture(const std::string &filename) {
+  tex_name[0] = -1;
+  width = height = 0;
+  Load(filename);
+}
+
+// filename is the path to a .ppm or .pam file
+// loads the image into a texture and returns whether it was successful, the
+// first time an image is loaded its texels are cooked into a .tex file next to
+// it which is used instead until the image changes
+bool Texture::Load(const std::string &filename) {
+  std::string ext = filename.substr(filename.find_last_of(".") + 1);
+  if (ext != "ppm" && ext != "pam") {
+    std::cout << "Only PPM and PAM files are supported, you gave a " << ext <<
+    " file." << std::endl;
+    return false;
+  }
+  // decoding is slow, so the texels are kept in a .tex file next to the image
+  // until the image changes
+  std::string cache_file_name = TextureCachePath(filename);
+  CookedTexture cooked;
+  bool touched;
+  if (cooked.Read(cache_file_name) && cooked.IsCurrent(&touched)) {
+    if (touched) {
+      cooked.Write(cache_file_name);
+    }
+  } else {
+    float d;
+    cooked.Clear();
+    if (ext == "ppm") {
+      cooked.texels = LoadPPM(filename, &cooked.width, &cooked.height);
+    } else {
+      cooked.texels = LoadPAM(filename, &cooked.width, &cooked.height, &d);
+    }
+    cooked.source.path = filename;
+    if (GetMeshSource(filename, &cooked.source)) {
+      // the cache is only an optimization, so failing to write it is fine
+      cooked.Write(cache_file_name);
+    }
+  }
+  std::vector<GLubyte> &image = cooked.texels;
+  width = cooked.width;
+  height = cooked.height;
+  file = filename;
+  // without a context only the size is kept
+  if (Headless()) {
+    return true;
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if (tex_name[0] == -1) {
+    glGenTextures(1, tex_name);
+  }
+  glBindTexture(GL_TEXTURE_2D, tex_name[0]);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  // float colors[4] = {0, 0, 0, 0};
+  // glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_BLEND);
+  // glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, colors);
+
+  // the decoded image is only needed until OpenGL has its own copy
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
+    GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+  return true;
+}
+
+// Deconstructor
+// Free texture
+Texture::~Texture() {
+  if (tex_name[0] != -1) {
+    glDeleteTextures(1, tex_name);
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,69 @@
+#ifndef SRC_ENGINE_TEXTURE_H_
+#define SRC_ENGINE_TEXTURE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <GLFW/glfw3.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// src
+#include "engine/headless.h"
+#include "engine/helper.h"
+
+namespace engine {
+
+// Texture is an image that has been decoded and handed to OpenGL, it can be
+// shared by any number of materials
+class Texture {
+ private:
+  GLuint tex_name[1];
+  std::string file;
+  float width, height;
+
+ public:
+  // Default Constructor
+  Texture();
+
+  // filename is the path to a .ppm or .pam file
+  // loads the image into a texture
+  explicit Texture(const std::string &filename);
+
+  // filename is the path to a .ppm or .pam file
+  // loads the image into a texture and returns whether it was successful, the
+  // first time an image is loaded its texels are cooked into a .tex file next
+  // to it which is used instead until the image changes
+  bool Load(const std::string &filename);
+
+  // Getters
+  // returns the tex_name[0] or -1 if nothing is loaded
+  GLuint GetTexName() const {return tex_name[0];}
+
+  // returns the path of the loaded image
+  const std::string &GetFile() const {return file;}
+
+  // returns the width/height
+  float GetRatio() const {return width/height;}
+
+  // Deconstructor
+  // Free texture
+  ~Texture();
+
+  // delete the copy constructor
+  Texture(const Texture& texture) = delete;
+
+  // delete the assignment operator
+  Texture& operator=(const Texture& texture) = delete;
+};
+
+// TextureHandle keeps a shared texture alive
+typedef std::shared_ptr<const Texture> TextureHandle;
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_TEXTURE_H_
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/texture_cache.h"
+
+namespace engine {
+
+// Default Constructor
+CookedTexture::CookedTexture() {
+  Clear();
+}
+
+// empties all data
+void CookedTexture::Clear() {
+  texels.clear();
+  source = MeshSource();
+  width = height = 0;
+}
+
+// returns true if the source image still matches the file on disk
+// an image with a new modified time but the same hash is still current, its
+// time is updated and touched is set to true so the file can be rewritten
+bool CookedTexture::IsCurrent(bool* touched) {
+  *touched = false;
+  return IsSourceCurrent(&source, touched);
+}
+
+// file_name is a path to a .tex file
+// maps the file and fills this with its data, returns false and leaves this
+// empty if the file is missing, from another version, truncated, or has a
+// byte count larger than the file
+bool CookedTexture::Read(const std::string &file_name) {
+  Clear();
+  MappedFile file(file_name);
+  if (!file.IsOpen()) {
+    return false;
+  }
+  const char* bytes = file.Data();
+  const char* end = file.Data() + file.Size();
+  uint32_t magic, version, count;
+  bool rv = CookedMesh::Read(&bytes, end, &magic, sizeof(magic)) &&
+            CookedMesh::Read(&bytes, end, &version, sizeof(version)) &&
+            magic == TEXTURE_CACHE_MAGIC && version == TEXTURE_CACHE_VERSION;
+
+  // Source
+  rv = rv && CookedMesh::Read(&bytes, end, &source.path) &&
+       CookedMesh::Read(&bytes, end, &source.size, sizeof(source.size)) &&
+       CookedMesh::Read(&bytes, end, &source.modified,
+                        sizeof(source.modified)) &&
+       CookedMesh::Read(&bytes, end, &source.hash, sizeof(source.hash));
+
+  // Size and texels
+  rv = rv && CookedMesh::Read(&bytes, end, &width, sizeof(width)) &&
+       CookedMesh::Read(&bytes, end, &height, sizeof(height)) &&
+       CookedMesh::Read(&bytes, end, &count, sizeof(count)) &&
+       CookedMesh::Fits(bytes, end, count, sizeof(GLubyte));
+  if (rv) {
+    texels.resize(count);
+    rv = CookedMesh::Read(&bytes, end, texels.data(), count);
+  }
+
+  if (!rv) {
+    Clear();
+  }
+  return rv;
+}
+
+// file_name is a path to a .tex file
+// writes this to file_name and returns whether it was successful
+bool CookedTexture::Write(const std::string &file_name) const {
+  // write to a temporary file first so a half written cache is never read
+  std::string temp_name = file_name + ".tmp";
+  std::ofstream file(temp_name, std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  uint32_t magic = TEXTURE_CACHE_MAGIC;
+  uint32_t version = TEXTURE_CACHE_VERSION;
+  CookedMesh::Write(&file, &magic, sizeof(magic));
+  CookedMesh::Write(&file, &version, sizeof(version));
+
+  // Source
+  CookedMesh::Write(&file, source.path);
+  CookedMesh::Write(&file, &source.size, sizeof(source.size));
+  CookedMesh::Write(&file, &source.modified, sizeof(source.modified));
+  CookedMesh::Write(&file, &source.hash, sizeof(source.hash));
+
+  // Size and texels
+  uint32_t count = texels.size();
+  CookedMesh::Write(&file, &width, sizeof(width));
+  CookedMesh::Write(&file, &height, sizeof(height));
+  CookedMesh::Write(&file, &count, sizeof(count));
+  CookedMesh::Write(&file, texels.data(), count);
+
+  bool rv = file.good();
+  file.close();
+  if (rv) {
+    std::remove(file_name.c_str());
+    rv = (std::rename(temp_name.c_str(), file_name.c_str()) == 0);
+  }
+  if (!rv) {
+    std::remove(temp_name.c_str());
+  }
+  return rv;
+}
+
+// image_file_name is a path to a .ppm or .pam file
+// returns the path of the .tex file it is decoded to, the extension is kept
+// so images that only differ by extension don't share a cache
+std::string TextureCachePath(const std::string &image_file_name) {
+  return image_file_name + TEXTURE_CACHE_EXTENSION;
+}
+
+}  // namespace engine
@@ -0,0 +1,68 @@
+#ifndef SRC_ENGINE_TEXTURE_CACHE_H_
+#define SRC_ENGINE_TEXTURE_CACHE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+// src
+#include "engine/constants.h"
+#include "engine/mapped_file.h"
+#include "engine/mesh_cache.h"
+
+namespace engine {
+
+// CookedTexture holds an image decoded into the texels Texture hands to
+// OpenGL. It can be written to and read from a binary .tex file so later runs
+// don't have to decode the .ppm or .pam file again.
+//
+// A .tex file is laid out as:
+//   uint32 magic, uint32 version
+//   string path, uint64 size, int64 modified time, uint64 FNV-1a hash of the
+//     image it was decoded from
+//   float width, float height
+//   uint32 number of bytes, then the texels
+// where a string is a uint32 length followed by its characters
+class CookedTexture {
+ public:
+  std::vector<GLubyte> texels;
+  MeshSource source;
+  float width;
+  float height;
+
+  // Default Constructor
+  CookedTexture();
+
+  // empties all data
+  void Clear();
+
+  // returns true if the source image still matches the file on disk
+  // an image with a new modified time but the same hash is still current,
+  // its time is updated and touched is set to true so the file can be
+  // rewritten
+  bool IsCurrent(bool* touched);
+
+  // file_name is a path to a .tex file
+  // maps the file and fills this with its data, returns false and leaves this
+  // empty if the file is missing, from another version, truncated, or has a
+  // byte count larger than the file
+  bool Read(const std::string &file_name);
+
+  // file_name is a path to a .tex file
+  // writes this to file_name and returns whether it was successful
+  bool Write(const std::string &file_name) const;
+};
+
+// image_file_name is a path to a .ppm or .pam file
+// returns the path of the .tex file it is decoded to, the extension is kept
+// so images that only differ by extension don't share a cache
+std::string TextureCachePath(const std::string &image_file_name);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_TEXTURE_CACHE_H_
@@ -0,0 +1,227 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/tile_grid.h"
+
+namespace engine {
+
+// value is a coordinate relative to origin on one axis
+// returns the cell whose tile is centered closest to value
+int TileGrid::CellCoordinate(float value) {
+  return static_cast<int>(std::floor(value + 0.5f));
+}
+
+// Default Constructor
+TileGrid::TileGrid() {
+  origin = glm::vec3(0, 0, 0);
+  width = 0;
+  depth = 0;
+  num_tiles = 0;
+  bounding_box_min = glm::vec3(-0.5f, -0.5f, -0.5f);
+  bounding_box_max = glm::vec3(0.5f, 0.5f, 0.5f);
+  reach = 0;
+}
+
+// origin is where tile (0, 0) sits, width and depth are how many cells the
+// grid has along x and z, and model is drawn for every tile
+// empties the grid and uses model's bounds as each tile's bounding box
+void TileGrid::Initialize(glm::vec3 origin, int width, int depth,
+                          ModelHandle model) {
+  this->origin = origin;
+  this->width = std::max(width, 0);
+  this->depth = std::max(depth, 0);
+  this->model = model;
+  cells.assign(this->width * this->depth, 0);
+  num_tiles = 0;
+  if (model) {
+    SetBoundingBox(model->GetBoundMin(), model->GetBoundMax());
+  }
+}
+
+// min and max are the corners of each tile's bounding box relative to its
+// position
+// sets the bounding box every tile uses
+void TileGrid::SetBoundingBox(glm::vec3 min, glm::vec3 max) {
+  bounding_box_min = min;
+  bounding_box_max = max;
+  // a cell covers half a unit on either side of its tile
+  float spill = std::max(std::max(-min.x, max.x), std::max(-min.z, max.z));
+  reach = std::max(static_cast<int>(std::ceil(spill - 0.5f)), 0);
+}
+
+// x and z are cell coordinates and occupied is whether there is a tile
+// adds or removes the tile at x, z, cells outside the grid are ignored
+void TileGrid::SetTile(int x, int z, bool occupied) {
+  if (x >= 0 && x < width && z >= 0 && z < depth) {
+    uint8_t &cell = cells[z * width + x];
+    num_tiles += (occupied ? 1 : 0) - cell;
+    cell = occupied ? 1 : 0;
+  }
+}
+
+// x and z are cell coordinates
+// returns whether there is a tile at x, z, false outside the grid
+bool TileGrid::HasTile(int x, int z) const {
+  return x >= 0 && x < width && z >= 0 && z < depth && cells[z * width + x];
+}
+
+// x and z are cell coordinates
+// returns the world position of the tile at x, z
+glm::vec3 TileGrid::GetTilePosition(int x, int z) const {
+  return origin + glm::vec3(x, 0, z);
+}
+
+// x and z are cell coordinates
+// returns the bounding box of the tile at x, z in world space
+OBB TileGrid::GetTileOBB(int x, int z) const {
+  OBB box;
+  box.center = GetTilePosition(x, z) +
+               (bounding_box_min + bounding_box_max) * 0.5f;
+  box.half_extents = (bounding_box_max - bounding_box_min) * 0.5f;
+  box.axes[0] = glm::vec3(1, 0, 0);
+  box.axes[1] = glm::vec3(0, 1, 0);
+  box.axes[2] = glm::vec3(0, 0, 1);
+  return box;
+}
+
+// box is a box in world space, bounds is the axis aligned box around it,
+// center and radius limit the tiles checked to those whose position is
+// within radius of center
+// returns whether box overlaps any tile, only the cells under bounds are
+// looked at
+bool TileGrid::Overlaps(const OBB &box, const AABB &bounds, glm::vec3 center,
+                        float radius) const {
+  if (num_tiles == 0 ||
+      bounds.max.y < origin.y + bounding_box_min.y ||
+      bounds.min.y > origin.y + bounding_box_max.y) {
+    return false;
+  }
+  int min_x = std::max(CellCoordinate(bounds.min.x - origin.x) - reach, 0);
+  int max_x = std::min(CellCoordinate(bounds.max.x - origin.x) + reach,
+                       width - 1);
+  int min_z = std::max(CellCoordinate(bounds.min.z - origin.z) - reach, 0);
+  int max_z = std::min(CellCoordinate(bounds.max.z - origin.z) + reach,
+                       depth - 1);
+  for (int z = min_z; z <= max_z; z++) {
+    for (int x = min_x; x <= max_x; x++) {
+      if (cells[z * width + x] &&
+          PointInBox(GetTilePosition(x, z), center, radius) &&
+          OverlapOBB(box, GetTileOBB(x, z))) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// x and z are cell coordinates, start and end define a line segment, and
+// nearest is the closest hit so far or -1
+// lowers nearest to the distance the segment crosses any tile reaching x, z
+void TileGrid::NearestHit(int x, int z, glm::vec3 start, glm::vec3 end,
+                          float* nearest) const {
+  for (int tile_z = z - reach; tile_z <= z + reach; tile_z++) {
+    for (int tile_x = x - reach; tile_x <= x + reach; tile_x++) {
+      if (HasTile(tile_x, tile_z)) {
+        float hit = RayCastOBB(GetTileOBB(tile_x, tile_z), start, end);
+        if (hit != -1 && (*nearest == -1 || hit < *nearest)) {
+          *nearest = hit;
+        }
+      }
+    }
+  }
+}
+
+// start and end define a line segment
+// returns the distance from start to the first tile the segment crosses or
+// -1 if there isn't one, the cells along the segment are walked in order
+// (Amanatides and Woo) and the walk stops once no later cell can be closer
+float TileGrid::RayCast(glm::vec3 start, glm::vec3 end) const {
+  float length = glm::length(end - start);
+  if (num_tiles == 0 || length == 0) {
+    return -1;
+  }
+  glm::vec3 direction = (end - start) / length;
+
+  // skip ahead to where the segment enters the grid
+  AABB grid(origin + bounding_box_min - glm::vec3(reach, 0, reach),
+            origin + bounding_box_max +
+            glm::vec3(width - 1 + reach, 0, depth - 1 + reach));
+  float t = grid.RayEntry(start, direction, length);
+  if (t == -1) {
+    return -1;
+  }
+  glm::vec3 entry = start + direction * t - origin;
+  int cell[2] = {CellCoordinate(entry.x), CellCoordinate(entry.z)};
+  int limit[2] = {width - 1, depth - 1};
+  int step[2];
+  float next[2];
+  float span[2];
+  for (int i = 0; i < 2; i++) {
+    int axis = i * 2;
+    cell[i] = std::min(std::max(cell[i], -reach), limit[i] + reach);
+    if (direction[axis] == 0) {
+      step[i] = 0;
+      next[i] = INFINITY;
+      span[i] = INFINITY;
+    } else {
+      // distance along the segment to the next cell boundary and between
+      // boundaries on this axis
+      step[i] = direction[axis] > 0 ? 1 : -1;
+      float boundary = origin[axis] + cell[i] + 0.5f * step[i];
+      next[i] = (boundary - start[axis]) / direction[axis];
+      span[i] = std::abs(1.0f / direction[axis]);
+    }
+  }
+
+  // a tile is crossed in a cell that reaches it, so once a cell starts past
+  // the closest hit so far nothing later can be closer
+  float rv = -1;
+  while (t <= length && (rv == -1 || t <= rv)) {
+    NearestHit(cell[0], cell[1], start, end, &rv);
+    int i = next[0] < next[1] ? 0 : 1;
+    // through a corner the walk skips the cell across the other boundary
+    if (std::abs(next[0] - next[1]) <= TILE_GRID_EPSILON) {
+      NearestHit(cell[0] + step[0] * i, cell[1] + step[1] * (1 - i), start,
+                 end, &rv);
+    }
+    t = next[i];
+    cell[i] += step[i];
+    next[i] += span[i];
+    if (cell[i] < -reach || cell[i] > limit[i] + reach) {
+      break;
+    }
+  }
+  return rv;
+}
+
+// center and distance are the render box
+// draws every tile whose position is within distance of center
+// make sure the matrix mode is GL_MODELVIEW
+void TileGrid::Draw(glm::vec3 center, float distance) const {
+  if (!model) {
+    return;
+  }
+  // only the cells inside the render box need to be looked at
+  int min_x = std::max(static_cast<int>(
+    std::ceil(center.x - distance - origin.x)), 0);
+  int max_x = std::min(static_cast<int>(
+    std::floor(center.x + distance - origin.x)), width - 1);
+  int min_z = std::max(static_cast<int>(
+    std::ceil(center.z - distance - origin.z)), 0);
+  int max_z = std::min(static_cast<int>(
+    std::floor(center.z + distance - origin.z)), depth - 1);
+  for (int z = min_z; z <= max_z; z++) {
+    for (int x = min_x; x <= max_x; x++) {
+      glm::vec3 position = GetTilePosition(x, z);
+      if (cells[z * width + x] && PointInBox(position, center, distance)) {
+        glPushMatrix();
+          glTranslatef(position.x, position.y, position.z);
+          model->Draw();
+        glPopMatrix();
+      }
+    }
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,115 @@
+#ifndef SRC_ENGINE_TILE_GRID_H_
+#define SRC_ENGINE_TILE_GRID_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// lib
+#include "glm/vec3.hpp"
+
+// src
+#include "engine/model.h"
+#include "engine/aabb_tree.h"
+#include "engine/obb.h"
+#include "engine/helper.h"
+#include "engine/tags.h"
+#include "engine/constants.h"
+
+namespace engine {
+
+// TileGrid stores the static tiles of a level, like walls, as one byte per
+// cell instead of one rigidbody each. Tile (x, z) sits at origin + (x, 0, z)
+// and every tile shares one model and bounding box, so collisions only look
+// at the cells under a box and ray casts walk the cells along the segment.
+class TileGrid {
+ private:
+  glm::vec3 origin;
+  int width;
+  int depth;
+  std::vector<uint8_t> cells;
+  int num_tiles;
+
+  ModelHandle model;
+  glm::vec3 bounding_box_min;
+  glm::vec3 bounding_box_max;
+  // reach is how many cells past its own a tile's box can spill into
+  int reach;
+
+  // value is a coordinate relative to origin on one axis
+  // returns the cell whose tile is centered closest to value
+  static int CellCoordinate(float value);
+
+  // x and z are cell coordinates, start and end define a line segment, and
+  // nearest is the closest hit so far or -1
+  // lowers nearest to the distance the segment crosses any tile reaching x, z
+  void NearestHit(int x, int z, glm::vec3 start, glm::vec3 end,
+                  float* nearest) const;
+
+ public:
+  // tags are what Project::Collides and Project::RayCast compare against
+  // their ignore lists for every tile
+  TagList tags;
+
+  // Default Constructor
+  TileGrid();
+
+  // origin is where tile (0, 0) sits, width and depth are how many cells the
+  // grid has along x and z, and model is drawn for every tile
+  // empties the grid and uses model's bounds as each tile's bounding box
+  void Initialize(glm::vec3 origin, int width, int depth, ModelHandle model);
+
+  // min and max are the corners of each tile's bounding box relative to its
+  // position
+  // sets the bounding box every tile uses
+  void SetBoundingBox(glm::vec3 min, glm::vec3 max);
+
+  // x and z are cell coordinates and occupied is whether there is a tile
+  // adds or removes the tile at x, z, cells outside the grid are ignored
+  void SetTile(int x, int z, bool occupied);
+
+  // x and z are cell coordinates
+  // returns whether there is a tile at x, z, false outside the grid
+  bool HasTile(int x, int z) const;
+
+  // returns how many tiles are in the grid
+  int GetNumTiles() const {return num_tiles;}
+
+  // x and z are cell coordinates
+  // returns the world position of the tile at x, z
+  glm::vec3 GetTilePosition(int x, int z) const;
+
+  // x and z are cell coordinates
+  // returns the bounding box of the tile at x, z in world space
+  OBB GetTileOBB(int x, int z) const;
+
+  // box is a box in world space, bounds is the axis aligned box around it,
+  // center and radius limit the tiles checked to those whose position is
+  // within radius of center
+  // returns whether box overlaps any tile, only the cells under bounds are
+  // looked at
+  bool Overlaps(const OBB &box, const AABB &bounds, glm::vec3 center,
+                float radius) const;
+
+  // start and end define a line segment
+  // returns the distance from start to the first tile the segment crosses or
+  // -1 if there isn't one, the cells along the segment are walked in order
+  // (Amanatides and Woo) and the walk stops once no later cell can be closer
+  float RayCast(glm::vec3 start, glm::vec3 end) const;
+
+  // center and distance are the render box
+  // draws every tile whose position is within distance of center
+  // make sure the matrix mode is GL_MODELVIEW
+  void Draw(glm::vec3 center, float distance) const;
+};
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_TILE_GRID_H_
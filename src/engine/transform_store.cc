@@ -0,0 +1,780 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "engine/transform_store.h"
+
+namespace engine {
+
+// the transform the calling thread is updating
+static thread_local int updating_transform = TRANSFORM_STORE_NULL;
+
+// row is a row in this and live is whether to use its live pose instead
+// of its saved one
+// returns the world space axis aligned box around row's bounding box
+AABB TransformStore::RowWorldBounds(int row, bool live) const {
+  const std::vector<float>* position =
+    live ? this->position : previous_position;
+  const std::vector<float>* orientation =
+    live ? this->orientation : previous_orientation;
+  // axis aligned boxes ignore the orientation
+  bool aligned = axis_aligned[row];
+  float x = aligned ? 0.0f : orientation[0][row];
+  float y = aligned ? 0.0f : orientation[1][row];
+  float z = aligned ? 0.0f : orientation[2][row];
+  float w = aligned ? 1.0f : orientation[3][row];
+  // columns of the rotation matrix, the same as glm::toMat3
+  float rot[3][3] = {
+    {1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y)},
+    {2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x)},
+    {2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y)}
+  };
+  float center[3], extent[3];
+  for (int i = 0; i < 3; i++) {
+    center[i] = (bounds_min[i][row] + bounds_max[i][row]) * 0.5f;
+    extent[i] = (bounds_max[i][row] - bounds_min[i][row]) * 0.5f;
+  }
+  // each world axis covers the rotated extents projected onto it
+  glm::vec3 world_center, world_extent;
+  for (int i = 0; i < 3; i++) {
+    world_center[i] = position[i][row] + rot[0][i] * center[0] +
+                      rot[1][i] * center[1] + rot[2][i] * center[2];
+    world_extent[i] = std::abs(rot[0][i]) * extent[0] +
+                      std::abs(rot[1][i]) * extent[1] +
+                      std::abs(rot[2][i]) * extent[2];
+  }
+  return AABB(world_center - world_extent, world_center + world_extent);
+}
+
+// handle is a handle in this
+// returns whether handle is the transform the calling thread is updating
+// or one of its descendants, or the thread isn't updating one
+bool TransformStore::IsUpdating(int handle) const {
+  if (updating_transform == TRANSFORM_STORE_NULL) {
+    return true;
+  }
+  for (int up = handle; up != TRANSFORM_STORE_NULL;
+       up = parent[slots[up].row]) {
+    if (up == updating_transform) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// handle is a handle in this
+// returns whether the calling thread reads handle's live values instead of
+// its saved pose, rows added since the poses were saved are always live
+bool TransformStore::IsLive(int handle) const {
+  return !has_previous[slots[handle].row] || IsUpdating(handle);
+}
+
+// handle is a handle in this
+// throws a string exception if the calling thread is updating a transform
+// and handle isn't it or one of its descendants
+void TransformStore::CheckWritable(int handle) const {
+  if (!IsUpdating(handle)) {
+    throw std::string("an update can only move its own game object and its "
+                      "children, others have to be moved through Defer");
+  }
+}
+
+// from and to are rows in this
+// copies every array at row from into row to
+void TransformStore::MoveRow(int from, int to) {
+  for (int i = 0; i < 3; i++) {
+    position[i][to] = position[i][from];
+    scale[i][to] = scale[i][from];
+    bounds_min[i][to] = bounds_min[i][from];
+    bounds_max[i][to] = bounds_max[i][from];
+    local_position[i][to] = local_position[i][from];
+    local_scale[i][to] = local_scale[i][from];
+  }
+  for (int i = 0; i < 4; i++) {
+    orientation[i][to] = orientation[i][from];
+    local_orientation[i][to] = local_orientation[i][from];
+  }
+  axis_aligned[to] = axis_aligned[from];
+  world_matrix[to] = world_matrix[from];
+  dirty[to] = dirty[from];
+  parent[to] = parent[from];
+  first_child[to] = first_child[from];
+  next_sibling[to] = next_sibling[from];
+  world_dirty[to] = world_dirty[from];
+  moved[to] = moved[from];
+  for (int i = 0; i < 3; i++) {
+    previous_position[i][to] = previous_position[i][from];
+    previous_scale[i][to] = previous_scale[i][from];
+  }
+  for (int i = 0; i < 4; i++) {
+    previous_orientation[i][to] = previous_orientation[i][from];
+  }
+  has_previous[to] = has_previous[from];
+  handles[to] = handles[from];
+  owners[to] = owners[from];
+  slots[handles[to]].row = to;
+}
+
+// row is a row in this
+// works out the world values of row's parent and then row from its local
+// values if they are out of date
+void TransformStore::Refresh(int row) {
+  if (!world_dirty[row]) {
+    return;
+  }
+  int up = slots[parent[row]].row;
+  Refresh(up);
+  glm::vec3 parent_position(position[0][up], position[1][up],
+                            position[2][up]);
+  glm::quat parent_orientation(orientation[3][up], orientation[0][up],
+                               orientation[1][up], orientation[2][up]);
+  glm::vec3 parent_scale(scale[0][up], scale[1][up], scale[2][up]);
+  glm::vec3 local(local_position[0][row], local_position[1][row],
+                  local_position[2][row]);
+  glm::quat local_rot(local_orientation[3][row], local_orientation[0][row],
+                      local_orientation[1][row], local_orientation[2][row]);
+  glm::vec3 world = parent_position +
+                    parent_orientation * (parent_scale * local);
+  glm::quat world_rot = parent_orientation * local_rot;
+  for (int i = 0; i < 3; i++) {
+    position[i][row] = world[i];
+    scale[i][row] = parent_scale[i] * local_scale[i][row];
+  }
+  orientation[0][row] = world_rot.x;
+  orientation[1][row] = world_rot.y;
+  orientation[2][row] = world_rot.z;
+  orientation[3][row] = world_rot.w;
+  world_dirty[row] = 0;
+  moved[row] = 1;
+}
+
+// row is a row with a parent
+// sets row's local values from its world values and its parent's
+void TransformStore::UpdateLocal(int row) {
+  int up = slots[parent[row]].row;
+  glm::vec3 parent_position(position[0][up], position[1][up],
+                            position[2][up]);
+  glm::quat inverse_rot = glm::inverse(glm::quat(orientation[3][up],
+    orientation[0][up], orientation[1][up], orientation[2][up]));
+  glm::vec3 parent_scale(scale[0][up], scale[1][up], scale[2][up]);
+  glm::vec3 world(position[0][row], position[1][row], position[2][row]);
+  glm::quat world_rot(orientation[3][row], orientation[0][row],
+                      orientation[1][row], orientation[2][row]);
+  glm::vec3 local = (inverse_rot * (world - parent_position)) / parent_scale;
+  glm::quat local_rot = inverse_rot * world_rot;
+  for (int i = 0; i < 3; i++) {
+    local_position[i][row] = local[i];
+    local_scale[i][row] = scale[i][row] / parent_scale[i];
+  }
+  local_orientation[0][row] = local_rot.x;
+  local_orientation[1][row] = local_rot.y;
+  local_orientation[2][row] = local_rot.z;
+  local_orientation[3][row] = local_rot.w;
+}
+
+// row is a row in this
+// flags row's descendants so their world values get worked out again
+void TransformStore::MarkChildrenDirty(int row) {
+  for (int child = first_child[row]; child != TRANSFORM_STORE_NULL;) {
+    int child_row = slots[child].row;
+    // a child that is already flagged has flagged descendants too
+    if (!world_dirty[child_row]) {
+      world_dirty[child_row] = 1;
+      dirty[child_row] = 1;
+      MarkChildrenDirty(child_row);
+    }
+    child = next_sibling[child_row];
+  }
+}
+
+// handle is a handle in this
+// appends every descendant of handle to hierarchy, parents first
+void TransformStore::AppendChildren(int handle) {
+  for (int child = first_child[slots[handle].row];
+       child != TRANSFORM_STORE_NULL;
+       child = next_sibling[slots[child].row]) {
+    hierarchy.push_back(child);
+    AppendChildren(child);
+  }
+}
+
+// rebuilds hierarchy if it changed and brings every child up to date
+void TransformStore::RefreshHierarchy() {
+  if (hierarchy_changed) {
+    hierarchy.clear();
+    for (int row = 0; row < handles.size(); row++) {
+      if (parent[row] == TRANSFORM_STORE_NULL &&
+          first_child[row] != TRANSFORM_STORE_NULL) {
+        AppendChildren(handles[row]);
+      }
+    }
+    hierarchy_changed = false;
+  }
+  // parents come first so each child only has to look one level up
+  for (int i = 0; i < hierarchy.size(); i++) {
+    Refresh(slots[hierarchy[i]].row);
+  }
+}
+
+// owner is the game object the transform belongs to
+// adds an identity transform with an empty bounding box and returns its
+// handle, throws a string exception while the calling thread is updating
+// a transform
+int TransformStore::Insert(GameObject* owner) {
+  if (updating_transform != TRANSFORM_STORE_NULL) {
+    throw std::string("game objects can only be made from an update "
+                      "through Defer");
+  }
+  int handle = free_list;
+  if (handle != TRANSFORM_STORE_NULL) {
+    free_list = slots[handle].next_free;
+  } else {
+    handle = slots.size();
+    slots.push_back({TRANSFORM_STORE_NULL, TRANSFORM_STORE_NULL});
+  }
+  slots[handle].row = handles.size();
+  slots[handle].next_free = TRANSFORM_STORE_NULL;
+  handles.push_back(handle);
+  owners.push_back(owner);
+  for (int i = 0; i < 3; i++) {
+    position[i].push_back(0.0f);
+    scale[i].push_back(1.0f);
+    bounds_min[i].push_back(0.0f);
+    bounds_max[i].push_back(0.0f);
+    local_position[i].push_back(0.0f);
+    local_scale[i].push_back(1.0f);
+    orientation[i].push_back(0.0f);
+    local_orientation[i].push_back(0.0f);
+    previous_position[i].push_back(0.0f);
+    previous_scale[i].push_back(1.0f);
+    previous_orientation[i].push_back(0.0f);
+  }
+  orientation[3].push_back(1.0f);
+  local_orientation[3].push_back(1.0f);
+  previous_orientation[3].push_back(1.0f);
+  has_previous.push_back(0);
+  axis_aligned.push_back(0);
+  world_matrix.push_back(glm::mat4(1.0f));
+  dirty.push_back(0);
+  parent.push_back(TRANSFORM_STORE_NULL);
+  first_child.push_back(TRANSFORM_STORE_NULL);
+  next_sibling.push_back(TRANSFORM_STORE_NULL);
+  world_dirty.push_back(0);
+  moved.push_back(0);
+  return handle;
+}
+
+// handle is a handle in this
+// removes handle's transform by moving the last row into its place, its
+// children keep their world values and lose their parent
+void TransformStore::Remove(int handle) {
+  while (first_child[slots[handle].row] != TRANSFORM_STORE_NULL) {
+    SetParent(first_child[slots[handle].row], TRANSFORM_STORE_NULL);
+  }
+  SetParent(handle, TRANSFORM_STORE_NULL);
+  int row = slots[handle].row;
+  int last = handles.size() - 1;
+  if (row != last) {
+    MoveRow(last, row);
+  }
+  for (int i = 0; i < 3; i++) {
+    position[i].pop_back();
+    scale[i].pop_back();
+    bounds_min[i].pop_back();
+    bounds_max[i].pop_back();
+    local_position[i].pop_back();
+    local_scale[i].pop_back();
+    previous_position[i].pop_back();
+    previous_scale[i].pop_back();
+  }
+  for (int i = 0; i < 4; i++) {
+    orientation[i].pop_back();
+    local_orientation[i].pop_back();
+    previous_orientation[i].pop_back();
+  }
+  has_previous.pop_back();
+  axis_aligned.pop_back();
+  world_matrix.pop_back();
+  dirty.pop_back();
+  parent.pop_back();
+  first_child.pop_back();
+  next_sibling.pop_back();
+  world_dirty.pop_back();
+  moved.pop_back();
+  handles.pop_back();
+  owners.pop_back();
+  slots[handle].row = TRANSFORM_STORE_NULL;
+  slots[handle].next_free = free_list;
+  free_list = handle;
+}
+
+// from and to are handles in this
+// copies the world transform and bounding box of from into to
+void TransformStore::Copy(int from, int to) {
+  int src = slots[from].row;
+  int dst = slots[to].row;
+  Refresh(src);
+  Refresh(dst);
+  for (int i = 0; i < 3; i++) {
+    position[i][dst] = position[i][src];
+    scale[i][dst] = scale[i][src];
+    bounds_min[i][dst] = bounds_min[i][src];
+    bounds_max[i][dst] = bounds_max[i][src];
+  }
+  for (int i = 0; i < 4; i++) {
+    orientation[i][dst] = orientation[i][src];
+  }
+  axis_aligned[dst] = axis_aligned[src];
+  if (parent[dst] != TRANSFORM_STORE_NULL) {
+    UpdateLocal(dst);
+  }
+  SetDirty(to);
+}
+
+// handle is a handle in this and parent is another handle or
+// TRANSFORM_STORE_NULL
+// makes handle a child of parent without changing its world transform,
+// throws a string exception if parent is handle or one of its descendants
+// or the calling thread is updating a transform
+void TransformStore::SetParent(int handle, int parent) {
+  if (updating_transform != TRANSFORM_STORE_NULL) {
+    throw std::string("parents can only be changed from an update through "
+                      "Defer");
+  }
+  int row = slots[handle].row;
+  if (this->parent[row] == parent) {
+    return;
+  }
+  for (int up = parent; up != TRANSFORM_STORE_NULL;
+       up = this->parent[slots[up].row]) {
+    if (up == handle) {
+      throw std::string("can't parent a transform to itself or its child");
+    }
+  }
+  Refresh(row);
+  // Unlink from the old parent
+  int old = this->parent[row];
+  if (old != TRANSFORM_STORE_NULL) {
+    int *link = &first_child[slots[old].row];
+    while (*link != handle) {
+      link = &next_sibling[slots[*link].row];
+    }
+    *link = next_sibling[row];
+    next_sibling[row] = TRANSFORM_STORE_NULL;
+  }
+  // Link to the new one
+  this->parent[row] = parent;
+  if (parent != TRANSFORM_STORE_NULL) {
+    int up = slots[parent].row;
+    Refresh(up);
+    next_sibling[row] = first_child[up];
+    first_child[up] = handle;
+    UpdateLocal(row);
+  }
+  hierarchy_changed = true;
+}
+
+// handle is a handle in this
+// returns handle's position
+glm::vec3 TransformStore::GetPosition(int handle) {
+  int row = slots[handle].row;
+  if (!IsLive(handle)) {
+    return glm::vec3(previous_position[0][row], previous_position[1][row],
+                     previous_position[2][row]);
+  }
+  Refresh(row);
+  return glm::vec3(position[0][row], position[1][row], position[2][row]);
+}
+
+// handle is a handle in this and position is its new position
+// sets handle's position
+void TransformStore::SetPosition(int handle, glm::vec3 position) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  Refresh(row);
+  for (int i = 0; i < 3; i++) {
+    this->position[i][row] = position[i];
+  }
+  if (parent[row] != TRANSFORM_STORE_NULL) {
+    UpdateLocal(row);
+  }
+  SetDirty(handle);
+}
+
+// handle is a handle in this
+// returns handle's orientation
+glm::quat TransformStore::GetOrientation(int handle) {
+  int row = slots[handle].row;
+  if (!IsLive(handle)) {
+    return glm::quat(previous_orientation[3][row],
+                     previous_orientation[0][row],
+                     previous_orientation[1][row],
+                     previous_orientation[2][row]);
+  }
+  Refresh(row);
+  return glm::quat(orientation[3][row], orientation[0][row],
+                   orientation[1][row], orientation[2][row]);
+}
+
+// handle is a handle in this and orientation is its new orientation
+// sets handle's orientation
+void TransformStore::SetOrientation(int handle, glm::quat orientation) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  Refresh(row);
+  this->orientation[0][row] = orientation.x;
+  this->orientation[1][row] = orientation.y;
+  this->orientation[2][row] = orientation.z;
+  this->orientation[3][row] = orientation.w;
+  if (parent[row] != TRANSFORM_STORE_NULL) {
+    UpdateLocal(row);
+  }
+  SetDirty(handle);
+}
+
+// handle is a handle in this
+// returns handle's scale
+glm::vec3 TransformStore::GetScale(int handle) {
+  int row = slots[handle].row;
+  if (!IsLive(handle)) {
+    return glm::vec3(previous_scale[0][row], previous_scale[1][row],
+                     previous_scale[2][row]);
+  }
+  Refresh(row);
+  return glm::vec3(scale[0][row], scale[1][row], scale[2][row]);
+}
+
+// handle is a handle in this and scale is its new scale
+// sets handle's scale
+void TransformStore::SetScale(int handle, glm::vec3 scale) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  Refresh(row);
+  for (int i = 0; i < 3; i++) {
+    this->scale[i][row] = scale[i];
+  }
+  if (parent[row] != TRANSFORM_STORE_NULL) {
+    UpdateLocal(row);
+  }
+  SetDirty(handle);
+}
+
+// handle is a handle in this
+// returns handle's position relative to its parent
+glm::vec3 TransformStore::GetLocalPosition(int handle) {
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    return GetPosition(handle);
+  }
+  return glm::vec3(local_position[0][row], local_position[1][row],
+                   local_position[2][row]);
+}
+
+// handle is a handle in this and position is relative to its parent
+// sets handle's position relative to its parent
+void TransformStore::SetLocalPosition(int handle, glm::vec3 position) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    SetPosition(handle, position);
+    return;
+  }
+  for (int i = 0; i < 3; i++) {
+    local_position[i][row] = position[i];
+  }
+  world_dirty[row] = 1;
+  SetDirty(handle);
+}
+
+// handle is a handle in this
+// returns handle's orientation relative to its parent
+glm::quat TransformStore::GetLocalOrientation(int handle) {
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    return GetOrientation(handle);
+  }
+  return glm::quat(local_orientation[3][row], local_orientation[0][row],
+                   local_orientation[1][row], local_orientation[2][row]);
+}
+
+// handle is a handle in this and orientation is relative to its parent
+// sets handle's orientation relative to its parent
+void TransformStore::SetLocalOrientation(int handle, glm::quat orientation) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    SetOrientation(handle, orientation);
+    return;
+  }
+  local_orientation[0][row] = orientation.x;
+  local_orientation[1][row] = orientation.y;
+  local_orientation[2][row] = orientation.z;
+  local_orientation[3][row] = orientation.w;
+  world_dirty[row] = 1;
+  SetDirty(handle);
+}
+
+// handle is a handle in this
+// returns handle's scale relative to its parent
+glm::vec3 TransformStore::GetLocalScale(int handle) {
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    return GetScale(handle);
+  }
+  return glm::vec3(local_scale[0][row], local_scale[1][row],
+                   local_scale[2][row]);
+}
+
+// handle is a handle in this and scale is relative to its parent
+// sets handle's scale relative to its parent
+void TransformStore::SetLocalScale(int handle, glm::vec3 scale) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  if (parent[row] == TRANSFORM_STORE_NULL) {
+    SetScale(handle, scale);
+    return;
+  }
+  for (int i = 0; i < 3; i++) {
+    local_scale[i][row] = scale[i];
+  }
+  world_dirty[row] = 1;
+  SetDirty(handle);
+}
+
+// moved is filled with handles
+// works out the world values of every child whose ancestors moved, parents
+// first, and adds the handle of each one that moved since the last call
+void TransformStore::UpdateHierarchy(std::vector<int>* moved) {
+  RefreshHierarchy();
+  for (int i = 0; i < hierarchy.size(); i++) {
+    int row = slots[hierarchy[i]].row;
+    if (this->moved[row]) {
+      this->moved[row] = 0;
+      moved->push_back(hierarchy[i]);
+    }
+  }
+}
+
+// handle is a handle in this
+// marks handle's world matrix and its children as out of date, throws a
+// string exception like the setters
+void TransformStore::SetDirty(int handle) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  dirty[row] = 1;
+  MarkChildrenDirty(row);
+}
+
+// handle is a handle in this
+// returns the minimum corner of handle's bounding box
+glm::vec3 TransformStore::GetBoundingBoxMin(int handle) const {
+  int row = slots[handle].row;
+  return glm::vec3(bounds_min[0][row], bounds_min[1][row],
+                   bounds_min[2][row]);
+}
+
+// handle is a handle in this
+// returns the maximum corner of handle's bounding box
+glm::vec3 TransformStore::GetBoundingBoxMax(int handle) const {
+  int row = slots[handle].row;
+  return glm::vec3(bounds_max[0][row], bounds_max[1][row],
+                   bounds_max[2][row]);
+}
+
+// handle is a handle in this and minimum and maximum define a bounding box
+// sets handle's bounding box
+void TransformStore::SetBoundingBox(int handle, glm::vec3 minimum,
+                                    glm::vec3 maximum) {
+  CheckWritable(handle);
+  int row = slots[handle].row;
+  for (int i = 0; i < 3; i++) {
+    bounds_min[i][row] = minimum[i];
+    bounds_max[i][row] = maximum[i];
+  }
+}
+
+// handle is a handle in this
+// returns whether handle's bounding box ignores its orientation
+bool TransformStore::GetAxisAligned(int handle) const {
+  return axis_aligned[slots[handle].row];
+}
+
+// handle is a handle in this and aligned is whether its bounding box
+// ignores its orientation
+// sets whether handle's bounding box is axis aligned
+void TransformStore::SetAxisAligned(int handle, bool aligned) {
+  CheckWritable(handle);
+  axis_aligned[slots[handle].row] = aligned;
+}
+
+// handle is a handle in this and matrix is its rebuilt world matrix
+// caches matrix and marks handle clean
+void TransformStore::SetWorldMatrix(int handle, const glm::mat4 &matrix) {
+  int row = slots[handle].row;
+  world_matrix[row] = matrix;
+  dirty[row] = 0;
+}
+
+// handle is a handle in this
+// returns the world space axis aligned box around handle's bounding box,
+// read from the snapshot like the getters
+AABB TransformStore::GetWorldBounds(int handle) {
+  int row = slots[handle].row;
+  if (!IsLive(handle)) {
+    return RowWorldBounds(row, false);
+  }
+  Refresh(row);
+  return RowWorldBounds(row, true);
+}
+
+// bounds has room for Size() boxes
+// fills bounds with the world space box of every row in row order
+void TransformStore::GetWorldBounds(AABB* bounds) {
+  RefreshHierarchy();
+  // the same math as RowWorldBounds written against raw arrays so the loop
+  // can be vectorized
+  int count = handles.size();
+  const float *px = position[0].data(), *py = position[1].data(),
+              *pz = position[2].data();
+  const float *qx = orientation[0].data(), *qy = orientation[1].data(),
+              *qz = orientation[2].data(), *qw = orientation[3].data();
+  const float *min_x = bounds_min[0].data(), *min_y = bounds_min[1].data(),
+              *min_z = bounds_min[2].data();
+  const float *max_x = bounds_max[0].data(), *max_y = bounds_max[1].data(),
+              *max_z = bounds_max[2].data();
+  const uint8_t* aligned = axis_aligned.data();
+  for (int row = 0; row < count; row++) {
+    float x = aligned[row] ? 0.0f : qx[row];
+    float y = aligned[row] ? 0.0f : qy[row];
+    float z = aligned[row] ? 0.0f : qz[row];
+    float w = aligned[row] ? 1.0f : qw[row];
+    float r00 = 1 - 2 * (y * y + z * z), r01 = 2 * (x * y + w * z),
+          r02 = 2 * (x * z - w * y);
+    float r10 = 2 * (x * y - w * z), r11 = 1 - 2 * (x * x + z * z),
+          r12 = 2 * (y * z + w * x);
+    float r20 = 2 * (x * z + w * y), r21 = 2 * (y * z - w * x),
+          r22 = 1 - 2 * (x * x + y * y);
+    float cx = (min_x[row] + max_x[row]) * 0.5f;
+    float cy = (min_y[row] + max_y[row]) * 0.5f;
+    float cz = (min_z[row] + max_z[row]) * 0.5f;
+    float ex = (max_x[row] - min_x[row]) * 0.5f;
+    float ey = (max_y[row] - min_y[row]) * 0.5f;
+    float ez = (max_z[row] - min_z[row]) * 0.5f;
+    float wcx = px[row] + r00 * cx + r10 * cy + r20 * cz;
+    float wcy = py[row] + r01 * cx + r11 * cy + r21 * cz;
+    float wcz = pz[row] + r02 * cx + r12 * cy + r22 * cz;
+    float wex = std::abs(r00) * ex + std::abs(r10) * ey + std::abs(r20) * ez;
+    float wey = std::abs(r01) * ex + std::abs(r11) * ey + std::abs(r21) * ez;
+    float wez = std::abs(r02) * ex + std::abs(r12) * ey + std::abs(r22) * ez;
+    bounds[row].min = glm::vec3(wcx - wex, wcy - wey, wcz - wez);
+    bounds[row].max = glm::vec3(wcx + wex, wcy + wey, wcz + wez);
+  }
+}
+
+// saves every row's world position, orientation, and scale to blend from
+// and for updates to read, call it before each simulation step
+void TransformStore::SavePreviousPoses() {
+  RefreshHierarchy();
+  for (int i = 0; i < 3; i++) {
+    previous_position[i] = position[i];
+    previous_scale[i] = scale[i];
+  }
+  for (int i = 0; i < 4; i++) {
+    previous_orientation[i] = orientation[i];
+  }
+  has_previous.assign(handles.size(), 1);
+}
+
+// alpha is from 0 to 1
+// moves every row that changed since SavePreviousPoses alpha of the way
+// from its saved pose to its current one until EndInterpolation, nothing
+// may be moved in between
+void TransformStore::BeginInterpolation(float alpha) {
+  RefreshHierarchy();
+  interpolated.clear();
+  saved_poses.clear();
+  for (int row = 0; row < handles.size(); row++) {
+    if (!has_previous[row]) {
+      continue;
+    }
+    // most rows stand still, so only the ones that moved are touched
+    float* now[10] = {&position[0][row], &position[1][row], &position[2][row],
+                      &orientation[0][row], &orientation[1][row],
+                      &orientation[2][row], &orientation[3][row],
+                      &scale[0][row], &scale[1][row], &scale[2][row]};
+    const float before[10] = {previous_position[0][row],
+      previous_position[1][row], previous_position[2][row],
+      previous_orientation[0][row], previous_orientation[1][row],
+      previous_orientation[2][row], previous_orientation[3][row],
+      previous_scale[0][row], previous_scale[1][row], previous_scale[2][row]};
+    bool changed = false;
+    for (int i = 0; i < 10; i++) {
+      changed |= *now[i] != before[i];
+    }
+    if (!changed) {
+      continue;
+    }
+    interpolated.push_back(row);
+    for (int i = 0; i < 10; i++) {
+      saved_poses.push_back(*now[i]);
+    }
+    // orientations are blended the short way around and renormalized
+    float dot = 0;
+    for (int i = 3; i < 7; i++) {
+      dot += *now[i] * before[i];
+    }
+    float sign = dot < 0 ? -1.0f : 1.0f;
+    float length = 0;
+    for (int i = 0; i < 10; i++) {
+      float from = (i >= 3 && i < 7) ? before[i] * sign : before[i];
+      *now[i] = from + (*now[i] - from) * alpha;
+      if (i >= 3 && i < 7) {
+        length += *now[i] * *now[i];
+      }
+    }
+    length = std::sqrt(length);
+    for (int i = 3; i < 7; i++) {
+      *now[i] /= length;
+    }
+    dirty[row] = 1;
+  }
+}
+
+// puts back the poses BeginInterpolation blended
+void TransformStore::EndInterpolation() {
+  for (int i = 0; i < interpolated.size(); i++) {
+    int row = interpolated[i];
+    const float* pose = &saved_poses[i * 10];
+    for (int axis = 0; axis < 3; axis++) {
+      position[axis][row] = pose[axis];
+      scale[axis][row] = pose[7 + axis];
+    }
+    for (int component = 0; component < 4; component++) {
+      orientation[component][row] = pose[3 + component];
+    }
+    dirty[row] = 1;
+  }
+  interpolated.clear();
+}
+
+// returns the store every game object keeps its transform in
+TransformStore& Transforms() {
+  static TransformStore transforms;
+  return transforms;
+}
+
+// returns the handle of the transform the calling thread is updating or
+// TRANSFORM_STORE_NULL
+int UpdatingTransform() {
+  return updating_transform;
+}
+
+// handle is a handle in Transforms() or TRANSFORM_STORE_NULL
+// makes the calling thread read every transform but handle and its
+// descendants from the poses saved at the start of the step, and only
+// change those, until it is called again with TRANSFORM_STORE_NULL
+void SetUpdatingTransform(int handle) {
+  updating_transform = handle;
+}
+
+}  // namespace engine
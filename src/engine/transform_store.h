@@ -0,0 +1,298 @@
+#ifndef SRC_ENGINE_TRANSFORM_STORE_H_
+#define SRC_ENGINE_TRANSFORM_STORE_H_
+
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+// C/C++ std lib
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// lib
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+// src
+#include "engine/aabb_tree.h"
+#include "engine/constants.h"
+
+namespace engine {
+
+// Forward declare GameObject
+class GameObject;
+
+// TransformStore keeps the position, orientation, scale, and bounding box of
+// every game object in one array per component instead of inside the
+// objects, so passes over all of them walk straight through memory. Rows are
+// kept packed at the front of each array and each object holds a handle that
+// stays the same when rows move. Each row also caches its world matrix, which
+// is marked dirty whenever the position, orientation, or scale is set.
+//
+// A transform can have a parent. The main arrays always hold world values and
+// a child also keeps its pose relative to its parent. Moving a parent only
+// flags its children, their world values are worked out the next time they
+// are read or by UpdateHierarchy, which walks every child after its parent.
+//
+// The world pose of every row is also saved before each simulation step, so
+// rendering can blend each row between its last two poses and the frame rate
+// doesn't have to match the step rate.
+//
+// Those saved poses are also the snapshot updates read from. While a thread
+// is updating a transform, set with SetUpdatingTransform, it sees that
+// transform and its descendants as it leaves them and every other one as it
+// was at the start of the step, so what an update sees doesn't depend on
+// which updates ran before it or on another thread.
+class TransformStore {
+ private:
+  // Slot is the row a handle's transform is in, or the next free handle when
+  // it is unused
+  struct Slot {
+    int row;
+    int next_free;
+  };
+
+  std::vector<Slot> slots;
+  // handles[i] is the handle of row i and owners[i] is the game object it
+  // belongs to
+  std::vector<int> handles;
+  std::vector<GameObject*> owners;
+  int free_list;
+
+  // One array per component, x y z for vectors and x y z w for quaternions
+  std::vector<float> position[3];
+  std::vector<float> orientation[4];
+  std::vector<float> scale[3];
+  std::vector<float> bounds_min[3];
+  std::vector<float> bounds_max[3];
+  std::vector<uint8_t> axis_aligned;
+  std::vector<glm::mat4> world_matrix;
+  std::vector<uint8_t> dirty;
+
+  // Hierarchy, parent, first_child, and next_sibling are handles. The local
+  // arrays are only used by rows with a parent, world_dirty means a row's
+  // world values are out of date and moved means they changed because an
+  // ancestor moved since the last UpdateHierarchy.
+  std::vector<int> parent;
+  std::vector<int> first_child;
+  std::vector<int> next_sibling;
+  std::vector<float> local_position[3];
+  std::vector<float> local_orientation[4];
+  std::vector<float> local_scale[3];
+  std::vector<uint8_t> world_dirty;
+  std::vector<uint8_t> moved;
+  // hierarchy is every child's handle with each parent before its children,
+  // it is rebuilt when a parent changes
+  std::vector<int> hierarchy;
+  bool hierarchy_changed;
+
+  // Interpolation, the previous arrays are each row's world pose when
+  // SavePreviousPoses was last called and has_previous is 0 for rows added
+  // since then. interpolated is the rows BeginInterpolation blended and
+  // saved_poses is their real poses, 10 floats per row.
+  std::vector<float> previous_position[3];
+  std::vector<float> previous_orientation[4];
+  std::vector<float> previous_scale[3];
+  std::vector<uint8_t> has_previous;
+  std::vector<int> interpolated;
+  std::vector<float> saved_poses;
+
+  // row is a row in this and live is whether to use its live pose instead
+  // of its saved one
+  // returns the world space axis aligned box around row's bounding box
+  AABB RowWorldBounds(int row, bool live) const;
+
+  // handle is a handle in this
+  // returns whether handle is the transform the calling thread is updating
+  // or one of its descendants, or the thread isn't updating one
+  bool IsUpdating(int handle) const;
+
+  // handle is a handle in this
+  // returns whether the calling thread reads handle's live values instead of
+  // its saved pose, rows added since the poses were saved are always live
+  bool IsLive(int handle) const;
+
+  // handle is a handle in this
+  // throws a string exception if the calling thread is updating a transform
+  // and handle isn't it or one of its descendants
+  void CheckWritable(int handle) const;
+
+  // from and to are rows in this
+  // copies every array at row from into row to
+  void MoveRow(int from, int to);
+
+  // row is a row in this
+  // works out the world values of row's parent and then row from its local
+  // values if they are out of date
+  void Refresh(int row);
+
+  // row is a row with a parent
+  // sets row's local values from its world values and its parent's
+  void UpdateLocal(int row);
+
+  // row is a row in this
+  // flags row's descendants so their world values get worked out again
+  void MarkChildrenDirty(int row);
+
+  // handle is a handle in this
+  // appends every descendant of handle to hierarchy, parents first
+  void AppendChildren(int handle);
+
+  // rebuilds hierarchy if it changed and brings every child up to date
+  void RefreshHierarchy();
+
+ public:
+  // Default Constructor
+  TransformStore() : free_list(TRANSFORM_STORE_NULL),
+                     hierarchy_changed(false) {}
+
+  // owner is the game object the transform belongs to
+  // adds an identity transform with an empty bounding box and returns its
+  // handle, throws a string exception while the calling thread is updating
+  // a transform
+  int Insert(GameObject* owner = nullptr);
+
+  // handle is a handle in this
+  // removes handle's transform by moving the last row into its place, its
+  // children keep their world values and lose their parent
+  void Remove(int handle);
+
+  // from and to are handles in this
+  // copies the world transform and bounding box of from into to
+  void Copy(int from, int to);
+
+  // returns how many transforms are in this
+  int Size() const {return handles.size();}
+
+  // row is a row in this
+  // returns the handle of the transform in row
+  int GetHandle(int row) const {return handles[row];}
+
+  // handle is a handle in this
+  // returns the row handle's transform is in
+  int GetRow(int handle) const {return slots[handle].row;}
+
+  // handle is a handle in this
+  // returns the game object handle belongs to
+  GameObject* GetOwner(int handle) const {return owners[slots[handle].row];}
+
+  // handle is a handle in this and parent is another handle or
+  // TRANSFORM_STORE_NULL
+  // makes handle a child of parent without changing its world transform,
+  // throws a string exception if parent is handle or one of its descendants
+  // or the calling thread is updating a transform
+  void SetParent(int handle, int parent);
+
+  // handle is a handle in this
+  // returns handle's parent or TRANSFORM_STORE_NULL
+  int GetParent(int handle) const {return parent[slots[handle].row];}
+
+  // handle is a handle in this
+  // getters and setters for each component of handle's world transform, the
+  // getters read the snapshot and the setters throw a string exception when
+  // the calling thread is updating a transform that isn't handle or one of
+  // its ancestors
+  glm::vec3 GetPosition(int handle);
+  void SetPosition(int handle, glm::vec3 position);
+  glm::quat GetOrientation(int handle);
+  void SetOrientation(int handle, glm::quat orientation);
+  glm::vec3 GetScale(int handle);
+  void SetScale(int handle, glm::vec3 scale);
+  glm::vec3 GetBoundingBoxMin(int handle) const;
+  glm::vec3 GetBoundingBoxMax(int handle) const;
+  void SetBoundingBox(int handle, glm::vec3 minimum, glm::vec3 maximum);
+  bool GetAxisAligned(int handle) const;
+  void SetAxisAligned(int handle, bool aligned);
+
+  // handle is a handle in this
+  // getters and setters for handle's transform relative to its parent, they
+  // are the same as the world ones when it has no parent, the local getters
+  // of a child always read its live values
+  glm::vec3 GetLocalPosition(int handle);
+  void SetLocalPosition(int handle, glm::vec3 position);
+  glm::quat GetLocalOrientation(int handle);
+  void SetLocalOrientation(int handle, glm::quat orientation);
+  glm::vec3 GetLocalScale(int handle);
+  void SetLocalScale(int handle, glm::vec3 scale);
+
+  // moved is filled with handles
+  // works out the world values of every child whose ancestors moved, parents
+  // first, and adds the handle of each one that moved since the last call
+  void UpdateHierarchy(std::vector<int>* moved);
+
+  // handle is a handle in this
+  // returns whether handle's world matrix needs to be rebuilt
+  bool IsDirty(int handle) const {return dirty[slots[handle].row];}
+
+  // handle is a handle in this
+  // marks handle's world matrix and its children as out of date, throws a
+  // string exception like the setters
+  void SetDirty(int handle);
+
+  // handle is a handle in this
+  // returns handle's cached world matrix
+  const glm::mat4& GetWorldMatrix(int handle) const {
+    return world_matrix[slots[handle].row];
+  }
+
+  // handle is a handle in this and matrix is its rebuilt world matrix
+  // caches matrix and marks handle clean
+  void SetWorldMatrix(int handle, const glm::mat4 &matrix);
+
+  // axis is 0, 1, or 2 for x, y, or z and component is 0 to 3 for x y z w
+  // returns the world array of that component for every row, only rows
+  // without a parent can be changed through these and they have to be marked
+  // with SetDirty
+  float* GetPositions(int axis) {return position[axis].data();}
+  const float* GetPositions(int axis) const {return position[axis].data();}
+  float* GetOrientations(int component) {
+    return orientation[component].data();
+  }
+  const float* GetOrientations(int component) const {
+    return orientation[component].data();
+  }
+  float* GetScales(int axis) {return scale[axis].data();}
+  const float* GetScales(int axis) const {return scale[axis].data();}
+
+  // handle is a handle in this
+  // returns the world space axis aligned box around handle's bounding box,
+  // read from the snapshot like the getters
+  AABB GetWorldBounds(int handle);
+
+  // bounds has room for Size() boxes
+  // fills bounds with the world space box of every row in row order
+  void GetWorldBounds(AABB* bounds);
+
+  // saves every row's world position, orientation, and scale to blend from
+  // and for updates to read, call it before each simulation step
+  void SavePreviousPoses();
+
+  // alpha is from 0 to 1
+  // moves every row that changed since SavePreviousPoses alpha of the way
+  // from its saved pose to its current one until EndInterpolation, nothing
+  // may be moved in between
+  void BeginInterpolation(float alpha);
+
+  // puts back the poses BeginInterpolation blended
+  void EndInterpolation();
+};
+
+// returns the store every game object keeps its transform in
+TransformStore& Transforms();
+
+// returns the handle of the transform the calling thread is updating or
+// TRANSFORM_STORE_NULL
+int UpdatingTransform();
+
+// handle is a handle in Transforms() or TRANSFORM_STORE_NULL
+// makes the calling thread read every transform but handle and its
+// descendants from the poses saved at the start of the step, and only
+// change those, until it is called again with TRANSFORM_STORE_NULL
+void SetUpdatingTransform(int handle);
+
+}  // namespace engine
+
+#endif  // SRC_ENGINE_TRANSFORM_STORE_H_
@@ -9,9 +9,9 @@ namespace engine {
 UI::UI() {
   Initialize();
 }
-UI::UI(const std::string &image_file) {
+UI::UI(const std::string &image_file, AssetRegistry* assets) {
   Initialize();
-  Load(image_file);
+  Load(image_file, assets);
 }
 
 // called by all constructors
@@ -20,24 +20,23 @@ void UI::Initialize() {
   screen_ratio = 1.0f;
 }
 
-void UI::Load(const std::string &image_file) {
-  image.Load(image_file);
+void UI::Load(const std::string &image_file, AssetRegistry* assets) {
+  image.Load(image_file, assets);
 }
 
 void UI::Draw() const {
-  // Covert the quaternion into something readable for glfw
-  glm::mat4 rot_mat = glm::toMat4(orientation);
-  glm::vec3 pos = GetScreenPosition();
-
   glPushMatrix();
     // Apply Transformations
-    glTranslatef(pos.x, pos.y, pos.z);
-    glMultMatrixf(glm::value_ptr(rot_mat));
-    glScalef(scale.x, scale.y, scale.z);
+    glMultMatrixf(glm::value_ptr(GetWorldMatrix()));
 
     // Draw the model
     image.Draw();
   glPopMatrix();
 }
 
+// returns the world matrix at the screen position
+glm::mat4 UI::ComputeWorldMatrix() const {
+  return ComposeMatrix(GetScreenPosition(), GetOrientation(), GetScale());
+}
+
 }  // namespace engine
@@ -25,21 +25,25 @@ class UI : public GameObject {
 
   // Default Constructor
   UI();
-  explicit UI(const std::string &image_file);
+  explicit UI(const std::string &image_file, AssetRegistry* assets = nullptr);
 
   // called by all constructors
   void Initialize();
 
-  void Load(const std::string &image_file);
+  void Load(const std::string &image_file, AssetRegistry* assets = nullptr);
 
   void Draw() const;
 
+  // returns the world matrix at the screen position
+  glm::mat4 ComputeWorldMatrix() const;
+
   void Update(float delta) {
     // this->Draw();
   }
 
   // Getters
   glm::vec3 GetScreenPosition() const {
+    glm::vec3 position = GetPosition();
     float x = (position.x*2.0f)-1.0f;
     float y = (position.y*2.0f)-1.0f;
     return glm::vec3(x*screen_ratio, y, position.z);
@@ -62,6 +66,9 @@ class UI : public GameObject {
     image.SetAttributes(w, h, f, o);
   }
   void SetScreenRatio(float ratio) {
+    if (ratio != screen_ratio) {
+      SetWorldMatrixDirty();
+    }
     screen_ratio = ratio;
     image.SetScreenRatio(ratio);
   }
@@ -3,13 +3,18 @@
  */
 
 #include "engine/ui_model.h"
+#include "engine/asset_registry.h"
 
 namespace engine {
 
-void UIModel::Load(const std::string &image_file) {
+void UIModel::Load(const std::string &image_file, AssetRegistry* assets) {
   // Load texture
   materials.insert({"texture", Material()});
-  materials.at("texture").SetTexture(image_file);
+  if (assets != nullptr) {
+    materials.at("texture").SetTexture(assets->GetTexture(image_file));
+  } else {
+    materials.at("texture").SetTexture(image_file);
+  }
   materials.at("texture").SetShininess(128);
   materials.at("texture").SetAmbient(glm::vec3(0.0, 0.0, 1.0));
   materials.at("texture").SetDiffuse(glm::vec3(0.8, 0.8, 1.0));
@@ -35,6 +40,7 @@ void UIModel::CreateData() {
   face_attributes.push_back(glm::vec3(3, 3, 0));
   std::vector<glm::vec3> faces = {glm::vec3(0, 1, 3), glm::vec3(0, 2, 3)};
   objects.insert({"texture", faces});
+  Cook();
 }
 
 // fills the verticies vector
@@ -100,6 +106,7 @@ void UIModel::CreateVertices() {
   verticies.push_back(glm::vec4(r, t, 0, W_DEFAULT));
   verticies.push_back(glm::vec4(l, b, 0, W_DEFAULT));
   verticies.push_back(glm::vec4(r, b, 0, W_DEFAULT));
+  Cook();
 }
 
 }  // namespace engine
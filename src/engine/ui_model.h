@@ -76,8 +76,10 @@ class UIModel : public Model {
     }
   }
 
-  // Overload Load function
-  void Load(const std::string &image_file);
+  // image_file is the path to an image and assets may be null
+  // Overload Load function, the image is shared through assets when it is
+  // given
+  void Load(const std::string &image_file, AssetRegistry* assets = nullptr);
 };
 
 }  // namespace engine
@@ -8,7 +8,8 @@ namespace turbotanks {
 
 void Collectable::Update(float delta) {
   if (Intersects(*player)) {
-    Collect();
+    // collecting changes the player, which other updates may be reading
+    project->Defer([this] {Collect();});
     project->RemoveRigidBody(id);
   }
 
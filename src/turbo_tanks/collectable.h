@@ -26,7 +26,7 @@ class Collectable : public engine::RigidBody {
   engine::Animation down;
 
   // Constructor
-  explicit Collectable(const engine::Model* model) : engine::RigidBody(model) {
+  explicit Collectable(engine::ModelHandle model) : engine::RigidBody(model) {
     tags.push_back("collectable");
     up.SetPositionStart(glm::vec3(0, 0, 0));
     up.SetPositionDestination(glm::vec3(0, 0.25, 0));
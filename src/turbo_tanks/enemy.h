@@ -31,17 +31,32 @@ class Enemy : public engine::RigidBody {
   const float view_dist = 20;
   const float spin_speed = 45;
   const float movespeed = 2;
+  // sight_ignore is the tags the enemy can see through and collision_ignore
+  // is the tags it drives through
+  engine::TagMask sight_ignore;
+  engine::TagMask collision_ignore;
+  // can_see is whether the player was in sight this step, the cannon reads
+  // it after this updates
+  bool can_see;
 
  public:
   EnemyCannon* cannon;
   Player* player;
 
-  explicit Enemy(const engine::Model* model) : engine::RigidBody(model) {
+  explicit Enemy(engine::ModelHandle model) : engine::RigidBody(model) {
     health = max_health;
+    can_see = false;
     velocity = glm::vec3(0, 0, 0);
     tags.push_back("enemy");
+    sight_ignore = engine::MakeTagMask({"enemy", "energyball", "player",
+    "playercannon", "enemycannon"});
+    collision_ignore = engine::MakeTagMask({"camera", "energyball", "floor",
+    "collectable", "enemycannon"});
   }
 
+  // returns whether the player was in sight this step
+  bool CanSeePlayer() const {return can_see;}
+
   void Hurt(float amount) {
     health -= amount;
     if (health < 0) {
@@ -51,6 +66,12 @@ class Enemy : public engine::RigidBody {
     }
   }
 
+  // type is the projectile type that hit this
+  // energy balls take 10 health
+  void OnProjectileHit(int type) {
+    Hurt(10.0f);
+  }
+
   void Update(float delta) {
     glm::vec3 dif = player->GetPosition() - GetPosition();
     float len = glm::length(dif);
@@ -59,12 +80,10 @@ class Enemy : public engine::RigidBody {
     z_vec = glm::normalize(z_vec);
     float dot = glm::dot(glm::vec2(z_vec.x, z_vec.z), glm::vec2(dif.x, dif.z));
     float angle = engine::rad2deg(acos(dot));
-    std::vector<std::string> ignore = {"enemy", "energyball", "player",
-    "playercannon", "enemycannon"};
-    if (std::abs(angle) <= cone_angle && len < view_dist &&
-    project->RayCast(GetPosition(), player->GetPosition(), ignore) == -1) {
+    can_see = std::abs(angle) <= cone_angle && len < view_dist &&
+    project->LineOfSight(GetPosition(), player->GetPosition(), sight_ignore);
+    if (can_see) {
       LookAt(GetPosition(), player->GetPosition(), glm::vec3(0, 1, 0));
-      cannon->can_see = true;
       if (len > view_dist/2.0f) {
         velocity.z = engine::clamp(velocity.z-(movespeed*delta),
         -movespeed, movespeed);
@@ -72,14 +91,12 @@ class Enemy : public engine::RigidBody {
         velocity.z = 0;
       }
     } else {
-      cannon->can_see = false;
       Turn(spin_speed*delta, glm::vec3(0, 1, 0));
     }
 
     // Collision
     Move(velocity);
-    ignore = {"camera", "energyball", "floor", "collectable", "enemycannon"};
-    if (project->Collides(id, ignore) != -1) {
+    if (project->Collides(id, collision_ignore) != -1) {
       Move(-velocity);
       velocity.z = -velocity.z/2.0f;
     }
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include "turbo_tanks/enemy_cannon.h"
+#include "turbo_tanks/enemy.h"
+
+namespace turbotanks {
+
+// Override parent Update
+// the enemy is this cannon's parent so it has already updated this step and
+// only it changes whether the player is in sight
+void EnemyCannon::Update(float delta) {
+  // this is attached to the enemy so it only has to turn
+  if (enemy->CanSeePlayer()) {
+    LookAt(player->GetPosition(), glm::vec3(0, 1, 0));
+    aiming = true;
+
+    // Fireing
+    if (cooldown <= 0) {
+      // Machine Gun
+      glm::quat dir = GetOrientation();
+      glm::vec3 bullet_v = dir * glm::vec3(0, 0, -machinegun_bullet_speed);
+      project->GetProjectiles()->Spawn(energyball_type,
+                                       enemy->GetPosition(), dir, bullet_v);
+      cooldown = machinegun_cooldown;
+    } else {
+      cooldown -= delta;
+    }
+  } else if (aiming) {
+    // face the same way as the enemy again
+    SetLocalOrientation(glm::quat(1, 0, 0, 0));
+    aiming = false;
+  }
+
+  RigidBody::Update(delta);
+}
+
+}  // namespace turbotanks
@@ -20,59 +20,35 @@
 
 namespace turbotanks {
 
+class Enemy;
 class EnemyCannon : public engine::RigidBody {
  private:
   float cooldown;
   const float machinegun_cooldown = 0.1f;  // seconds
   const float machinegun_bullet_speed = 15;
   const float machine_cost = 0.1;
-  const engine::Model* energyball_md;
+  // energyball_type is the projectile type this shoots
+  int energyball_type;
+  // aiming is whether this has turned away from the way the enemy faces
+  bool aiming;
 
  public:
-  RigidBody* enemy;
+  Enemy* enemy;
   Player* player;
-  bool can_see;
 
   // Constructor
-  explicit EnemyCannon(const engine::Model* model, const engine::Model* eb_md):
+  // energyball_type is the projectile type to shoot, it has to be added
+  // before the first update because updates can't add types
+  explicit EnemyCannon(engine::ModelHandle model, int energyball_type):
   engine::RigidBody(model) {
     cooldown = 0;
-    energyball_md = eb_md;
+    this->energyball_type = energyball_type;
     tags.push_back("enemycannon");
-    can_see = false;
+    aiming = false;
   }
 
   // Override parent Update
-  void Update(float delta) {
-    if (can_see) {
-      LookAt(enemy->GetPosition(), player->GetPosition(), glm::vec3(0, 1, 0));
-
-      // Fireing
-      if (cooldown <= 0) {
-        // Machine Gun
-        glm::quat dir = GetOrientation();
-        glm::vec3 bullet_v = glm::vec3(0, 0, -1);
-        bullet_v *= (machinegun_bullet_speed*delta);
-        EnergyBall* bullet = new EnergyBall(bullet_v, energyball_md);
-        bullet->cannon = this;
-        bullet->parent = enemy;
-        bullet->ignore =  {"enemy", "enemycannon"};
-        bullet->SetColor(glm::vec4(1, 0, 0, 1));
-        bullet->SetPosition(bullet->parent->GetPosition());
-        bullet->SetOrientation(bullet->cannon->GetOrientation());
-        // std::cout << "here" << std::endl;
-        project->AddRigidBody(bullet);
-        cooldown = machinegun_cooldown;
-      } else {
-        cooldown -= delta;
-      }
-    } else {
-      SetPosition(enemy->GetPosition());
-      SetOrientation(enemy->GetOrientation());
-    }
-
-    RigidBody::Update(delta);
-  }
+  void Update(float delta);
 };
 
 }  // namespace turbotanks
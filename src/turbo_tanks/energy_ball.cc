@@ -3,32 +3,25 @@
  */
 
 #include "turbo_tanks/energy_ball.h"
-#include "turbo_tanks/enemy.h"
-#include "turbo_tanks/player.h"
 
 namespace turbotanks {
 
-// Override parent Update
-void EnergyBall::Update(float delta) {
-  Move(velocity);
-  int o_id = project->Collides(id, ignore);
-  if (life_timer >= lifespan || o_id != -1
-  || !project->WithInRender(GetPosition())) {
-    if (o_id != -1) {
-      Enemy* en = dynamic_cast<Enemy*>(project->GetObject(o_id));
-      if (en) {
-        en->Hurt(10.0f);
-      }
-      Player* pl = dynamic_cast<Player*>(project->GetObject(o_id));
-      if (pl) {
-        pl->Hurt(1.0f);
-      }
-    }
-    project->RemoveRigidBody(id);
-  }
-  life_timer += delta;
-
-  RigidBody::Update(delta);
+// project is the project to shoot in, name is the name of the type, md is
+// the energy ball model, and ignore is a list of tags the balls pass through
+// adds an energy ball projectile type to the current scene's projectiles
+// and returns its index, enemies and players hurt themselves in
+// OnProjectileHit
+int AddEnergyBallType(engine::Project* project, std::string name,
+                      engine::ModelHandle md, std::vector<std::string> ignore) {
+  engine::ProjectileType type;
+  type.name = name;
+  type.model = md;
+  type.bounding_box_min = md->GetBoundMin();
+  type.bounding_box_max = md->GetBoundMax();
+  type.lifespan = 10;  // seconds
+  type.tags = {"energyball"};
+  type.ignore = ignore;
+  return project->GetProjectiles()->AddType(type);
 }
 
 }  // namespace turbotanks
@@ -13,39 +13,18 @@
 #include "glm/vec3.hpp"
 // Src
 #include "engine/model.h"
-#include "engine/rigid_body.h"
 #include "engine/project.h"
+#include "engine/projectile_system.h"
 
 namespace turbotanks {
 
-class Enemy;
-class Player;
-class EnergyBall : public engine::RigidBody {
- private:
-  glm::vec3 velocity;
-  float life_timer;
-  const float lifespan = 10;  // seconds
-
- public:
-  std::vector<std::string> ignore;
-  RigidBody* cannon;
-  RigidBody* parent;
-  // Constructor
-  explicit EnergyBall(glm::vec3 velocity, const engine::Model* md) :
-  engine::RigidBody(md) {
-    this->velocity = velocity;
-    life_timer = 0;
-    tags.push_back("energyball");
-  }
-
-  // Override parent Update
-  void Update(float delta);
-
-  // Deconstructor
-  ~EnergyBall() {
-    delete model;
-  }
-};
+// project is the project to shoot in, name is the name of the type, md is
+// the energy ball model, and ignore is a list of tags the balls pass through
+// adds an energy ball projectile type to the current scene's projectiles
+// and returns its index, enemies and players hurt themselves in
+// OnProjectileHit
+int AddEnergyBallType(engine::Project* project, std::string name,
+                      engine::ModelHandle md, std::vector<std::string> ignore);
 
 }  // namespace turbotanks
 
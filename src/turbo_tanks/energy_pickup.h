@@ -19,7 +19,7 @@ class EnergyPickup : public Collectable {
   const float amount = 50;
 
  public:
-  explicit EnergyPickup(const engine::Model* md) : turbotanks::Collectable(md) {
+  explicit EnergyPickup(engine::ModelHandle md) : turbotanks::Collectable(md) {
     tags.push_back("energypickup");
   }
 
@@ -15,7 +15,9 @@ class EnergyUI : public engine::UI {
  public:
   Player* player;
 
-  explicit EnergyUI(const std::string &image_file) : engine::UI(image_file) {
+  explicit EnergyUI(const std::string &image_file,
+                    engine::AssetRegistry* assets = nullptr) :
+  engine::UI(image_file, assets) {
     tags.push_back("energy_ui");
   }
 
@@ -19,7 +19,7 @@ class HealthPickup : public Collectable {
   const float amount = 50;
 
  public:
-  explicit HealthPickup(const engine::Model* md) : turbotanks::Collectable(md) {
+  explicit HealthPickup(engine::ModelHandle md) : turbotanks::Collectable(md) {
     tags.push_back("healthpickup");
   }
 
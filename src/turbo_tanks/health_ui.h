@@ -15,7 +15,9 @@ class HealthUI : public engine::UI {
  public:
   Player* player;
 
-  explicit HealthUI(const std::string &image_file) : engine::UI(image_file) {
+  explicit HealthUI(const std::string &image_file,
+                    engine::AssetRegistry* assets = nullptr) :
+  engine::UI(image_file, assets) {
     tags.push_back("health_ui");
   }
 
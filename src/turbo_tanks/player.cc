@@ -9,10 +9,12 @@ namespace turbotanks {
 // model is a pointer to a Model
 // This calls the constructor of RigidBody and also does what needs to be done
 // on creation
-Player::Player(const engine::Model* model): engine::RigidBody(model) {
+Player::Player(engine::ModelHandle model): engine::RigidBody(model) {
   velocity = glm::vec2(0, 0);
   tags.push_back("player");
-  bounding_box_axis_aligned = true;
+  collision_ignore = engine::MakeTagMask({"player", "playercannon", "camera",
+  "energyball", "floor", "collectable"});
+  SetBoundingBoxAxisAligned(true);
   energy = max_energy;
   health = max_health;
   move.SetLength(1);
@@ -55,15 +57,13 @@ void Player::Update(float delta) {
   glm::vec3 move_x(velocity.x*delta, 0, 0);
   glm::vec3 move_y(0, 0, velocity.y*delta);
   Move(move_x);
-  std::vector<std::string> ignore = {"player", "playercannon", "camera",
-  "energyball", "floor", "collectable"};
-  // std::cout << project->Collides(id, ignore) << std::endl;
-  if (project->Collides(id, ignore) != -1) {
+  // std::cout << project->Collides(id, collision_ignore) << std::endl;
+  if (project->Collides(id, collision_ignore) != -1) {
     Move(-move_x);
     velocity.x = -velocity.x/2.0f;
   }
   Move(move_y);
-  if (project->Collides(id, ignore) != -1) {
+  if (project->Collides(id, collision_ignore) != -1) {
     Move(-move_y);
     velocity.y = -velocity.y/2.0f;
   }
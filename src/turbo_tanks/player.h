@@ -33,12 +33,14 @@ class Player : public engine::RigidBody {
   float energy;
   float health;
   engine::Animation move;
+  // collision_ignore is the tags the player drives through
+  engine::TagMask collision_ignore;
 
  public:
   // model is a pointer to a Model
   // This calls the constructor of RigidBody and also does what needs to be done
   // on creation
-  explicit Player(const engine::Model* model);
+  explicit Player(engine::ModelHandle model);
 
   // energy is a float
   // adds energy to this->energy
@@ -80,6 +82,19 @@ class Player : public engine::RigidBody {
     }
   }
 
+  // type is the projectile type that hit this
+  // energy balls take 1 health
+  void OnProjectileHit(int type) {
+    Hurt(1.0f);
+  }
+
+  // hash is the hash to continue from
+  // returns hash with the player's pose, velocity, energy, and health mixed in
+  uint64_t Hash(uint64_t hash) const {
+    float state[4] = {velocity.x, velocity.y, energy, health};
+    return engine::HashBytes(state, sizeof(state), RigidBody::Hash(hash));
+  }
+
   // delta is the time the last frame took to process
   // This function happens every frame
   void Update(float delta);
@@ -24,19 +24,21 @@ void PlayerCamera::Update(float delta) {
   look_angle += aim_input.y * vertical_sensitivity;
   look_angle = engine::clamp(look_angle, max_d_angle, max_u_angle);
   // std::cout << look_angle << std::endl;
-  SetOrientation(player->GetOrientation());
-  SetPosition(player->GetPosition());
-  Move(glm::vec3(0.5f, 1.0f, 0.0f));
-  Turn(look_angle, glm::vec3(1.0, 0.0, 0.0));
-  glm::vec3 start = GetPosition();
-  Move(glm::vec3(0.0f, 0.0f, 3.0f));
-  glm::vec3 end = GetPosition();
-  glm::vec3 temp = end-start;
-  std::vector<std::string> ignore = {"player", "camera"};
-  float dist = project->RayCast(start, end, ignore);
+  // this is attached to the player and sits on a boom that pivots above the
+  // player's right side
+  glm::quat pitch = engine::AxisToQuat(look_angle, glm::vec3(1, 0, 0), false);
+  glm::vec3 pivot(0.5f, 1.0f, 0.0f);
+  glm::vec3 boom = pitch * glm::vec3(0.0f, 0.0f, 3.0f);
+  // pull the camera in if something is between it and the pivot
+  glm::quat player_o = player->GetOrientation();
+  glm::vec3 start = player->GetPosition() + (player_o * pivot);
+  glm::vec3 end = start + (player_o * boom);
+  float dist = project->RayCast(start, end, boom_ignore);
   if (dist != -1) {
-    Move(glm::vec3(0, 0, -(glm::length(end-start) - dist)));
+    boom *= dist / glm::length(boom);
   }
+  SetLocalOrientation(pitch);
+  SetLocalPosition(pivot + boom);
 }
 
 }  // namespace turbotanks
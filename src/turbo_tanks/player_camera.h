@@ -27,6 +27,8 @@ class PlayerCamera : public engine::Camera {
   const float max_u_angle = 25;
   const float max_d_angle = -18;
   float look_angle;
+  // boom_ignore is the tags that don't push the camera in
+  engine::TagMask boom_ignore;
  public:
   Player* player;
   engine::Camera* dev_cam;
@@ -34,6 +36,7 @@ class PlayerCamera : public engine::Camera {
   // Constructor
   PlayerCamera(float fov, float ner, float far):engine::Camera(fov, ner, far) {
     look_angle = 0.0f;
+    boom_ignore = engine::MakeTagMask({"player", "camera"});
     tags.push_back("playercamera");
   }
 
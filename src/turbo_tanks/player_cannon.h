@@ -29,16 +29,23 @@ class PlayerCannon : public engine::RigidBody {
   const float machinegun_cooldown = 0.1f;  // seconds
   const float machinegun_bullet_speed = 15;
   const float machine_cost = 0.1;
-  const engine::Model* energyball_md;
+  // energyball_type is the projectile type this shoots
+  int energyball_type;
+  // aim_ignore is the tags the aiming ray passes through
+  engine::TagMask aim_ignore;
  public:
   Player* player;
   engine::Camera* camera;
 
   // Constructor
-  explicit PlayerCannon(const engine::Model* model, const engine::Model* eb_md):
+  // energyball_type is the projectile type to shoot, it has to be added
+  // before the first update because updates can't add types
+  explicit PlayerCannon(engine::ModelHandle model, int energyball_type):
   engine::RigidBody(model) {
     cooldown = 0;
-    energyball_md = eb_md;
+    this->energyball_type = energyball_type;
+    aim_ignore = engine::MakeTagMask({"player", "playercannon", "camera",
+    "energyball"});
     tags.push_back("playercannon");
   }
 
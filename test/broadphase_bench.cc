@@ -0,0 +1,120 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <cfloat>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "engine/project.h"
+
+#define BENCH_BODIES 10000
+#define BENCH_PROJECTILES 2000
+#define BENCH_MAP_SIZE 300
+#define BENCH_FRAMES 30
+#define BENCH_DELTA (1.0f / 60.0f)
+
+// returns a random float from 0 to 1
+float RandomFraction() {
+  return rand() / static_cast<float>(RAND_MAX);
+}
+
+// returns a random coordinate on the map
+float RandomCoordinate() {
+  return (RandomFraction() - 0.5f) * BENCH_MAP_SIZE;
+}
+
+// project is a project, bodies are its still rigidbodies from lowest to
+// highest id, and shot is a rigidbody
+// returns the first of bodies shot hits the way Collides found it before
+// the broadphase, checking every rigidbody in the scene, or -1
+int BruteForceCollides(engine::Project* project,
+                       const std::vector<engine::RigidBody*> &bodies,
+                       engine::RigidBody* shot) {
+  for (int i = 0; i < bodies.size(); i++) {
+    if (engine::PointInBox(bodies[i]->GetPosition(), shot->GetPosition(),
+                           project->collision_radius) &&
+        shot->Intersects(*bodies[i])) {
+      return bodies[i]->id;
+    }
+  }
+  return -1;
+}
+
+// scatters BENCH_BODIES still boxes over the map and flies BENCH_PROJECTILES
+// shots through them for BENCH_FRAMES frames, checking every shot against
+// the bodies once a frame through Collides and by scanning every body,
+// prints the time of each and fails if they ever disagree
+int main() {
+  srand(1);
+  engine::Project project;
+  project.collision_radius = 3;
+  // the render box holds the whole map wherever it starts, so no body is
+  // skipped for being out of sight
+  project.render_distance = FLT_MAX;
+  std::vector<engine::RigidBody*> bodies;
+  for (int i = 0; i < BENCH_BODIES; i++) {
+    engine::RigidBody* body = new engine::RigidBody();
+    body->SetBoundingBox(glm::vec3(-1, 0, -1), glm::vec3(1, 2, 1));
+    body->SetPosition(RandomCoordinate(), 0, RandomCoordinate());
+    body->SetOrientation(RandomFraction() * 360, glm::vec3(0, 1, 0));
+    project.AddRigidBody(body);
+    bodies.push_back(body);
+  }
+  // shots pass through each other like energy balls do
+  std::vector<engine::RigidBody*> shots;
+  std::vector<glm::vec3> velocities;
+  for (int i = 0; i < BENCH_PROJECTILES; i++) {
+    engine::RigidBody* shot = new engine::RigidBody();
+    shot->tags.push_back("shot");
+    shot->SetBoundingBox(glm::vec3(-0.1f, -0.1f, -0.3f),
+                         glm::vec3(0.1f, 0.1f, 0.3f));
+    float angle = RandomFraction() * 360;
+    shot->SetPosition(RandomCoordinate(), 1, RandomCoordinate());
+    shot->SetOrientation(angle, glm::vec3(0, 1, 0));
+    project.AddRigidBody(shot);
+    shots.push_back(shot);
+    velocities.push_back(glm::vec3(sin(glm::radians(angle)), 0,
+                                   cos(glm::radians(angle))) * 20.0f);
+  }
+
+  std::chrono::duration<double, std::milli> broadphase(0);
+  std::chrono::duration<double, std::milli> brute_force(0);
+  std::vector<int> hits(BENCH_PROJECTILES);
+  int hit_count = 0;
+  for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_PROJECTILES; i++) {
+      hits[i] = project.Collides(shots[i]->id, {"shot"});
+    }
+    broadphase += std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_PROJECTILES; i++) {
+      int hit = BruteForceCollides(&project, bodies, shots[i]);
+      if (hit != hits[i]) {
+        std::cout << "in frame " << frame << " shot " << i << " hit " <<
+        hits[i] << " through the broadphase and " << hit << " by checking " <<
+        "every body" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    brute_force += std::chrono::steady_clock::now() - start;
+
+    for (int i = 0; i < BENCH_PROJECTILES; i++) {
+      hit_count += hits[i] != -1;
+      shots[i]->SetPosition(shots[i]->GetPosition() +
+                            velocities[i] * BENCH_DELTA);
+    }
+  }
+  std::cout << BENCH_PROJECTILES << " shots against " << BENCH_BODIES <<
+  " bodies, " << hit_count << " hits over " << BENCH_FRAMES << " frames" <<
+  std::endl;
+  std::cout << "broadphase: " << broadphase.count() / BENCH_FRAMES <<
+  " ms per frame" << std::endl;
+  std::cout << "every body: " << brute_force.count() / BENCH_FRAMES <<
+  " ms per frame" << std::endl;
+  exit(EXIT_SUCCESS);
+}
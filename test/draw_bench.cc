@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "engine/gl_buffer.h"
+#include "engine/model.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#define BENCH_GRID 20
+#define BENCH_FRAMES 20
+#define BENCH_WIDTH 640
+#define BENCH_HEIGHT 480
+
+// ClientArrayModel draws the way models did before they had vertex and
+// index buffers, copying the vertices, normals, texture vertices, and faces
+// out of the cooked mesh and pointing the arrays at the copies every draw
+class ClientArrayModel : public engine::Model {
+ public:
+  // obj_file_name is the path to an .obj file
+  // loads the .obj file like a Model
+  explicit ClientArrayModel(const std::string &obj_file_name)
+    : Model(obj_file_name) {}
+
+  // renders the obj file loaded from fresh copies of its arrays
+  void DrawCopies() const {
+    GLfloat * v_data = GetVertexData();
+    GLfloat * n_data = GetNormalData();
+    GLfloat * t_data = GetTextureVertexData();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(VERTEX_SIZE, GL_FLOAT, 0, v_data);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, 0, n_data);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(TEXTURE_VERTEX_SIZE, GL_FLOAT, 0, t_data);
+
+    for (auto const& mat : materials) {
+      if (cooked.face_data.find(mat.first) != cooked.face_data.end()) {
+        GLuint * f_data = GetFaceData(mat.first);
+        mat.second.Activate();
+        glDrawElements(GL_TRIANGLES, cooked.face_data.at(mat.first).size(),
+          GL_UNSIGNED_INT, f_data);
+        delete[] f_data;
+      }
+    }
+
+    delete[] v_data;
+    delete[] n_data;
+    delete[] t_data;
+  }
+};
+
+// path picks how a frame is drawn: 0 copies the arrays for every model, 1
+// draws every model from the buffers, 2 draws them all in one batch
+// model is what to draw at each of transforms
+// clears the framebuffer, draws a frame, and waits for the gpu to finish it
+void DrawFrame(int path, const ClientArrayModel &model,
+               const std::vector<glm::mat4> &transforms) {
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  if (path == 2) {
+    model.DrawBatch(transforms.data(), transforms.size());
+  } else {
+    for (int i = 0; i < transforms.size(); i++) {
+      glPushMatrix();
+        glMultMatrixf(glm::value_ptr(transforms[i]));
+        if (path == 0) {
+          model.DrawCopies();
+        } else {
+          model.Draw();
+        }
+      glPopMatrix();
+    }
+  }
+  glFinish();
+}
+
+// returns a hash of the pixels in the framebuffer
+uint64_t HashFramebuffer() {
+  std::vector<unsigned char> pixels(BENCH_WIDTH * BENCH_HEIGHT * 4);
+  glReadPixels(0, 0, BENCH_WIDTH, BENCH_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE,
+               pixels.data());
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < pixels.size(); i++) {
+    hash = (hash ^ pixels[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+// draws a BENCH_GRID by BENCH_GRID field of the model given as an argument,
+// or the tank, in a hidden window every way a model has been drawn, prints
+// the time each takes per frame, and fails if they don't draw the same image
+int main(int argc, char** argv) {
+  std::string file_name = argc > 1 ? argv[1] : "data/tank.obj";
+  if (!glfwInit()) {
+    std::cout << "glfw could not start" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  GLFWwindow* window = glfwCreateWindow(BENCH_WIDTH, BENCH_HEIGHT,
+                                        "draw_bench", NULL, NULL);
+  if (!window) {
+    glfwTerminate();
+    std::cout << "no window could be made" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  glfwMakeContextCurrent(window);
+
+  ClientArrayModel model(file_name);
+  std::vector<glm::mat4> transforms;
+  for (int x = 0; x < BENCH_GRID; x++) {
+    for (int z = 0; z < BENCH_GRID; z++) {
+      transforms.push_back(glm::rotate(
+        glm::translate(glm::mat4(1), glm::vec3(x * 2, 0, z * 2)),
+        glm::radians(x * 37.0f + z * 11.0f), glm::vec3(0, 1, 0)));
+    }
+  }
+
+  glViewport(0, 0, BENCH_WIDTH, BENCH_HEIGHT);
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_LIGHTING);
+  glEnable(GL_LIGHT0);
+  glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+  glMatrixMode(GL_PROJECTION);
+  glLoadMatrixf(glm::value_ptr(glm::perspective(glm::radians(45.0f),
+    BENCH_WIDTH / static_cast<float>(BENCH_HEIGHT), 0.1f, 200.0f)));
+  glMatrixMode(GL_MODELVIEW);
+  glLoadMatrixf(glm::value_ptr(glm::lookAt(
+    glm::vec3(-10, 20, -10), glm::vec3(BENCH_GRID, 0, BENCH_GRID),
+    glm::vec3(0, 1, 0))));
+
+  const char* names[3] = {"copied arrays", "buffers, one draw each",
+                          "buffers, one batch"};
+  uint64_t hashes[3];
+  std::cout << transforms.size() << " x " << file_name << ", " <<
+  model.GetNumVerticies() / VERTEX_SIZE << " vertices each, " <<
+  glGetString(GL_RENDERER) << std::endl;
+  if (!engine::BufferObjectsSupported()) {
+    std::cout << "no buffer objects, models fall back to client arrays" <<
+    std::endl;
+  }
+  for (int path = 0; path < 3; path++) {
+    // the first frame uploads the buffers, so it isn't timed
+    DrawFrame(path, model, transforms);
+    hashes[path] = HashFramebuffer();
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+      DrawFrame(path, model, transforms);
+    }
+    std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+    std::cout << names[path] << ": " << time.count() / BENCH_FRAMES <<
+    " ms per frame" << std::endl;
+  }
+  glfwDestroyWindow(window);
+  glfwTerminate();
+  if (hashes[1] != hashes[0] || hashes[2] != hashes[0]) {
+    std::cout << "the draw paths don't draw the same image" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "engine/project.h"
+
+#define BENCH_ENEMIES 10000
+#define BENCH_MAP_SIZE 200
+#define BENCH_STEPS 100
+#define BENCH_DELTA (1.0f / 60.0f)
+
+// BenchEnemy does what a Turbo Tanks enemy does every step, it looks for
+// the target, drives toward it or spins in place, and backs off of walls.
+// It only reads the target, which never moves, and only changes itself.
+class BenchEnemy : public engine::RigidBody {
+ public:
+  engine::GameObject* target;
+  engine::TagMask ignore;
+  bool can_see;
+
+  explicit BenchEnemy(engine::ModelHandle model) : engine::RigidBody(model) {
+    tags.push_back("enemy");
+    ignore = engine::MakeTagMask({"enemy", "enemycannon", "player"});
+    can_see = false;
+  }
+
+  void Update(float delta) {
+    glm::vec3 to_target = target->GetPosition() - GetPosition();
+    glm::vec3 forward = GetOrientation() * glm::vec3(0, 0, -1);
+    can_see = glm::length(to_target) < 20 &&
+              glm::dot(glm::normalize(to_target), forward) > 0.9f &&
+              project->LineOfSight(GetPosition(), target->GetPosition(),
+                                   ignore);
+    if (can_see) {
+      LookAt(GetPosition(), target->GetPosition(), glm::vec3(0, 1, 0));
+    } else {
+      Turn(45 * delta, glm::vec3(0, 1, 0));
+    }
+    glm::vec3 step(0, 0, -2 * delta);
+    Move(step);
+    if (project->Collides(id, ignore) != -1) {
+      Move(-step);
+    }
+    RigidBody::Update(delta);
+  }
+};
+
+// BenchCannon sits on an enemy and aims at the target when the enemy sees
+// it, enemies are updated before their cannons so reading one is safe
+class BenchCannon : public engine::RigidBody {
+ public:
+  BenchEnemy* enemy;
+
+  explicit BenchCannon(engine::ModelHandle model) : engine::RigidBody(model) {
+    tags.push_back("enemycannon");
+  }
+
+  void Update(float delta) {
+    if (enemy->can_see) {
+      LookAt(enemy->target->GetPosition(), glm::vec3(0, 1, 0));
+    } else {
+      SetLocalOrientation(glm::quat(1, 0, 0, 0));
+    }
+    RigidBody::Update(delta);
+  }
+};
+
+// returns a random float from 0 to 1
+float RandomFraction() {
+  return rand() / static_cast<float>(RAND_MAX);
+}
+
+// steps BENCH_ENEMIES enemies and their cannons in a walled map with 1 thread
+// and then twice as many up to one per core, or up to the first argument,
+// starting from the same place each time
+int main(int argc, char** argv) {
+  srand(1);
+  engine::Project project("job_bench");
+  project.Initialize(true);
+  project.render_distance = BENCH_MAP_SIZE * 2;
+  engine::ModelHandle cube = project.assets.GetModel("data/cube.obj");
+  engine::TileGrid* walls = project.AddTileGrid(glm::vec3(0, 0, 0),
+    BENCH_MAP_SIZE, BENCH_MAP_SIZE, cube);
+  walls->tags.push_back("wall");
+  for (int i = 0; i < BENCH_MAP_SIZE * BENCH_MAP_SIZE / 20; i++) {
+    walls->SetTile(rand() % BENCH_MAP_SIZE, rand() % BENCH_MAP_SIZE, true);
+  }
+  engine::RigidBody* target = new engine::RigidBody(cube);
+  target->tags.push_back("player");
+  target->SetPosition(BENCH_MAP_SIZE / 2, 0, BENCH_MAP_SIZE / 2);
+  project.AddRigidBody(target);
+
+  std::vector<BenchEnemy*> enemies;
+  std::vector<glm::vec3> start_positions;
+  std::vector<float> start_angles;
+  for (int i = 0; i < BENCH_ENEMIES; i++) {
+    BenchEnemy* enemy = new BenchEnemy(cube);
+    enemy->target = target;
+    project.AddRigidBody(enemy);
+    BenchCannon* cannon = new BenchCannon(cube);
+    cannon->enemy = enemy;
+    project.AddRigidBody(cannon);
+    cannon->SetParent(enemy);
+    enemies.push_back(enemy);
+    start_positions.push_back(glm::vec3(RandomFraction() * BENCH_MAP_SIZE, 0,
+                                        RandomFraction() * BENCH_MAP_SIZE));
+    start_angles.push_back(RandomFraction() * 360);
+  }
+
+  int max_threads = argc > 1 ? atoi(argv[1]) :
+                    static_cast<int>(std::thread::hardware_concurrency());
+  std::vector<int> thread_counts;
+  for (int threads = 1; threads < max_threads; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(std::max(1, max_threads));
+  double serial = 0;
+  for (int run = 0; run < thread_counts.size(); run++) {
+    int threads = thread_counts[run];
+    for (int i = 0; i < BENCH_ENEMIES; i++) {
+      enemies[i]->SetPosition(start_positions[i]);
+      enemies[i]->SetOrientation(start_angles[i], glm::vec3(0, 1, 0));
+    }
+    project.SetWorkerThreads(threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < BENCH_STEPS; step++) {
+      project.Step(BENCH_DELTA);
+    }
+    std::chrono::duration<double, std::milli> time =
+      std::chrono::steady_clock::now() - start;
+    if (threads == 1) {
+      serial = time.count();
+    }
+    // every run should end in the same place
+    glm::vec3 sum(0, 0, 0);
+    for (int i = 0; i < BENCH_ENEMIES; i++) {
+      sum += enemies[i]->GetPosition();
+    }
+    std::cout << threads << " threads: " << time.count() / BENCH_STEPS <<
+    " ms/step, " << serial / time.count() << "x, positions add up to " <<
+    sum.x << " " << sum.z << std::endl;
+  }
+  project.SetWorkerThreads(1);
+  exit(EXIT_SUCCESS);
+}
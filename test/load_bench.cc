@@ -0,0 +1,434 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "engine/asset_registry.h"
+#include "engine/headless.h"
+#include "engine/mesh_cache.h"
+#include "engine/model.h"
+#include "engine/texture_cache.h"
+
+#define BENCH_GRID_FILE "data/load_bench_grid.obj"
+#define BENCH_HITS 100000
+#define BENCH_CHECK_TRIANGLES 12800
+#define BENCH_PATH_SIZE 4096
+
+// ReferenceMesh is a model expanded the way the importer expanded it before
+// face attributes were hashed
+struct ReferenceMesh {
+  std::vector<GLfloat> vertex_data;
+  std::vector<GLfloat> normal_data;
+  std::vector<GLfloat> texture_vertex_data;
+  std::map<std::string, std::vector<GLuint>> face_data;
+  glm::vec3 bound_min;
+  glm::vec3 bound_max;
+};
+
+// CheckedModel is a model whose cooked arrays can be compared
+class CheckedModel : public engine::Model {
+ public:
+  // obj_file_name is the path to an .obj file
+  // loads the .obj file like a Model
+  explicit CheckedModel(const std::string &obj_file_name)
+    : Model(obj_file_name) {}
+
+  // returns the arrays the model draws from
+  const engine::CookedMesh &GetCooked() const {
+    return cooked;
+  }
+};
+
+// file_name is an .obj file and mesh is where to put it
+// imports file_name the way Model::Load did before face attributes were
+// hashed, searching every face attribute seen so far for each face corner,
+// and returns false if it couldn't be read. Indices out of range expand to
+// 0s like Cook does, the old importer read past its arrays instead.
+bool ReferenceImport(const std::string &file_name, ReferenceMesh* mesh) {
+  std::ifstream file(file_name);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::vector<glm::vec4> verticies;
+  std::vector<glm::vec2> texture_vertices;
+  std::vector<glm::vec3> normals;
+  std::vector<glm::vec3> face_attributes;
+  std::map<std::string, std::vector<glm::vec3>> objects;
+  std::string current_material = "engine::default";
+  mesh->bound_min = mesh->bound_max = glm::vec3(0, 0, 0);
+  std::string line;
+  try {
+    while (getline(file, line)) {
+      std::vector<std::string> tokens = engine::Tokenize(line);
+      if (tokens.empty()) {
+        continue;
+      }
+      if (tokens[0] == "v") {
+        if (tokens.size() != NUM_VERTEX_TOKENS &&
+            tokens.size() != NUM_VERTEX_TOKENS-1) {
+          return false;
+        }
+        glm::vec4 v(0, 0, 0, W_DEFAULT);
+        for (int i = 1; i < tokens.size(); i++) {
+          v[i-1] = std::stof(tokens[i]);
+        }
+        mesh->bound_min = glm::min(mesh->bound_min, glm::vec3(v));
+        mesh->bound_max = glm::max(mesh->bound_max, glm::vec3(v));
+        verticies.push_back(v);
+      } else if (tokens[0] == "vt") {
+        if (tokens.size() != NUM_TEXTURE_VERTEX_TOKENS) {
+          return false;
+        }
+        texture_vertices.push_back(glm::vec2(std::stof(tokens.at(1)),
+                                             std::stof(tokens.at(2))));
+      } else if (tokens[0] == "vn") {
+        normals.push_back(glm::vec3(std::stof(tokens.at(1)),
+                                    std::stof(tokens.at(2)),
+                                    std::stof(tokens.at(3))));
+      } else if (tokens[0] == "usemtl") {
+        current_material = tokens.at(1);
+        objects[current_material];
+      } else if (tokens[0] == "f") {
+        if (tokens.size() != NUM_FACE_TOKENS) {
+          return false;
+        }
+        glm::vec3 f;
+        for (int i = 1; i < NUM_FACE_TOKENS; i++) {
+          std::vector<std::string> corner = engine::Tokenize(tokens[i], "/");
+          int num_slash = std::count(tokens[i].begin(), tokens[i].end(), '/');
+          int vertex_index = std::stoi(corner[0]);
+          int texture_index = 0;
+          int normal_index = 0;
+          if (corner.size() == 1) {
+          } else if (num_slash == 1) {
+            texture_index = std::stoi(corner[1]);
+          } else if (corner.size() == 2) {
+            normal_index = std::stoi(corner[1]);
+          } else {
+            texture_index = std::stoi(corner[1]);
+            normal_index = std::stoi(corner[2]);
+          }
+          glm::vec3 fa(vertex_index - 1, texture_index - 1, normal_index - 1);
+          int index = 0;
+          while (index < face_attributes.size() &&
+                 face_attributes[index] != fa) {
+            index++;
+          }
+          if (index == face_attributes.size()) {
+            face_attributes.push_back(fa);
+          }
+          f[i-1] = index;
+        }
+        objects[current_material].push_back(f);
+      }
+    }
+  } catch (std::exception& e) {
+    return false;
+  }
+
+  int count = face_attributes.size();
+  mesh->vertex_data.assign(count * VERTEX_SIZE, 0);
+  mesh->normal_data.assign(count * NORMAL_SIZE, 0);
+  mesh->texture_vertex_data.assign(count * TEXTURE_VERTEX_SIZE, 0);
+  for (int i = 0; i < count; i++) {
+    int v = face_attributes[i].x;
+    int t = face_attributes[i].y;
+    int n = face_attributes[i].z;
+    for (int j = 0; j < VERTEX_SIZE && v >= 0 && v < verticies.size(); j++) {
+      mesh->vertex_data[(i*VERTEX_SIZE)+j] = verticies[v][j];
+    }
+    for (int j = 0; j < TEXTURE_VERTEX_SIZE && t >= 0 &&
+         t < texture_vertices.size(); j++) {
+      mesh->texture_vertex_data[(i*TEXTURE_VERTEX_SIZE)+j] =
+        texture_vertices[t][j];
+    }
+    for (int j = 0; j < NORMAL_SIZE && n >= 0 && n < normals.size(); j++) {
+      mesh->normal_data[(i*NORMAL_SIZE)+j] = normals[n][j];
+    }
+  }
+  mesh->face_data.clear();
+  for (auto const& obj : objects) {
+    std::vector<GLuint> &indices = mesh->face_data[obj.first];
+    for (int i = 0; i < obj.second.size(); i++) {
+      for (int j = 0; j < FACE_SIZE; j++) {
+        indices.push_back(obj.second[i][j]);
+      }
+    }
+  }
+  return true;
+}
+
+// a and b are arrays
+// returns whether they hold the same bytes
+template <typename T>
+bool SameBytes(const std::vector<T> &a, const std::vector<T> &b) {
+  return a.size() == b.size() &&
+         (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+// expected is the old import of a model and model is the same model loaded
+// now
+// returns whether model expanded to byte for byte the same arrays
+bool SameMesh(const ReferenceMesh &expected, const CheckedModel &model) {
+  const engine::CookedMesh &cooked = model.GetCooked();
+  bool rv = SameBytes(expected.vertex_data, cooked.vertex_data) &&
+            SameBytes(expected.normal_data, cooked.normal_data) &&
+            SameBytes(expected.texture_vertex_data,
+                      cooked.texture_vertex_data) &&
+            expected.face_data.size() == cooked.face_data.size() &&
+            expected.bound_min == model.GetBoundMin() &&
+            expected.bound_max == model.GetBoundMax();
+  for (auto const& faces : expected.face_data) {
+    rv = rv && cooked.face_data.count(faces.first) == 1 &&
+         SameBytes(faces.second, cooked.face_data.at(faces.first));
+  }
+  return rv;
+}
+
+// name is what to call file_name in the output and file_name is an .obj
+// file
+// imports file_name the old way and returns whether both a cold load and a
+// load from the .mesh cache it writes match it byte for byte
+bool CheckModel(const std::string &name, const std::string &file_name) {
+  ReferenceMesh expected;
+  if (!ReferenceImport(file_name, &expected)) {
+    std::cout << name << " could not be imported the old way" << std::endl;
+    return false;
+  }
+  remove(engine::MeshCachePath(file_name).c_str());
+  CheckedModel cold(file_name);
+  CheckedModel cached(file_name);
+  if (!SameMesh(expected, cold) || !SameMesh(expected, cached)) {
+    std::cout << name << " doesn't load the same as the old importer" <<
+    std::endl;
+    return false;
+  }
+  return true;
+}
+
+// file_name is where to write and size is how many quads are on each side
+// writes a flat grid of size by size quads split into two triangles each,
+// neighbouring triangles share corners so most face attributes repeat
+void WriteGrid(const std::string &file_name, int size) {
+  std::ofstream file(file_name);
+  for (int z = 0; z <= size; z++) {
+    for (int x = 0; x <= size; x++) {
+      file << "v " << x << " 0 " << z << "\n";
+      file << "vt " << x / static_cast<float>(size) << " " <<
+      z / static_cast<float>(size) << "\n";
+    }
+  }
+  file << "vn 0 1 0\n";
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      int corner = z * (size + 1) + x + 1;
+      int a = corner, b = corner + 1;
+      int c = corner + size + 1, d = corner + size + 2;
+      file << "f " << a << "/" << a << "/1 " << c << "/" << c << "/1 " <<
+      b << "/" << b << "/1\n";
+      file << "f " << b << "/" << b << "/1 " << c << "/" << c << "/1 " <<
+      d << "/" << d << "/1\n";
+    }
+  }
+}
+
+// from is a file, to is where to copy it, and copies is every file copied
+// so far
+// copies from to to once and adds to to copies
+void CopyFile(const std::string &from, const std::string &to,
+              std::vector<std::string>* copies) {
+  if (std::find(copies->begin(), copies->end(), to) != copies->end()) {
+    return;
+  }
+  std::ifstream in(from, std::ios::in | std::ios::binary);
+  std::ofstream out(to, std::ios::out | std::ios::binary);
+  out << in.rdbuf();
+  copies->push_back(to);
+}
+
+// file_name is an .obj or .mtl file and key is the statement that names the
+// files it uses
+// returns every file named after key, in data/ where the importer looks
+std::vector<std::string> NamedFiles(const std::string &file_name,
+                                    const std::string &key) {
+  std::vector<std::string> rv;
+  std::ifstream file(file_name);
+  std::string line;
+  while (getline(file, line)) {
+    std::vector<std::string> tokens = engine::Tokenize(line);
+    if (tokens.size() == 2 && tokens[0] == key) {
+      rv.push_back("data/" + tokens[1]);
+    }
+  }
+  return rv;
+}
+
+// file_name is an .obj file, dir is a directory with a data directory in
+// it, copies is every file copied so far, and textures is where to list the
+// model's images
+// copies file_name, its .mtl libraries, and their textures into dir/data so
+// the importer finds them there, returns the copy's path relative to dir
+std::string CopyModel(const std::string &file_name, const std::string &dir,
+                      std::vector<std::string>* copies,
+                      std::vector<std::string>* textures) {
+  size_t slash = file_name.find_last_of("/\\");
+  std::string copy = "data/" + file_name.substr(
+    slash == std::string::npos ? 0 : slash + 1);
+  CopyFile(file_name, dir + "/" + copy, copies);
+  for (const std::string &library : NamedFiles(file_name, "mtllib")) {
+    CopyFile(library, dir + "/" + library, copies);
+    for (const std::string &texture : NamedFiles(library, "map_Ka")) {
+      CopyFile(texture, dir + "/" + texture, copies);
+      textures->push_back(texture);
+    }
+  }
+  return copy;
+}
+
+// start is when something started
+// returns how many milliseconds have passed since start
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double, std::milli> time =
+    std::chrono::steady_clock::now() - start;
+  return time.count();
+}
+
+// file_name is an .obj file and textures are the images it uses
+// removes the .mesh and .tex files they were cooked to
+void RemoveCaches(const std::string &file_name,
+                  const std::vector<std::string> &textures) {
+  remove(engine::MeshCachePath(file_name).c_str());
+  for (int i = 0; i < textures.size(); i++) {
+    remove(engine::TextureCachePath(textures[i]).c_str());
+  }
+}
+
+// name is what to call file_name in the output, file_name is an .obj file,
+// and textures are the images it uses
+// prints how long file_name takes to import and cook with no .mesh or .tex
+// caches, to load again from the caches it wrote, and to hand out again from
+// a registry that already has it loaded
+void BenchModel(const std::string &name, const std::string &file_name,
+                const std::vector<std::string> &textures) {
+  RemoveCaches(file_name, textures);
+  double cold, cached, hits;
+  {
+    engine::AssetRegistry assets;
+    auto start = std::chrono::steady_clock::now();
+    engine::ModelHandle model = assets.GetModel(file_name);
+    cold = MillisecondsSince(start);
+  }
+  {
+    engine::AssetRegistry assets;
+    auto start = std::chrono::steady_clock::now();
+    engine::ModelHandle model = assets.GetModel(file_name);
+    cached = MillisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_HITS; i++) {
+      engine::ModelHandle again = assets.GetModel(file_name);
+    }
+    hits = MillisecondsSince(start);
+  }
+  std::cout << std::setw(24) << std::left << name << std::right <<
+  std::setw(12) << cold << std::setw(12) << cached <<
+  std::setw(12) << hits * 1e6 / BENCH_HITS << std::endl;
+}
+
+// copies every .obj file given as an argument, or the Turbo Tanks models,
+// into a temporary directory so their .mesh caches in data/ are left alone.
+// Checks each against the old importer and prints its cold import, cached
+// load, and registry hit times, then does the same for synthetic grids that
+// double in triangles each time up to about 200k, the grid times should grow
+// in step with the triangle count. Fails if any model doesn't load the same
+// as it did with the old importer, grids over BENCH_CHECK_TRIANGLES aren't
+// checked because the old importer takes minutes on them.
+int main(int argc, char** argv) {
+  // only the geometry is loaded, textures stay off the GPU
+  engine::SetHeadless(true);
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    files.push_back(argv[i]);
+  }
+  if (files.empty()) {
+    files = {"data/tank.obj", "data/enemytank.obj", "data/cannon.obj",
+             "data/piller.obj", "data/floor.obj", "data/energy_ball.obj",
+             "data/battery.obj", "data/heart.obj", "data/monkey.obj"};
+  }
+
+  char cwd[BENCH_PATH_SIZE];
+  const char* tmp = getenv("TMPDIR");
+  std::string dir = std::string(tmp ? tmp : "/tmp") + "/load_bench.XXXXXX";
+#ifdef _WIN32
+  bool made = getcwd(cwd, sizeof(cwd)) && _mktemp(&dir[0]) &&
+              _mkdir(dir.c_str()) == 0 && _mkdir((dir + "/data").c_str()) == 0;
+#else
+  bool made = getcwd(cwd, sizeof(cwd)) && mkdtemp(&dir[0]) &&
+              mkdir((dir + "/data").c_str(), 0700) == 0;
+#endif
+  if (!made) {
+    std::cout << "no temporary directory could be made" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::vector<std::string> copies;
+  std::vector<std::string> models;
+  std::vector<std::vector<std::string>> textures(files.size());
+  for (int i = 0; i < files.size(); i++) {
+    models.push_back(CopyModel(files[i], dir, &copies, &textures[i]));
+  }
+  if (chdir(dir.c_str()) != 0) {
+    std::cout << "could not move to " << dir << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << std::setw(24) << std::left << "model" << std::right <<
+  std::setw(12) << "cold ms" << std::setw(12) << "cached ms" <<
+  std::setw(12) << "hit ns" << std::endl;
+  bool same = true;
+  for (int i = 0; i < models.size(); i++) {
+    same = CheckModel(files[i], models[i]) && same;
+    BenchModel(files[i], models[i], textures[i]);
+    RemoveCaches(models[i], textures[i]);
+  }
+  for (int size = 40; size <= 320; size *= 2) {
+    std::string name = std::to_string(size * size * 2) + " triangle grid";
+    WriteGrid(BENCH_GRID_FILE, size);
+    if (size * size * 2 <= BENCH_CHECK_TRIANGLES) {
+      same = CheckModel(name, BENCH_GRID_FILE) && same;
+    }
+    BenchModel(name, BENCH_GRID_FILE, {});
+  }
+  remove(BENCH_GRID_FILE);
+  RemoveCaches(BENCH_GRID_FILE, {});
+
+  if (chdir(cwd) != 0) {
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < copies.size(); i++) {
+    remove(copies[i].c_str());
+  }
+  rmdir((dir + "/data").c_str());
+  rmdir(dir.c_str());
+  if (!same) {
+    exit(EXIT_FAILURE);
+  }
+  return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "engine/helper.h"
+#include "engine/obb.h"
+#include "engine/rigid_body.h"
+
+#define BENCH_BOXES 4096
+#define BENCH_NEIGHBOURS 64
+#define BENCH_MAP_SIZE 24
+#define BENCH_PAIRS (BENCH_BOXES * BENCH_NEIGHBOURS)
+
+// returns a random float from 0 to 1
+float RandomFraction() {
+  return rand() / static_cast<float>(RAND_MAX);
+}
+
+// a and b are game objects
+// returns whether their boxes overlap the way Intersects checked before it
+// used OBBs, projecting both boxes' corners onto each box's 3 face normals
+bool CornerIntersects(const engine::GameObject &a,
+                      const engine::GameObject &b) {
+  bool rv = true;
+  glm::vec3 * my_points = a.GetBoundingBoxPoints();
+  glm::vec3 * other_points = b.GetBoundingBoxPoints();
+  glm::vec3 axises[NUM_BOX_AXIS] = {
+    glm::normalize(my_points[0] - my_points[1]),
+    glm::normalize(my_points[0] - my_points[2]),
+    glm::normalize(my_points[0] - my_points[3]),
+    glm::normalize(other_points[0] - other_points[1]),
+    glm::normalize(other_points[0] - other_points[2]),
+    glm::normalize(other_points[0] - other_points[3])
+  };
+
+  for (int i = 0; i < NUM_BOX_AXIS && rv; i++) {
+    float my_min_max[2] = {0, 0};
+    float other_min_max[2] = {0, 0};
+
+    engine::GetMinMaxOnAxis(my_min_max, axises[i], my_points);
+    engine::GetMinMaxOnAxis(other_min_max, axises[i], other_points);
+
+    if ((my_min_max[0] > other_min_max[1] && my_min_max[0] > other_min_max[0])
+    || (my_min_max[1] < other_min_max[1] && my_min_max[1] < other_min_max[0])
+    ) {
+      rv = false;
+    }
+  }
+
+  delete[] my_points;
+  delete[] other_points;
+  return rv;
+}
+
+// start is when something started
+// returns how many nanoseconds have passed since start for each of
+// BENCH_PAIRS
+double NanosecondsPerPair(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double, std::nano> time =
+    std::chrono::steady_clock::now() - start;
+  return time.count() / BENCH_PAIRS;
+}
+
+// checks each of BENCH_BOXES boxes rotated about y against the next
+// BENCH_NEIGHBOURS boxes, and a segment from each box against the same
+// boxes, every way boxes can be tested, prints the time per pair and the
+// hits of each, and fails if the tests that should agree don't. The packet
+// test casts the segments of the BENCH_NEIGHBOURS boxes before each box at
+// it, which covers the same pairs.
+int main() {
+  srand(1);
+  std::vector<engine::RigidBody*> bodies;
+  std::vector<engine::OBB> boxes;
+  std::vector<glm::vec3> ends;
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    engine::RigidBody* body = new engine::RigidBody();
+    glm::vec3 size(0.5f + RandomFraction(), 0.5f + RandomFraction(),
+                   0.5f + RandomFraction());
+    body->SetBoundingBox(-size, size);
+    body->SetPosition(RandomFraction() * BENCH_MAP_SIZE, 0,
+                      RandomFraction() * BENCH_MAP_SIZE);
+    body->SetOrientation(RandomFraction() * 360, glm::vec3(0, 1, 0));
+    bodies.push_back(body);
+    boxes.push_back(body->GetOBB());
+  }
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    ends.push_back(bodies[i]->GetPosition() + glm::vec3(
+      RandomFraction() * 2 - 1, RandomFraction() * 0.5f,
+      RandomFraction() * 2 - 1) * static_cast<float>(BENCH_MAP_SIZE));
+  }
+  // others[i] holds the BENCH_NEIGHBOURS boxes after box i back to back
+  // so the batched tests read them like Collides reads its candidates
+  std::vector<engine::OBB> others(BENCH_PAIRS);
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      others[i * BENCH_NEIGHBOURS + j] = boxes[(i + j + 1) % BENCH_BOXES];
+    }
+  }
+
+  // Overlaps
+  std::vector<uint8_t> hits(BENCH_PAIRS);
+  int corner_hits = 0, intersects_hits = 0, scalar_hits = 0, batch_hits = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      corner_hits += CornerIntersects(*bodies[i],
+                                      *bodies[(i + j + 1) % BENCH_BOXES]);
+    }
+  }
+  double corner = NanosecondsPerPair(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      intersects_hits += bodies[i]->Intersects(
+        *bodies[(i + j + 1) % BENCH_BOXES]);
+    }
+  }
+  double intersects = NanosecondsPerPair(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      scalar_hits += engine::OverlapOBB(boxes[i],
+                                        others[i * BENCH_NEIGHBOURS + j]);
+    }
+  }
+  double scalar = NanosecondsPerPair(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    engine::OverlapOBBBatch(boxes[i], &others[i * BENCH_NEIGHBOURS],
+                            BENCH_NEIGHBOURS, &hits[i * BENCH_NEIGHBOURS]);
+  }
+  double batch = NanosecondsPerPair(start);
+  for (int i = 0; i < BENCH_PAIRS; i++) {
+    batch_hits += hits[i];
+  }
+
+  // Ray casts
+  std::vector<float> distances(BENCH_PAIRS);
+  int object_casts = 0, scalar_casts = 0, batch_casts = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    glm::vec3 position = bodies[i]->GetPosition();
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      distances[i * BENCH_NEIGHBOURS + j] =
+        bodies[(i + j + 1) % BENCH_BOXES]->RayCast(position, ends[i]);
+    }
+  }
+  double object_cast = NanosecondsPerPair(start);
+  for (int i = 0; i < BENCH_PAIRS; i++) {
+    object_casts += distances[i] != -1;
+  }
+
+  bool casts_match = true;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    glm::vec3 position = bodies[i]->GetPosition();
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      float distance = engine::RayCastOBB(others[i * BENCH_NEIGHBOURS + j],
+                                          position, ends[i]);
+      scalar_casts += distance != -1;
+      casts_match &= distance == distances[i * BENCH_NEIGHBOURS + j];
+    }
+  }
+  double scalar_cast = NanosecondsPerPair(start);
+
+  std::vector<float> batch_distances(BENCH_PAIRS);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BENCH_BOXES; i++) {
+    engine::RayCastOBBBatch(bodies[i]->GetPosition(), ends[i],
+                            &others[i * BENCH_NEIGHBOURS], BENCH_NEIGHBOURS,
+                            &batch_distances[i * BENCH_NEIGHBOURS]);
+  }
+  double batch_cast = NanosecondsPerPair(start);
+  for (int i = 0; i < BENCH_PAIRS; i++) {
+    batch_casts += batch_distances[i] != -1;
+    casts_match &= batch_distances[i] == distances[i];
+  }
+
+  // starts[k] and ends[k] hold the segments from the BENCH_NEIGHBOURS boxes
+  // before box k back to back, the same pairs turned around so the packet
+  // test casts many segments at one box
+  std::vector<glm::vec3> starts(BENCH_PAIRS), packet_ends(BENCH_PAIRS);
+  for (int k = 0; k < BENCH_BOXES; k++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      int i = (k - j - 1 + BENCH_BOXES) % BENCH_BOXES;
+      starts[k * BENCH_NEIGHBOURS + j] = bodies[i]->GetPosition();
+      packet_ends[k * BENCH_NEIGHBOURS + j] = ends[i];
+    }
+  }
+  std::vector<float> packet_distances(BENCH_PAIRS);
+  int packet_casts = 0;
+  start = std::chrono::steady_clock::now();
+  for (int k = 0; k < BENCH_BOXES; k++) {
+    engine::RayCastOBBPacket(boxes[k], &starts[k * BENCH_NEIGHBOURS],
+                             &packet_ends[k * BENCH_NEIGHBOURS],
+                             BENCH_NEIGHBOURS,
+                             &packet_distances[k * BENCH_NEIGHBOURS]);
+  }
+  double packet_cast = NanosecondsPerPair(start);
+  for (int k = 0; k < BENCH_BOXES; k++) {
+    for (int j = 0; j < BENCH_NEIGHBOURS; j++) {
+      int i = (k - j - 1 + BENCH_BOXES) % BENCH_BOXES;
+      float distance = packet_distances[k * BENCH_NEIGHBOURS + j];
+      packet_casts += distance != -1;
+      casts_match &= distance == distances[i * BENCH_NEIGHBOURS + j];
+    }
+  }
+
+  std::cout << BENCH_PAIRS << " pairs of " << BENCH_BOXES << " boxes" <<
+  std::endl;
+  std::cout << "corners on 6 axes: " << corner << " ns per pair, " <<
+  corner_hits << " hits" << std::endl;
+  std::cout << "Intersects: " << intersects << " ns per pair, " <<
+  intersects_hits << " hits" << std::endl;
+  std::cout << "OverlapOBB: " << scalar << " ns per pair, " << scalar_hits <<
+  " hits" << std::endl;
+  std::cout << "OverlapOBBBatch: " << batch << " ns per pair, " <<
+  batch_hits << " hits" << std::endl;
+  std::cout << "RayCast: " << object_cast << " ns per pair, " <<
+  object_casts << " hits" << std::endl;
+  std::cout << "RayCastOBB: " << scalar_cast << " ns per pair, " <<
+  scalar_casts << " hits" << std::endl;
+  std::cout << "RayCastOBBBatch: " << batch_cast << " ns per pair, " <<
+  batch_casts << " hits" << std::endl;
+  std::cout << "RayCastOBBPacket: " << packet_cast << " ns per pair, " <<
+  packet_casts << " hits" << std::endl;
+
+  // the corner test skips the 9 edge axes so it can only find more hits
+  if (intersects_hits != scalar_hits || batch_hits != scalar_hits ||
+      corner_hits < scalar_hits) {
+    std::cout << "the overlap tests don't agree" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (!casts_match) {
+    std::cout << "the ray casts don't agree" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "engine/project.h"
+#include "engine/camera.h"
+#include "turbo_tanks/player.h"
+#include "turbo_tanks/energy_pickup.h"
+#include "turbo_tanks/enemy.h"
+#include "turbo_tanks/enemy_cannon.h"
+
+#define TEST_ENEMIES 2000
+#define TEST_PICKUPS 200
+#define TEST_MAP_SIZE 100
+#define TEST_STEPS 300
+#define TEST_DELTA (1.0f / 60.0f)
+#define TEST_MEDDLERS 1000
+
+// Watcher reads the pose of every game object in watched from its update and
+// counts the reads that don't match the pose the test saved before the step,
+// which is what the start of step snapshot has to hold for each of them
+class Watcher : public engine::RigidBody {
+ public:
+  std::vector<engine::GameObject*> watched;
+  std::vector<glm::vec3> positions;
+  std::vector<glm::quat> orientations;
+  int mismatches;
+
+  Watcher() {
+    mismatches = 0;
+  }
+
+  // saves the pose of everything in watched, call it before each step
+  void SavePoses() {
+    positions.clear();
+    orientations.clear();
+    for (int i = 0; i < watched.size(); i++) {
+      positions.push_back(watched[i]->GetPosition());
+      orientations.push_back(watched[i]->GetOrientation());
+    }
+  }
+
+  void Update(float delta) {
+    for (int i = 0; i < watched.size(); i++) {
+      if (watched[i]->GetPosition() != positions[i] ||
+          watched[i]->GetOrientation() != orientations[i]) {
+        mismatches++;
+      }
+    }
+    RigidBody::Update(delta);
+  }
+};
+
+// threads is how many threads to update on and mismatches is where to put
+// how many of the watcher's reads didn't see the start of step snapshot
+// builds a map of Turbo Tanks enemies that drive into each other and shoot
+// at a player circling the middle, steps it, and returns the hash of the
+// world after every step
+std::vector<uint64_t> Run(int threads, int* mismatches) {
+  srand(1);
+  engine::Project* project = new engine::Project("parallel_update_test");
+  project->Initialize(true);
+  project->render_distance = TEST_MAP_SIZE * 2;
+  project->collision_radius = 3;
+  project->SetWorkerThreads(threads);
+  // the render box follows the active camera, it looks down on the middle
+  // of the map so everything is in it from the first step
+  engine::Camera* camera = new engine::Camera(90, 0.1, TEST_MAP_SIZE * 2);
+  camera->SetPosition(TEST_MAP_SIZE / 2, TEST_MAP_SIZE / 2, TEST_MAP_SIZE / 2);
+  project->AddCamera(camera);
+  project->ActivateCamera(camera->id);
+  engine::ModelHandle tank = project->assets.GetModel("data/tank.obj");
+  engine::ModelHandle enemy_tank =
+    project->assets.GetModel("data/enemytank.obj");
+  engine::ModelHandle cannon = project->assets.GetModel("data/cannon.obj");
+  engine::ModelHandle ball = project->assets.GetModel("data/energy_ball.obj");
+  engine::ModelHandle battery = project->assets.GetModel("data/battery.obj");
+  int enemy_balls = turbotanks::AddEnergyBallType(project, "enemyenergyball",
+    ball, {"enemy", "enemycannon"});
+
+  turbotanks::Player* player = new turbotanks::Player(tank);
+  project->AddRigidBody(player);
+  Watcher* watcher = new Watcher();
+  watcher->watched.push_back(player);
+  for (int i = 0; i < TEST_ENEMIES; i++) {
+    turbotanks::Enemy* enemy = new turbotanks::Enemy(enemy_tank);
+    turbotanks::EnemyCannon* enemy_cannon =
+      new turbotanks::EnemyCannon(cannon, enemy_balls);
+    enemy->player = player;
+    enemy->cannon = enemy_cannon;
+    enemy_cannon->player = player;
+    enemy_cannon->enemy = enemy;
+    enemy->SetPosition(rand() % TEST_MAP_SIZE, 0.7, rand() % TEST_MAP_SIZE);
+    enemy->SetOrientation(rand() % 360, glm::vec3(0, 1, 0));
+    project->AddRigidBody(enemy);
+    project->AddRigidBody(enemy_cannon);
+    enemy_cannon->SetParent(enemy);
+    enemy_cannon->SetLocalPosition(glm::vec3(0, 0, 0));
+    watcher->watched.push_back(enemy);
+    watcher->watched.push_back(enemy_cannon);
+  }
+  project->AddRigidBody(watcher);
+  // pickups sit on the player's path so they get collected along the way
+  for (int i = 0; i < TEST_PICKUPS; i++) {
+    turbotanks::EnergyPickup* pickup = new turbotanks::EnergyPickup(battery);
+    float angle = i * 360.0f / TEST_PICKUPS;
+    pickup->SetPosition(glm::vec3(TEST_MAP_SIZE / 2, 0, TEST_MAP_SIZE / 2) +
+      engine::AxisToQuat(angle, glm::vec3(0, 1, 0), false) *
+      glm::vec3(0, 0, TEST_MAP_SIZE / 4));
+    pickup->player = player;
+    project->AddRigidBody(pickup);
+  }
+
+  std::vector<uint64_t> hashes;
+  for (int step = 0; step < TEST_STEPS; step++) {
+    // without a window the player has no input so it is moved from here
+    float angle = step * 360.0f / TEST_STEPS;
+    player->SetPosition(glm::vec3(TEST_MAP_SIZE / 2, 0.7, TEST_MAP_SIZE / 2) +
+      engine::AxisToQuat(angle, glm::vec3(0, 1, 0), false) *
+      glm::vec3(0, 0, TEST_MAP_SIZE / 4));
+    watcher->SavePoses();
+    project->Step(TEST_DELTA);
+    hashes.push_back(project->HashWorld());
+  }
+  *mismatches = watcher->mismatches;
+  delete project;
+  return hashes;
+}
+
+// Meddler counts its updates through Defer and, when meddle is set, moves
+// target, which isn't its to move, so its update throws
+class Meddler : public engine::RigidBody {
+ public:
+  engine::RigidBody* target;
+  bool meddle;
+  int* updates;
+
+  explicit Meddler(engine::ModelHandle model) : engine::RigidBody(model) {
+    target = nullptr;
+    meddle = false;
+    updates = nullptr;
+  }
+
+  void Update(float delta) {
+    project->Defer([this] {(*updates)++;});
+    if (meddle) {
+      target->SetPosition(0, 0, 0);
+    }
+    RigidBody::Update(delta);
+  }
+};
+
+// Spawner adds spawn through Defer the first time it is updated
+class Spawner : public engine::RigidBody {
+ public:
+  Meddler* spawn;
+
+  explicit Spawner(engine::ModelHandle model) : engine::RigidBody(model) {
+    spawn = nullptr;
+  }
+
+  void Update(float delta) {
+    if (spawn) {
+      Meddler* added = spawn;
+      project->Defer([this, added] {project->AddRigidBody(added);});
+      spawn = nullptr;
+    }
+    RigidBody::Update(delta);
+  }
+};
+
+// threads is how many threads to update on
+// returns whether a rigidbody added from an update waits until the next
+// step for its first update, like any other it is then updated in a wave
+bool SpawnsWaitAStep(int threads) {
+  engine::Project* project = new engine::Project("parallel_update_test");
+  project->Initialize(true);
+  project->SetWorkerThreads(threads);
+  engine::ModelHandle cube = project->assets.GetModel("data/cube.obj");
+  int updates = 0;
+  Spawner* spawner = new Spawner(cube);
+  spawner->spawn = new Meddler(cube);
+  spawner->spawn->updates = &updates;
+  project->AddRigidBody(spawner);
+  project->Step(TEST_DELTA);
+  bool waited = updates == 0;
+  project->Step(TEST_DELTA);
+  waited = waited && updates == 1;
+  delete project;
+  return waited;
+}
+
+// threads is how many threads to update on
+// returns whether a step with one throwing update passes the exception on,
+// leaves the calling thread out of update mode, and throws away what the
+// wave deferred so the next step only runs its own
+bool ThrowingUpdateRecovers(int threads) {
+  engine::Project* project = new engine::Project("parallel_update_test");
+  project->Initialize(true);
+  project->SetWorkerThreads(threads);
+  engine::ModelHandle cube = project->assets.GetModel("data/cube.obj");
+  int updates = 0;
+  std::vector<Meddler*> meddlers;
+  for (int i = 0; i < TEST_MEDDLERS; i++) {
+    Meddler* meddler = new Meddler(cube);
+    meddler->updates = &updates;
+    project->AddRigidBody(meddler);
+    meddlers.push_back(meddler);
+  }
+  meddlers[TEST_MEDDLERS / 2]->target = meddlers[0];
+  meddlers[TEST_MEDDLERS / 2]->meddle = true;
+  bool threw = false;
+  try {
+    project->Step(TEST_DELTA);
+  } catch (const std::string msg) {
+    threw = true;
+  }
+  bool recovered = threw && updates == 0 &&
+                   engine::RecordingCommands() == nullptr &&
+                   engine::UpdatingTransform() == TRANSFORM_STORE_NULL;
+  meddlers[TEST_MEDDLERS / 2]->meddle = false;
+  project->Step(TEST_DELTA);
+  recovered = recovered && updates == TEST_MEDDLERS;
+  delete project;
+  return recovered;
+}
+
+// threads is how many threads a run updated on and mismatches is how many
+// of its watcher's reads didn't see the start of step snapshot
+// fails the test if there were any
+void CheckSnapshot(int threads, int mismatches) {
+  if (mismatches > 0) {
+    std::cout << threads << " threads: " << mismatches << " reads from " <<
+    "an update didn't see the pose saved at the start of the step" <<
+    std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// steps the same world serially and with 2 threads and then twice as many
+// up to one per core, or up to the first argument, and fails if any step of
+// any run doesn't match the serial one or any update read another object
+// anywhere but the start of step snapshot, then checks that a throwing update
+// is recovered from and that spawns wait a step on each of those thread
+// counts
+int main(int argc, char** argv) {
+  int max_threads = argc > 1 ? atoi(argv[1]) :
+                    static_cast<int>(std::thread::hardware_concurrency());
+  int mismatches;
+  std::vector<uint64_t> serial = Run(1, &mismatches);
+  CheckSnapshot(1, mismatches);
+  for (int threads = 2; threads <= std::max(2, max_threads); threads *= 2) {
+    std::vector<uint64_t> parallel = Run(threads, &mismatches);
+    CheckSnapshot(threads, mismatches);
+    for (int step = 0; step < TEST_STEPS; step++) {
+      if (parallel[step] != serial[step]) {
+        std::cout << threads << " threads: step " << step <<
+        " doesn't match the serial run" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    std::cout << threads << " threads: all " << TEST_STEPS <<
+    " steps match the serial run" << std::endl;
+  }
+  for (int threads = 1; threads <= std::max(2, max_threads); threads *= 2) {
+    if (!ThrowingUpdateRecovers(threads)) {
+      std::cout << threads << " threads: a throwing update wasn't recovered" <<
+      " from" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::cout << threads << " threads: a throwing update is passed on and " <<
+    "recovered from" << std::endl;
+    if (!SpawnsWaitAStep(threads)) {
+      std::cout << threads << " threads: a spawned rigidbody was updated " <<
+      "the step it was added" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    std::cout << threads << " threads: spawned rigidbodies are first " <<
+    "updated next step" << std::endl;
+  }
+  exit(EXIT_SUCCESS);
+}
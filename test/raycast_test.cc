@@ -0,0 +1,156 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "engine/helper.h"
+#include "engine/obb.h"
+#include "engine/rigid_body.h"
+
+#define TEST_BOXES 500
+#define TEST_RAYS 7
+#define TEST_EPSILON 1e-3f
+#define TEST_FACE_SLACK 1e-5f
+
+// returns a random float from 0 to 1
+float RandomFraction() {
+  return rand() / static_cast<float>(RAND_MAX);
+}
+
+// returns a random unit vector
+glm::vec3 RandomDirection() {
+  glm::vec3 rv(0, 0, 0);
+  while (glm::length(rv) < 0.1f || glm::length(rv) > 1) {
+    rv = glm::vec3(RandomFraction(), RandomFraction(), RandomFraction()) *
+         2.0f - 1.0f;
+  }
+  return glm::normalize(rv);
+}
+
+// body is a game object and start and end define a line segment
+// returns the distance to the first of the body's faces the segment crosses
+// the way GameObject::RayCast found it before the slab test, calling
+// GetCollisionOnLine on each face, or -1
+float FaceRayCast(const engine::GameObject &body, glm::vec3 start,
+                  glm::vec3 end) {
+  float rv = -1;
+  glm::vec3* points = body.GetBoundingBoxPoints();
+  int faces[6][4] = {
+    {0, 1, 3, 6},
+    {0, 3, 5, 2},
+    {2, 5, 4, 7},
+    {1, 6, 4, 7},
+    {0, 2, 1, 7},
+    {3, 5, 4, 6}
+  };
+  for (int i = 0; i < 6; i++) {
+    float temp = engine::GetCollisionOnLine(start, end, faces[i], points);
+    if (temp != -1 && (rv == -1 || temp < rv)) {
+      rv = temp;
+    }
+  }
+  delete[] points;
+  return rv;
+}
+
+// box is a box and start and end define a line segment
+// returns the distance to the first face of box the segment crosses at least
+// RAYCAST_MIN_DISTANCE along it, or -1, intersecting the segment with each
+// face's plane and checking the point is on the face. It is the test
+// GetCollisionOnLine meant to do, used to tell which side is wrong when it
+// and the slab test disagree.
+float PlaneRayCast(const engine::OBB &box, glm::vec3 start, glm::vec3 end) {
+  float rv = -1;
+  float length = glm::length(end - start);
+  glm::vec3 direction = (end - start) / length;
+  for (int i = 0; i < 3; i++) {
+    float d = glm::dot(direction, box.axes[i]);
+    for (int side = -1; side <= 1 && d != 0; side += 2) {
+      glm::vec3 face = box.center +
+                       box.axes[i] * (box.half_extents[i] * side);
+      float t = glm::dot(face - start, box.axes[i]) / d;
+      glm::vec3 offset = start + direction * t - box.center;
+      bool on_face = t >= RAYCAST_MIN_DISTANCE && t <= length;
+      for (int j = 0; j < 3 && on_face; j++) {
+        on_face = j == i || std::fabs(glm::dot(offset, box.axes[j])) <=
+                  box.half_extents[j] * (1 + TEST_FACE_SLACK);
+      }
+      if (on_face && (rv == -1 || t < rv)) {
+        rv = t;
+      }
+    }
+  }
+  return rv;
+}
+
+// a and b are ray cast distances
+// returns whether both missed or both hit within TEST_EPSILON of each other
+bool Agree(float a, float b) {
+  return (a == -1) == (b == -1) && std::fabs(a - b) <= TEST_EPSILON;
+}
+
+// casts TEST_RAYS random segments at each of TEST_BOXES randomly sized and
+// rotated boxes, some starting inside the box, and fails unless
+// GameObject::RayCast agrees with the face test it replaced, with
+// RayCastOBB and RayCastOBBPacket returning the same distances. The old
+// face test's quadrant check isn't a real point-in-quad test, so where it
+// disagrees with a plain plane and face test the slab test is held to that
+// instead and the old test's misses are counted.
+int main() {
+  srand(1);
+  int hits = 0, face_wrong = 0, failures = 0;
+  for (int i = 0; i < TEST_BOXES; i++) {
+    engine::RigidBody body;
+    glm::vec3 size(0.2f + RandomFraction() * 2, 0.2f + RandomFraction() * 2,
+                   0.2f + RandomFraction() * 2);
+    body.SetBoundingBox(-size, size);
+    body.SetPosition(glm::vec3(RandomFraction(), RandomFraction(),
+                               RandomFraction()) * 20.0f - 10.0f);
+    body.SetOrientation(RandomFraction() * 360, RandomDirection());
+    engine::OBB box = body.GetOBB();
+
+    std::vector<glm::vec3> starts, ends;
+    std::vector<float> slabs(TEST_RAYS), packet(TEST_RAYS);
+    for (int j = 0; j < TEST_RAYS; j++) {
+      // starts are spread from inside the box to a few box lengths away
+      glm::vec3 start = body.GetPosition() + RandomDirection() *
+                        (RandomFraction() * 4 * glm::length(size));
+      starts.push_back(start);
+      ends.push_back(start + RandomDirection() * (0.5f + RandomFraction() * 12));
+      slabs[j] = body.RayCast(starts[j], ends[j]);
+    }
+    engine::RayCastOBBPacket(box, starts.data(), ends.data(), TEST_RAYS,
+                             packet.data());
+
+    for (int j = 0; j < TEST_RAYS; j++) {
+      float old = FaceRayCast(body, starts[j], ends[j]);
+      float plane = PlaneRayCast(box, starts[j], ends[j]);
+      float scalar = engine::RayCastOBB(box, starts[j], ends[j]);
+      hits += slabs[j] != -1;
+      face_wrong += !Agree(old, plane);
+      if (!Agree(old, plane) ? !Agree(slabs[j], plane) :
+          !Agree(slabs[j], old)) {
+        std::cout << "box " << i << " ray " << j << ": RayCast " <<
+        slabs[j] << ", face test " << old << ", planes " << plane <<
+        std::endl;
+        failures++;
+      }
+      if (scalar != slabs[j] || packet[j] != scalar) {
+        std::cout << "box " << i << " ray " << j << ": RayCastOBB " <<
+        scalar << ", RayCastOBBPacket " << packet[j] << std::endl;
+        failures++;
+      }
+    }
+  }
+  std::cout << TEST_BOXES * TEST_RAYS << " segments, " << hits << " hits, " <<
+  "the old face test was wrong on " << face_wrong << std::endl;
+  if (failures > 0) {
+    std::cout << failures << " ray casts don't agree" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <GLFW/glfw3.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "engine/project.h"
+#include "turbo_tanks/player.h"
+#include "turbo_tanks/player_camera.h"
+#include "turbo_tanks/player_cannon.h"
+#include "turbo_tanks/energy_pickup.h"
+#include "turbo_tanks/enemy.h"
+#include "turbo_tanks/enemy_cannon.h"
+
+#define TEST_ENEMIES 200
+#define TEST_PICKUPS 50
+#define TEST_MAP_SIZE 60
+#define TEST_STEPS 600
+#define TEST_LOG "replay_test.log"
+#define TEST_RECORDED_HASHES "replay_test_recorded.hash"
+#define TEST_REPLAYED_HASHES "replay_test_replayed.hash"
+
+// project is a headless project
+// builds a map of Turbo Tanks enemies and pickups around a player driven by
+// the move, aim, and machinegun inputs, the player's camera only turns on
+// after the first step so step 0 runs with the render box where the project
+// starts it
+void BuildWorld(engine::Project* project) {
+  srand(1);
+  project->collision_radius = 3;
+  project->vector_inputs = {
+    {"move", {{ENGINE_KEYBOARD, {GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_S,
+                                 GLFW_KEY_W}}}},
+    {"aim", {{ENGINE_CURSOR, {ENGINE_CURSOR_X, ENGINE_CURSOR_Y}}}}
+  };
+  project->button_inputs = {
+    {"machinegun", {{ENGINE_MOUSE, GLFW_MOUSE_BUTTON_LEFT}}}
+  };
+  engine::ModelHandle tank = project->assets.GetModel("data/tank.obj");
+  engine::ModelHandle enemy_tank =
+    project->assets.GetModel("data/enemytank.obj");
+  engine::ModelHandle cannon = project->assets.GetModel("data/cannon.obj");
+  engine::ModelHandle ball = project->assets.GetModel("data/energy_ball.obj");
+  engine::ModelHandle battery = project->assets.GetModel("data/battery.obj");
+  int player_balls = turbotanks::AddEnergyBallType(project,
+    "playerenergyball", ball, {"player", "playercannon"});
+  int enemy_balls = turbotanks::AddEnergyBallType(project, "enemyenergyball",
+    ball, {"enemy", "enemycannon"});
+
+  turbotanks::Player* player = new turbotanks::Player(tank);
+  turbotanks::PlayerCannon* player_cannon =
+    new turbotanks::PlayerCannon(cannon, player_balls);
+  turbotanks::PlayerCamera* camera = new turbotanks::PlayerCamera(45, 1, 100);
+  engine::Camera* dev_cam = new engine::Camera(45, 0.1f, 100);
+  player_cannon->player = player;
+  player_cannon->camera = camera;
+  camera->player = player;
+  camera->dev_cam = dev_cam;
+  project->AddRigidBody(player);
+  project->AddRigidBody(player_cannon);
+  project->AddCamera(camera);
+  project->AddCamera(dev_cam);
+  camera->SetParent(player);
+  player_cannon->SetParent(player);
+  player_cannon->SetLocalPosition(glm::vec3(0, 0, 0));
+  player->SetPosition(TEST_MAP_SIZE / 2, 0.7, TEST_MAP_SIZE / 2);
+  for (int i = 0; i < TEST_ENEMIES; i++) {
+    turbotanks::Enemy* enemy = new turbotanks::Enemy(enemy_tank);
+    turbotanks::EnemyCannon* enemy_cannon =
+      new turbotanks::EnemyCannon(cannon, enemy_balls);
+    enemy->player = player;
+    enemy->cannon = enemy_cannon;
+    enemy_cannon->player = player;
+    enemy_cannon->enemy = enemy;
+    enemy->SetPosition(rand() % TEST_MAP_SIZE, 0.7, rand() % TEST_MAP_SIZE);
+    enemy->SetOrientation(rand() % 360, glm::vec3(0, 1, 0));
+    project->AddRigidBody(enemy);
+    project->AddRigidBody(enemy_cannon);
+    enemy_cannon->SetParent(enemy);
+    enemy_cannon->SetLocalPosition(glm::vec3(0, 0, 0));
+  }
+  for (int i = 0; i < TEST_PICKUPS; i++) {
+    turbotanks::EnergyPickup* pickup = new turbotanks::EnergyPickup(battery);
+    pickup->SetPosition(rand() % TEST_MAP_SIZE, 0, rand() % TEST_MAP_SIZE);
+    pickup->player = player;
+    project->AddRigidBody(pickup);
+  }
+}
+
+// step is how many steps have run and input is the input snapshot
+// drives forward while turning and shooting in bursts
+void BotInput(int step, engine::InputState* input) {
+  input->keys[GLFW_KEY_W] = 1;
+  input->keys[GLFW_KEY_A] = (step / 120) % 2;
+  input->cursor_offset.x = (step / 45) % 2 ? 3 : -3;
+  input->mouse_buttons[GLFW_MOUSE_BUTTON_LEFT] = (step / 20) % 3 == 0;
+}
+
+// returns the lines of filename
+std::vector<std::string> ReadLines(const std::string &filename) {
+  std::vector<std::string> lines;
+  std::ifstream file(filename);
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// records a bot playing TEST_STEPS steps and the world's hash after each
+// one, replays the recording in a new process with the heap filled with
+// different garbage, and fails unless every step, starting with step 0,
+// hashes the same, with --replay it is the new process
+int main(int argc, char** argv) {
+  bool replay = argc > 1 && strcmp(argv[1], "--replay") == 0;
+  engine::Project* project = new engine::Project("replay_test");
+  project->Initialize(true);
+  BuildWorld(project);
+  if (replay) {
+    project->ReplayInput(TEST_LOG);
+    project->WriteHashes(TEST_REPLAYED_HASHES);
+  } else {
+    project->RecordInput(TEST_LOG);
+    project->WriteHashes(TEST_RECORDED_HASHES);
+    project->SetInputScript([project](int step, engine::InputState* input) {
+      BotInput(step, input);
+      if (step + 1 >= TEST_STEPS) {
+        project->Quit();
+      }
+    });
+  }
+  project->GameLoop();
+  delete project;
+  if (replay) {
+    exit(EXIT_SUCCESS);
+  }
+
+  // anything the simulation reads without setting first comes out
+  // different in the replay
+  std::string command = std::string("MALLOC_PERTURB_=165 ") + argv[0] +
+                        " --replay";
+  if (system(command.c_str()) != 0) {
+    std::cout << "the replay didn't run" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::vector<std::string> recorded = ReadLines(TEST_RECORDED_HASHES);
+  std::vector<std::string> replayed = ReadLines(TEST_REPLAYED_HASHES);
+  remove(TEST_LOG);
+  remove(TEST_RECORDED_HASHES);
+  remove(TEST_REPLAYED_HASHES);
+  if (recorded.size() != TEST_STEPS || replayed.size() != TEST_STEPS) {
+    std::cout << "recorded " << recorded.size() << " steps and replayed " <<
+    replayed.size() << " of " << TEST_STEPS << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  for (int step = 0; step < TEST_STEPS; step++) {
+    if (recorded[step] != replayed[step]) {
+      std::cout << "step " << step << " of the replay doesn't match the " <<
+      "recording" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  std::cout << "all " << TEST_STEPS << " replayed steps match the recording" <<
+  std::endl;
+  exit(EXIT_SUCCESS);
+}
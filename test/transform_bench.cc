@@ -0,0 +1,184 @@
+/*
+ * Copyright 2020 Maui Kelley
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "engine/game_object.h"
+#include "engine/transform_store.h"
+
+#define BENCH_OBJECTS 100000
+#define BENCH_FRAMES 100
+#define BENCH_DELTA (1.0f / 60.0f)
+
+// Prop is the smallest game object that can be made
+class Prop : public engine::GameObject {
+ public:
+  void Update(float delta) {}
+};
+
+// LegacyProp is a game object laid out the way GameObject was before the
+// transform store, every member inside the object and each object allocated
+// on its own
+class LegacyProp {
+ protected:
+  glm::vec3 position;
+  glm::vec3 scale;
+  glm::quat orientation;
+
+  // Bounding Box
+  glm::vec3 bounding_box_min, bounding_box_max;
+
+ public:
+  engine::Project* project;
+  int id;
+  engine::SceneListBase* scene_list;
+  int scene_index;
+  engine::TagList tags;
+  bool bounding_box_axis_aligned;
+
+  // Default Constructor
+  LegacyProp() : position(0, 0, 0), scale(1, 1, 1),
+                 orientation(glm::angleAxis(0.0f, glm::vec3(0, 0, -1))),
+                 bounding_box_min(0, 0, 0), bounding_box_max(0, 0, 0),
+                 project(nullptr), id(-1), scene_list(nullptr),
+                 scene_index(-1), bounding_box_axis_aligned(false) {}
+
+  // Deconstructor
+  virtual ~LegacyProp() {}
+
+  // getters and setters like GameObject had
+  void SetPosition(glm::vec3 position) {this->position = position;}
+  void SetOrientation(glm::quat orientation) {
+    this->orientation = orientation;
+  }
+  void SetBoundingBox(glm::vec3 minimum, glm::vec3 maximum) {
+    bounding_box_min = minimum;
+    bounding_box_max = maximum;
+  }
+  glm::vec3 GetPosition() {return position;}
+
+  // returns the smallest world space axis aligned box around the bounding
+  // box, the way GameObject worked it out before the transform store
+  engine::AABB GetWorldBounds() const {
+    glm::vec3 center = (bounding_box_min + bounding_box_max) * 0.5f;
+    glm::vec3 extent = (bounding_box_max - bounding_box_min) * 0.5f;
+    if (!bounding_box_axis_aligned) {
+      glm::mat3 rot = glm::toMat3(orientation);
+      glm::mat3 abs_rot;
+      for (int i = 0; i < 3; i++) {
+        abs_rot[i] = glm::abs(rot[i]);
+      }
+      center = rot * center;
+      extent = abs_rot * extent;
+    }
+    center += position;
+    return engine::AABB(center - extent, center + extent);
+  }
+
+  // Virtual Function Update
+  virtual void Update(float delta) {}
+};
+
+// returns a random float from -1 to 1
+float RandomUnit() {
+  return (rand() / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f;
+}
+
+// moves BENCH_OBJECTS transforms and rebuilds their world bounds every frame,
+// first one object at a time with each transform inside its object like
+// before the transform store, then one object at a time through the
+// GameObject accessors, and then in bulk over the arrays of the transform
+// store
+int main() {
+  srand(1);
+  std::vector<LegacyProp*> legacy_props;
+  std::vector<Prop*> props;
+  std::vector<glm::vec3> velocities;
+  for (int i = 0; i < BENCH_OBJECTS; i++) {
+    Prop* prop = new Prop();
+    prop->SetPosition(RandomUnit() * 100, 0, RandomUnit() * 100);
+    prop->SetOrientation(RandomUnit() * 180, glm::vec3(0, 1, 0));
+    prop->SetBoundingBox(glm::vec3(-1, 0, -1), glm::vec3(1, 2, 1));
+    props.push_back(prop);
+    LegacyProp* legacy_prop = new LegacyProp();
+    legacy_prop->SetPosition(prop->GetPosition());
+    legacy_prop->SetOrientation(prop->GetOrientation());
+    legacy_prop->SetBoundingBox(glm::vec3(-1, 0, -1), glm::vec3(1, 2, 1));
+    legacy_props.push_back(legacy_prop);
+    velocities.push_back(glm::vec3(RandomUnit(), 0, RandomUnit()));
+  }
+  std::vector<engine::AABB> bounds(BENCH_OBJECTS);
+
+  // One object at a time with the old layout
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+    for (int i = 0; i < BENCH_OBJECTS; i++) {
+      legacy_props[i]->SetPosition(legacy_props[i]->GetPosition() +
+                                   velocities[i] * BENCH_DELTA);
+      bounds[i] = legacy_props[i]->GetWorldBounds();
+    }
+  }
+  std::chrono::duration<double, std::milli> old_layout =
+    std::chrono::steady_clock::now() - start;
+
+  // One object at a time through the store
+  start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+    for (int i = 0; i < BENCH_OBJECTS; i++) {
+      props[i]->SetPosition(props[i]->GetPosition() +
+                            velocities[i] * BENCH_DELTA);
+      bounds[i] = props[i]->GetWorldBounds();
+    }
+  }
+  std::chrono::duration<double, std::milli> per_object =
+    std::chrono::steady_clock::now() - start;
+
+  // In bulk, velocities are put in row order first like a movement
+  // component would keep them and every moved row is marked dirty
+  engine::TransformStore &transforms = engine::Transforms();
+  int count = transforms.Size();
+  std::vector<float> velocity[3];
+  for (int axis = 0; axis < 3; axis++) {
+    velocity[axis].resize(count, 0.0f);
+  }
+  for (int i = 0; i < BENCH_OBJECTS; i++) {
+    int row = transforms.GetRow(props[i]->GetTransform());
+    for (int axis = 0; axis < 3; axis++) {
+      velocity[axis][row] = velocities[i][axis];
+    }
+  }
+  start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+    for (int axis = 0; axis < 3; axis++) {
+      float* position = transforms.GetPositions(axis);
+      const float* speed = velocity[axis].data();
+      for (int row = 0; row < count; row++) {
+        position[row] += speed[row] * BENCH_DELTA;
+      }
+    }
+    for (int row = 0; row < count; row++) {
+      transforms.SetDirty(transforms.GetHandle(row));
+    }
+    transforms.GetWorldBounds(bounds.data());
+  }
+  std::chrono::duration<double, std::milli> bulk =
+    std::chrono::steady_clock::now() - start;
+
+  std::cout << BENCH_OBJECTS << " transforms" << std::endl;
+  std::cout << "old layout: " << old_layout.count() / BENCH_FRAMES <<
+  " ms/frame" << std::endl;
+  std::cout << "per object: " << per_object.count() / BENCH_FRAMES <<
+  " ms/frame" << std::endl;
+  std::cout << "bulk:       " << bulk.count() / BENCH_FRAMES << " ms/frame" <<
+  std::endl;
+
+  for (int i = 0; i < BENCH_OBJECTS; i++) {
+    delete legacy_props[i];
+    delete props[i];
+  }
+  exit(EXIT_SUCCESS);
+}
@@ -3,8 +3,13 @@
  */
 
 #include <GLFW/glfw3.h>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <fstream>
+#include <thread>
 
 #include "engine/project.h"
 #include "engine/model.h"
@@ -25,6 +30,7 @@
 #include "glm/vec3.hpp"
 
 #define RENDER_DISTANCE 34
+#define HEADLESS_STEPS 3600
 
 // Sets the input map for turbo_tanks
 void SetInputs(engine::Project* turbo_tanks) {
@@ -83,17 +89,30 @@ void SetInputs(engine::Project* turbo_tanks) {
 
 int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
   float w, h;
-  // Load Models
-  engine::Model* tank_md = new engine::Model("data/tank.obj");
-  engine::Model* cannon_md = new engine::Model("data/cannon.obj");
-  engine::Model* piller_md = new engine::Model("data/piller.obj");
-  engine::Model* floor_md = new engine::Model("data/floor.obj");
-  engine::Model* energyball_md = new engine::Model("data/energy_ball.obj");
-  engine::Model* battery_md = new engine::Model("data/battery.obj");
-  engine::Model* heart_md = new engine::Model("data/heart.obj");
-  engine::Model* enemy_md = new engine::Model("data/enemytank.obj");
+  // Load Models, they stay loaded as long as something is using them
+  engine::ModelHandle tank_md =
+    turbo_tanks->assets.GetModel("data/tank.obj");
+  engine::ModelHandle cannon_md =
+    turbo_tanks->assets.GetModel("data/cannon.obj");
+  engine::ModelHandle piller_md =
+    turbo_tanks->assets.GetModel("data/piller.obj");
+  engine::ModelHandle floor_md =
+    turbo_tanks->assets.GetModel("data/floor.obj");
+  engine::ModelHandle energyball_md =
+    turbo_tanks->assets.GetModel("data/energy_ball.obj");
+  engine::ModelHandle battery_md =
+    turbo_tanks->assets.GetModel("data/battery.obj");
+  engine::ModelHandle heart_md =
+    turbo_tanks->assets.GetModel("data/heart.obj");
+  engine::ModelHandle enemy_md =
+    turbo_tanks->assets.GetModel("data/enemytank.obj");
   turbotanks::Player* player = new turbotanks::Player(tank_md);
   turbo_tanks->AddRigidBody(player);
+  // Updates can't add projectile types so they are added up front
+  int player_balls = turbotanks::AddEnergyBallType(turbo_tanks,
+    "playerenergyball", energyball_md, {"player", "playercannon"});
+  int enemy_balls = turbotanks::AddEnergyBallType(turbo_tanks,
+    "enemyenergyball", energyball_md, {"enemy", "enemycannon"});
   // Load level file
   std::vector<GLubyte> level = engine::LoadPPM(filename, &w, &h);
   // Create a floor that spans entire level
@@ -102,6 +121,11 @@ int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
   floor->SetBoundingBox(glm::vec3(0, -1, 0), glm::vec3(w, 0, h));
   floor->tags.push_back("floor");
   turbo_tanks->AddRigidBody(floor);
+  // Walls never move so they live in a tile grid instead of being rigidbodies
+  engine::TileGrid* walls =
+    turbo_tanks->AddTileGrid(glm::vec3(0, 0, 0), w, h, piller_md);
+  walls->tags.push_back("rigidbody");
+  walls->tags.push_back("wall");
   // Load level
   for (int x = 0; x < w; x++) {
     for (int y = 0; y < h; y++) {
@@ -111,7 +135,7 @@ int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
       if (color == glm::vec3(0, 0, RGB_MAX)) {  // player
         // RigidBodies
         turbotanks::PlayerCannon* player_cannon =
-        new turbotanks::PlayerCannon(cannon_md, energyball_md);
+        new turbotanks::PlayerCannon(cannon_md, player_balls);
 
         // Cameras
         turbotanks::PlayerCamera* camera =
@@ -129,14 +153,16 @@ int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
         turbo_tanks->AddCamera(dev_cam);
         turbo_tanks->AddRigidBody(player_cannon);
 
+        // Attach to the player
+        camera->SetParent(player);
+        player_cannon->SetParent(player);
+        player_cannon->SetLocalPosition(glm::vec3(0, 0, 0));
+
         // Place in world
         player->SetPosition(x, 0.7, y);
         player->SetOrientation(0, glm::vec3(0, 0, -1));
       } else if (color == glm::vec3(0, 0, 0)) {  // wall
-        engine::RigidBody* wall = new engine::RigidBody(piller_md);
-        wall->SetPosition(x, 0, y);
-        wall->tags.push_back("wall");
-        turbo_tanks->AddRigidBody(wall);
+        walls->SetTile(x, y, true);
       } else if (color == glm::vec3(RGB_MAX, 0, RGB_MAX)) {
         turbotanks::EnergyPickup* b = new turbotanks::EnergyPickup(battery_md);
         b->SetPosition(x, 0, y);
@@ -149,7 +175,7 @@ int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
         turbo_tanks->AddRigidBody(h);
       } else if (color == glm::vec3(RGB_MAX, 0, 0)) {
         turbotanks::EnemyCannon* e_cannon =
-        new turbotanks::EnemyCannon(cannon_md, energyball_md);
+        new turbotanks::EnemyCannon(cannon_md, enemy_balls);
         turbotanks::Enemy* enemy = new turbotanks::Enemy(enemy_md);
         enemy->SetPosition(x, 0.7, y);
         enemy->player = player;
@@ -158,18 +184,65 @@ int LoadLevel(std::string filename, engine::Project* turbo_tanks) {
         e_cannon->enemy = enemy;
         turbo_tanks->AddRigidBody(enemy);
         turbo_tanks->AddRigidBody(e_cannon);
+        e_cannon->SetParent(enemy);
+        e_cannon->SetLocalPosition(glm::vec3(0, 0, 0));
       }
     }
   }
   return player->id;
 }
 
-int main() {
+// step is how many steps have run and input is the input snapshot
+// drives forward while sweeping the cannon from side to side, shooting the
+// machine gun in bursts and the cannon every few seconds
+void BotInput(int step, engine::InputState* input) {
+  input->keys[GLFW_KEY_W] = 1;
+  input->keys[GLFW_KEY_A] = (step / 240) % 2;
+  input->cursor_offset.x = (step / 90) % 2 ? 4 : -4;
+  input->mouse_buttons[GLFW_MOUSE_BUTTON_LEFT] = (step / 30) % 4 == 0;
+  input->mouse_buttons[GLFW_MOUSE_BUTTON_RIGHT] = step % 300 == 0;
+}
+
+// plays level 1, the arguments can be
+//   --headless [steps]  play without a window as fast as possible, a bot
+//                       plays for steps steps unless a replay is given
+//   --record file       record the input of every step to file
+//   --replay file       play the input recorded in file until it runs out
+//   --hashes file       write the world's hash after every step to file
+int main(int argc, char** argv) {
+  bool headless = false;
+  int headless_steps = HEADLESS_STEPS;
+  std::string record_file, replay_file, hash_file;
+  for (int i = 1; i < argc; i++) {
+    bool has_value = i + 1 < argc;
+    if (strcmp(argv[i], "--headless") == 0) {
+      headless = true;
+      if (has_value && isdigit(argv[i + 1][0])) {
+        headless_steps = atoi(argv[++i]);
+      }
+    } else if (strcmp(argv[i], "--record") == 0 && has_value) {
+      record_file = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+      replay_file = argv[++i];
+    } else if (strcmp(argv[i], "--hashes") == 0 && has_value) {
+      hash_file = argv[++i];
+    } else {
+      std::cout << "usage: " << argv[0] << " [--headless [steps]]" <<
+      " [--record file] [--replay file] [--hashes file]" << std::endl;
+      return 1;
+    }
+  }
+
   // Create Project
   engine::Project turbo_tanks("Turbo Tanks");
-  turbo_tanks.Initialize();
+  if (turbo_tanks.Initialize(headless) != 0) {
+    std::cout << "could not open a window" << std::endl;
+    return 1;
+  }
   turbo_tanks.render_distance = RENDER_DISTANCE;
   turbo_tanks.collision_radius = 3;
+  // updates only read each other's last step so they can run on every core
+  turbo_tanks.SetWorkerThreads(std::thread::hardware_concurrency());
 
   turbo_tanks.AddScene("menu");
   turbo_tanks.AddScene("level_1");
@@ -192,7 +265,8 @@ int main() {
   // turbo_tanks.PrintGameObjects();
 
   // UI
-  engine::UI* reticle = new engine::UI("data/reticle.pam");
+  engine::UI* reticle =
+    new engine::UI("data/reticle.pam", &turbo_tanks.assets);
   reticle->SetAttributes(1.0f/10.0f, 1, UI_FIX_WIDTH, UI_CENTER_CENTER);
   reticle->SetPosition(0.5f, 0.5f, -1.0f);
   turbo_tanks.AddUI(reticle);
@@ -204,27 +278,31 @@ int main() {
   float magic_num = (54.0f/267.0f)*width;
   float x = 1.0f - (width+(2*sep));
 
-  turbotanks::HealthUI* hp = new turbotanks::HealthUI("data/health.ppm");
+  turbotanks::HealthUI* hp =
+    new turbotanks::HealthUI("data/health.ppm", &turbo_tanks.assets);
   hp->SetAttributes(width-(magic_num), 1, UI_FIX_WIDTH,
   UI_LEFT_BOTTOM);
   hp->SetPosition((x+magic_offset)-width, sep+magic_offset_y, -2);
   hp->player = player;
   turbo_tanks.AddUI(hp);
 
-  engine::UI* hp_ui = new engine::UI("data/health_ui.pam");
+  engine::UI* hp_ui =
+    new engine::UI("data/health_ui.pam", &turbo_tanks.assets);
   hp_ui->SetAttributes(width, 1, UI_FIX_WIDTH, UI_RIGHT_BOTTOM);
   hp_ui->SetPosition(x, sep, -1);
   turbo_tanks.AddUI(hp_ui);
 
   x = 1.0f - sep;
-  turbotanks::EnergyUI* e = new turbotanks::EnergyUI("data/energy.ppm");
+  turbotanks::EnergyUI* e =
+    new turbotanks::EnergyUI("data/energy.ppm", &turbo_tanks.assets);
   e->SetAttributes(width-(magic_num), 1, UI_FIX_WIDTH,
   UI_LEFT_BOTTOM);
   e->SetPosition((x+magic_offset)-width, sep+magic_offset_y, -2);
   e->player = player;
   turbo_tanks.AddUI(e);
 
-  engine::UI* e_ui = new engine::UI("data/energy_ui.pam");
+  engine::UI* e_ui =
+    new engine::UI("data/energy_ui.pam", &turbo_tanks.assets);
   e_ui->SetAttributes(width, 1, UI_FIX_WIDTH, UI_RIGHT_BOTTOM);
   e_ui->SetPosition(x, sep, -1);
   turbo_tanks.AddUI(e_ui);
@@ -237,6 +315,37 @@ int main() {
 
   // turbo_tanks.SetCurrentScene("menu");
 
+  try {
+    if (!record_file.empty()) {
+      turbo_tanks.RecordInput(record_file);
+    }
+    if (!replay_file.empty()) {
+      turbo_tanks.ReplayInput(replay_file);
+    }
+    if (!hash_file.empty()) {
+      turbo_tanks.WriteHashes(hash_file);
+    }
+  } catch (const std::string msg) {
+    std::cout << msg << std::endl;
+    return 1;
+  }
+  if (headless && replay_file.empty()) {
+    turbo_tanks.SetInputScript(
+      [&turbo_tanks, headless_steps](int step, engine::InputState* input) {
+        BotInput(step, input);
+        if (step + 1 >= headless_steps) {
+          turbo_tanks.Quit();
+        }
+      });
+  }
+  auto start = std::chrono::steady_clock::now();
   turbo_tanks.GameLoop();
+  if (headless) {
+    std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - start;
+    std::cout << turbo_tanks.GetStepCount() << " steps in " << time.count() <<
+    " s, " << turbo_tanks.GetStepCount() / time.count() << " steps/s, player" <<
+    " health " << player->GetHealthFraction() << std::endl;
+  }
   return 0;
 }